@@ -11,8 +11,26 @@
 #include "src/defaults.h"
 #include "src/redirect.h"
 #include "src/timer.h"
+#include "src/histogram.h"
+#include "src/bench.h"
+#include "src/profiler.h"
+#include "src/results.h"
+#include "src/reporter.h"
+#include "src/console.h"
+#include "src/junit.h"
+#include "src/binlog.h"
+#include "src/history.h"
+#include "src/cache.h"
 #include "src/attributes.h"
 #include "src/scheduler.h"
+#include "src/fixture.h"
+#include "src/index.h"
+#include "src/filter.h"
+#include "src/impact.h"
+#include "src/shard.h"
+#include "src/budget.h"
+#include "src/list.h"
+#include "src/args.h"
 
 #define KRITIC_VERSION_MAJOR 1
 #define KRITIC_VERSION_MINOR 4
@@ -31,36 +49,97 @@ typedef struct {
     int asserts_failed;
     int assert_count;
     bool skipped;
+    // Result replayed from the result cache instead of running the test
+    bool cached;
+    // Timed benchmark passes repeat the body, a muted assertion only reports the first failure
+    bool asserts_muted;
     const char* skip_reason;
     uint64_t duration_ns;
     kritic_timer_t timer;
     size_t iteration;
+    kritic_bench_result_t bench;
 } kritic_test_state_t;
 
 // Globals struct
 typedef struct kritic_runtime_t {
     // Struct of printer functions
     kritic_printers_t printers;
+    // Reporters receiving events next to the printers, NULL if none are registered
+    kritic_reporters_t* reporters;
     // Number of registered tests
     uint32_t test_count;
     // Number of failed tests
     uint32_t fail_count;
     // Number of skipped tests
     uint32_t skip_count;
+    // Number of queued tests left out by the fail-fast limit or the time budget
+    uint32_t not_run_count;
+    // Number of passes replayed from the result cache
+    uint32_t cached_count;
     // Current test state
     kritic_test_state_t* test_state;
+    // Results of the tests that ran so far, kept after the run
+    kritic_results_t* results;
     // Pointer to a null-terminated array of scheduled tests
     kritic_test_t** queue;
     // Pointer to the end of the node in the tests linked list
     kritic_node_t* last_node;
     // Pointer to the first node in the tests linked list
     kritic_node_t* first_node;
+    // Registered tests by suite and name
+    kritic_index_t index;
+    // Suite setups and teardowns
+    kritic_fixtures_t fixtures;
+    // Fixture of the running test or of the suite being torn down, NULL outside of them
+    kritic_fixture_t* fixture;
+    // Resources shared by the tests that use them, across suites
+    kritic_resources_t resources;
+    // Tests selected to run
+    kritic_filter_config_t filter_config;
+    // Impact index to record or to select the tests affected by changed files with
+    kritic_impact_config_t impact_config;
+    // Recorder or loaded impact index, NULL if disabled
+    kritic_impact_t* impact;
+    // Slice of the queue this process runs
+    kritic_shard_config_t shard_config;
+    // Limits that stop the run early
+    kritic_budget_config_t budget_config;
     // Current redirection struct
     kritic_redirect_t* redirect;
+    // Redirection settings
+    kritic_redirect_config_t redirect_config;
+    // Buffered output of the printers
+    kritic_output_t* output;
+    // Console verbosity and color settings
+    kritic_console_config_t console_config;
+    // Quiet or progress console, NULL for the verbose one
+    kritic_console_t* console;
     // Global runtime timer
     kritic_timer_t timer;
     // Duration of KritiC run
     uint64_t duration_ns;
+    // Low-noise benchmark settings
+    kritic_bench_config_t bench_config;
+    // Environment the benchmarks ran in
+    kritic_bench_env_t bench_env;
+    // Sampling profiler settings
+    kritic_profiler_config_t profiler_config;
+    // JUnit XML report settings
+    kritic_junit_config_t junit_config;
+    // JUnit XML report being written, NULL if disabled
+    kritic_junit_t* junit;
+    // Binary result log settings
+    kritic_binlog_config_t binlog_config;
+    // Binary result log being written, NULL if disabled
+    kritic_binlog_t* binlog;
+    // Duration history settings
+    kritic_history_config_t history_config;
+    // Per-test durations of earlier runs, NULL if disabled
+    kritic_history_t* history;
+    // Result cache settings
+    kritic_cache_config_t cache_config;
+    // Passes of earlier runs by test fingerprint, NULL if disabled
+    kritic_cache_t* cache;
 } kritic_runtime_t;
 
 /* API */
@@ -0,0 +1,172 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../kritic.h"
+
+static void kritic_args_usage(const char* program) {
+    printf(
+        "Usage: %s [options]\n"
+        "  -f, --filter GLOB    Run tests whose suite.name matches GLOB (* and ?), a bare suite name runs the suite\n"
+        "      --regex REGEX    Run tests whose suite.name matches the extended regular expression REGEX\n"
+        "  -e, --exclude GLOB   Do not run tests matching GLOB unless a selected test depends on them\n"
+        "      --list[=FORMAT]  Print the selected tests with their attributes instead of running them,\n"
+        "                       FORMAT is plain (the default) or json\n"
+        "      --shard-index I  Run the I-th (from 0) of the --shard-count N slices of the tests, tests that\n"
+        "      --shard-count N  depend on each other stay in one slice, defaults to TEST_SHARD_INDEX and\n"
+        "                       TEST_TOTAL_SHARDS or GTEST_SHARD_INDEX and GTEST_TOTAL_SHARDS\n"
+        "      --shard-timing FILE\n"
+        "                       Balance the slices by the \"suite.name seconds\" lines in FILE\n"
+        "      --history FILE   Remember test durations in FILE and start the longest dependency chains first\n"
+        "      --cache FILE     Remember passes in FILE and replay them while the code and parameters are unchanged\n"
+        "      --impact-record FILE\n"
+        "                       Write the files and functions every test executes to FILE, the code under test\n"
+        "                       has to be built with -fsanitize-coverage=trace-pc\n"
+        "      --impact-index FILE\n"
+        "      --changed FILE   Only run the tests the impact index FILE shows to execute the files listed in FILE\n"
+        "                       (\"file\" or \"file:function\" lines, or a diff; - reads stdin) and their dependencies\n"
+        "      --fail-fast[=N]  Stop starting tests after N failed tests, 1 if N is left out and no limit if it is 0\n"
+        "      --time-budget SECONDS\n"
+        "                       Stop starting tests once SECONDS have passed since the run started\n"
+        "      --quiet          Only print failures, skips and the summary\n"
+        "      --progress       Like --quiet, with a status line that is redrawn while the tests run\n"
+        "  -h, --help           Print this message\n",
+        program
+    );
+}
+
+/* Value of an option given as "--long=value", "--long value" or "-s value", NULL if argv[*i] is another option */
+static const char* kritic_args_value(int argc, char** argv, int* i, const char* long_name, const char* short_name) {
+    const char* arg = argv[*i];
+    size_t long_length = strlen(long_name);
+
+    if (strncmp(arg, long_name, long_length) == 0 && arg[long_length] == '=') {
+        if (arg[long_length + 1] == '\0') fprintf(stderr, "[      ] Error: Option \"%s\" expects a value\n", long_name);
+        return arg + long_length + 1;
+    }
+    if (strcmp(arg, long_name) != 0 && (short_name == NULL || strcmp(arg, short_name) != 0)) return NULL;
+
+    if (*i + 1 >= argc) {
+        fprintf(stderr, "[      ] Error: Option \"%s\" expects a value\n", arg);
+        return "";
+    }
+    return argv[++*i];
+}
+
+/* Unsigned value of an option, false after reporting the error if it is not a number */
+static bool kritic_args_uint(const char* option, const char* value, uint32_t* result) {
+    char* end;
+    unsigned long parsed = strtoul(value, &end, 10);
+
+    if (value[0] == '\0' || value[0] == '-' || *end != '\0' || parsed > UINT32_MAX) {
+        if (value[0] != '\0') fprintf(stderr, "[      ] Error: Option \"%s\" expects a number, got \"%s\"\n", option, value);
+        return false;
+    }
+    *result = (uint32_t) parsed;
+    return true;
+}
+
+/* Run the tests selected on the command line, used by the default main() */
+int kritic_run_with_args(int argc, char** argv) {
+    const char* program = argc > 0 ? argv[0] : "kritic";
+    bool list = false;
+    kritic_list_format_t list_format = KRITIC_LIST_PLAIN;
+    bool shard_index_set = false, shard_count_set = false;
+    uint32_t shard_index = 0, shard_count = 0;
+    const char* impact_index = NULL;
+    const char* impact_changed = NULL;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value;
+
+        if ((value = kritic_args_value(argc, argv, &i, "--filter", "-f")) != NULL) {
+            if (value[0] == '\0') return 2;
+            kritic_filter_include(value);
+        } else if ((value = kritic_args_value(argc, argv, &i, "--regex", NULL)) != NULL) {
+            if (value[0] == '\0') return 2;
+            kritic_filter_include_regex(value);
+        } else if ((value = kritic_args_value(argc, argv, &i, "--exclude", "-e")) != NULL) {
+            if (value[0] == '\0') return 2;
+            kritic_filter_exclude(value);
+        } else if ((value = kritic_args_value(argc, argv, &i, "--shard-index", NULL)) != NULL) {
+            if (!kritic_args_uint("--shard-index", value, &shard_index)) return 2;
+            shard_index_set = true;
+        } else if ((value = kritic_args_value(argc, argv, &i, "--shard-count", NULL)) != NULL) {
+            if (!kritic_args_uint("--shard-count", value, &shard_count)) return 2;
+            if (shard_count == 0) {
+                fprintf(stderr, "[      ] Error: Option \"--shard-count\" must be at least 1\n");
+                return 2;
+            }
+            shard_count_set = true;
+        } else if ((value = kritic_args_value(argc, argv, &i, "--shard-timing", NULL)) != NULL) {
+            if (value[0] == '\0') return 2;
+            kritic_shard_set_timing_file(value);
+        } else if ((value = kritic_args_value(argc, argv, &i, "--history", NULL)) != NULL) {
+            if (value[0] == '\0') return 2;
+            kritic_history_enable(value);
+        } else if ((value = kritic_args_value(argc, argv, &i, "--cache", NULL)) != NULL) {
+            if (value[0] == '\0') return 2;
+            kritic_cache_enable(value);
+        } else if ((value = kritic_args_value(argc, argv, &i, "--impact-record", NULL)) != NULL) {
+            if (value[0] == '\0') return 2;
+            kritic_impact_record(value);
+        } else if ((value = kritic_args_value(argc, argv, &i, "--impact-index", NULL)) != NULL) {
+            if (value[0] == '\0') return 2;
+            impact_index = value;
+        } else if ((value = kritic_args_value(argc, argv, &i, "--changed", NULL)) != NULL) {
+            if (value[0] == '\0') return 2;
+            impact_changed = value;
+        } else if (strcmp(arg, "--fail-fast") == 0) {
+            kritic_set_fail_fast(1);
+        } else if ((value = kritic_args_value(argc, argv, &i, "--fail-fast", NULL)) != NULL) {
+            uint32_t failures;
+            if (!kritic_args_uint("--fail-fast", value, &failures)) return 2;
+            kritic_set_fail_fast(failures);
+        } else if ((value = kritic_args_value(argc, argv, &i, "--time-budget", NULL)) != NULL) {
+            char* end;
+            double seconds = strtod(value, &end);
+            if (value[0] == '\0') return 2;
+            if (*end != '\0' || !(seconds > 0.0) || seconds > 1e9) {
+                fprintf(stderr, "[      ] Error: Option \"--time-budget\" expects a positive number of seconds, got \"%s\"\n",
+                    value);
+                return 2;
+            }
+            kritic_set_time_budget((uint64_t) (seconds * 1e9));
+        } else if (strcmp(arg, "--list") == 0 || strcmp(arg, "--list=plain") == 0) {
+            list = true;
+        } else if (strcmp(arg, "--list=json") == 0) {
+            list = true;
+            list_format = KRITIC_LIST_JSON;
+        } else if (strcmp(arg, "--quiet") == 0) {
+            kritic_console_set_mode(KRITIC_CONSOLE_QUIET);
+        } else if (strcmp(arg, "--progress") == 0) {
+            kritic_console_set_mode(KRITIC_CONSOLE_PROGRESS);
+        } else if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            kritic_args_usage(program);
+            return 0;
+        } else {
+            fprintf(stderr, "[      ] Error: Unknown option \"%s\"\n", arg);
+            kritic_args_usage(program);
+            return 2;
+        }
+    }
+
+    if (shard_index_set != shard_count_set) {
+        fprintf(stderr, "[      ] Error: Options \"--shard-index\" and \"--shard-count\" go together\n");
+        return 2;
+    }
+    if (shard_count_set) {
+        if (shard_index >= shard_count) {
+            fprintf(stderr, "[      ] Error: Shard index %u is out of range for %u shards\n", shard_index, shard_count);
+            return 2;
+        }
+        kritic_shard_set(shard_index, shard_count);
+    }
+    /* Either half may also come from the environment */
+    if (impact_index != NULL || impact_changed != NULL) kritic_impact_select(impact_index, impact_changed);
+
+    if (list) return kritic_list_tests(kritic_get_runtime_state(), list_format);
+    return kritic_run_all();
+}
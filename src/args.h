@@ -0,0 +1,14 @@
+#ifndef KRITIC_ARGS_H
+#define KRITIC_ARGS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int kritic_run_with_args(int argc, char** argv);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // KRITIC_ARGS_H
@@ -11,7 +11,10 @@ typedef enum kritic_assert_type_t {
     KRITIC_ASSERT_NE_INT,
     KRITIC_ASSERT_NE_FLOAT,
     KRITIC_ASSERT_NE_STR,
-    KRITIC_ASSERT_FAIL
+    KRITIC_ASSERT_FAIL,
+    KRITIC_ASSERT_LATENCY,
+    /* A test's snapshot process died, actual is the signal or exit status */
+    KRITIC_ASSERT_CRASH
 } kritic_assert_type_t;
 
 #endif // KRITIC_ASSERT_TYPES_H
@@ -71,6 +71,114 @@ void kritic_parse_attr_data(kritic_test_t* test, size_t attr_count, kritic_attri
                     test->suite, test->name, test->file, test->line);
                 exit(2);
             }
+            case KRITIC_ATTR_BENCHMARK: {
+                if (test->benchmark != NULL) {
+                    fprintf(stderr, "[      ] Error: Benchmark attribute defined twice for test \"%s.%s\" in %s:%d\n",
+                        test->suite, test->name, test->file, test->line);
+                    exit(2);
+                }
+
+                test->benchmark = malloc(sizeof(kritic_attr_benchmark_t));
+                if (test->benchmark == NULL) {
+                    fprintf(stderr, "[      ] Error: malloc() failed in kritic_parse_attr_data()");
+                    exit(2);
+                }
+                *test->benchmark = attr->attribute.benchmark;
+                break;
+            }
+            case KRITIC_ATTR_LATENCY_BUDGET: {
+                const kritic_attr_latency_budget_t budget = attr->attribute.latency_budget;
+                if (budget.percentile <= 0.0 || budget.percentile > 100.0) {
+                    fprintf(stderr, "[      ] Error: Latency budget percentile %g out of range for test \"%s.%s\" in %s:%d\n",
+                        budget.percentile, test->suite, test->name, test->file, test->line);
+                    exit(2);
+                }
+
+                for (size_t j = 0; j < KRITIC_MAX_LATENCY_BUDGETS; ++j) {
+                    if (test->latency_budgets[j] == NULL) {
+                        kritic_attr_latency_budget_t* new_budget = malloc(sizeof(kritic_attr_latency_budget_t));
+                        if (new_budget == NULL) {
+                            fprintf(stderr, "[      ] Error: malloc() failed in kritic_parse_attr_data()");
+                            exit(2);
+                        }
+                        *new_budget = budget;
+
+                        test->latency_budgets[j] = new_budget;
+                        goto next_attr;
+                    }
+                }
+
+                fprintf(stderr,
+                    "[      ] Error: Too many latency budgets for test \"%s.%s\" in %s:%d\n",
+                    test->suite, test->name, test->file, test->line);
+                exit(2);
+            }
+            case KRITIC_ATTR_COLD_CACHE: {
+                if (test->cold_cache != NULL) {
+                    fprintf(stderr, "[      ] Error: Cold cache attribute defined twice for test \"%s.%s\" in %s:%d\n",
+                        test->suite, test->name, test->file, test->line);
+                    exit(2);
+                }
+
+                test->cold_cache = malloc(sizeof(kritic_attr_cold_cache_t));
+                if (test->cold_cache == NULL) {
+                    fprintf(stderr, "[      ] Error: malloc() failed in kritic_parse_attr_data()");
+                    exit(2);
+                }
+                *test->cold_cache = attr->attribute.cold_cache;
+                break;
+            }
+            case KRITIC_ATTR_VARIANT: {
+                const kritic_attr_variant_t variant = attr->attribute.variant;
+                for (size_t j = 0; j < KRITIC_MAX_VARIANTS; ++j) {
+                    if (test->variants[j] == NULL) {
+                        kritic_attr_variant_t* new_variant = malloc(sizeof(kritic_attr_variant_t));
+                        if (new_variant == NULL) {
+                            fprintf(stderr, "[      ] Error: malloc() failed in kritic_parse_attr_data()");
+                            exit(2);
+                        }
+                        *new_variant = variant;
+
+                        test->variants[j] = new_variant;
+                        goto next_attr;
+                    }
+
+                    if (strcmp(test->variants[j]->name, variant.name) == 0) {
+                        fprintf(stderr, "[      ] Error: Variant \"%s\" defined twice for test \"%s.%s\" in %s:%d\n",
+                            variant.name, test->suite, test->name, test->file, test->line);
+                        exit(2);
+                    }
+                }
+
+                fprintf(stderr,
+                    "[      ] Error: Too many variants for test \"%s.%s\" in %s:%d\n",
+                    test->suite, test->name, test->file, test->line);
+                exit(2);
+            }
+            case KRITIC_ATTR_NO_CACHE: {
+                test->no_cache = true;
+                break;
+            }
+            case KRITIC_ATTR_USES: {
+                const kritic_attr_uses_t uses = attr->attribute.uses;
+                for (size_t j = 0; j < KRITIC_MAX_RESOURCES; ++j) {
+                    if (test->uses[j] == NULL) {
+                        test->uses[j] = uses.name;
+                        goto next_attr;
+                    }
+
+                    if (strcmp(test->uses[j], uses.name) == 0) {
+                        fprintf(stderr, "[      ] Error: Resource \"%s\" used twice by test \"%s.%s\" in %s:%d\n",
+                            uses.name, test->suite, test->name, test->file, test->line);
+                        exit(2);
+                    }
+                }
+
+                fprintf(stderr,
+                    "[      ] Error: Too many resources for test \"%s.%s\" in %s:%d\n",
+                    test->suite, test->name, test->file, test->line);
+                exit(2);
+            }
             case KRITIC_ATTR_UNKNOWN:
             default:
                 fprintf(stderr, "[      ] Error: Unknown attribute type detected\n");
@@ -81,6 +189,23 @@ void kritic_parse_attr_data(kritic_test_t* test, size_t attr_count, kritic_attri
         next_attr:
             continue;
     }
+
+    /* Attributes may come in any order, so this can only be checked at the end */
+    if (test->latency_budgets[0] != NULL && test->benchmark == NULL) {
+        fprintf(stderr, "[      ] Error: Latency budget defined for test \"%s.%s\" in %s:%d which is not a benchmark\n",
+            test->suite, test->name, test->file, test->line);
+        exit(2);
+    }
+    if (test->variants[0] != NULL && test->benchmark == NULL) {
+        fprintf(stderr, "[      ] Error: Variant defined for test \"%s.%s\" in %s:%d which is not a benchmark\n",
+            test->suite, test->name, test->file, test->line);
+        exit(2);
+    }
+    if (test->cold_cache != NULL && test->benchmark == NULL) {
+        fprintf(stderr, "[      ] Error: Cold cache attribute defined for test \"%s.%s\" in %s:%d which is not a benchmark\n",
+            test->suite, test->name, test->file, test->line);
+        exit(2);
+    }
 }
 
 void* kritic_get_param_value(const char* varname) {
@@ -113,6 +238,16 @@ void* kritic_get_param_value(const char* varname) {
 }
 
 void kritic_free_attributes(struct kritic_test_t* test) {
+    free(test->benchmark);
+    free(test->cold_cache);
+    for (size_t i = 0; i < KRITIC_MAX_VARIANTS; i++) {
+        if (test->variants[i] == NULL) break;
+        free(test->variants[i]);
+    }
+    for (size_t i = 0; i < KRITIC_MAX_LATENCY_BUDGETS; i++) {
+        if (test->latency_budgets[i] == NULL) break;
+        free(test->latency_budgets[i]);
+    }
     for (size_t i = 0; i < KRITIC_MAX_DEPENDENCIES; i++){
         if (test->dependencies[i] == NULL) break;
         free(test->dependencies[i]); 
@@ -11,13 +11,27 @@ struct kritic_test_index_t;
 typedef enum {
     KRITIC_ATTR_UNKNOWN = 0,
     KRITIC_ATTR_DEPENDS_ON,
-    KRITIC_ATTR_PARAMETERIZED
+    KRITIC_ATTR_PARAMETERIZED,
+    KRITIC_ATTR_BENCHMARK,
+    KRITIC_ATTR_LATENCY_BUDGET,
+    KRITIC_ATTR_COLD_CACHE,
+    KRITIC_ATTR_VARIANT,
+    KRITIC_ATTR_NO_CACHE,
+    KRITIC_ATTR_USES
 } kritic_attr_type_t;
 
 typedef enum {
     KRITIC_SIMPLE_PARAMETERIZED,
 } kritic_parameterized_type_t;
 
+/* How caches are evicted before each cold-cache benchmark operation */
+typedef enum {
+    /* clflush the declared working set if possible, sweep a buffer otherwise */
+    KRITIC_EVICT_AUTO = 0,
+    KRITIC_EVICT_SWEEP,
+    KRITIC_EVICT_FLUSH
+} kritic_cache_eviction_t;
+
 typedef struct {
     const char* suite;
     const char* test;
@@ -32,9 +46,36 @@ typedef struct {
     bool is_static_array;
 } kritic_attr_parameterized_t;
 
+typedef struct {
+    size_t samples;
+} kritic_attr_benchmark_t;
+
+typedef struct {
+    double percentile;
+    uint64_t max_ns;
+} kritic_attr_latency_budget_t;
+
+typedef struct {
+    kritic_cache_eviction_t eviction;
+} kritic_attr_cold_cache_t;
+
+typedef struct {
+    const char* name;
+    void (*fn)(void);
+} kritic_attr_variant_t;
+
+typedef struct {
+    const char* name;
+} kritic_attr_uses_t;
+
 typedef union {
     kritic_attr_depends_on_t depends_on;
     kritic_attr_parameterized_t parameterized;
+    kritic_attr_benchmark_t benchmark;
+    kritic_attr_latency_budget_t latency_budget;
+    kritic_attr_cold_cache_t cold_cache;
+    kritic_attr_variant_t variant;
+    kritic_attr_uses_t uses;
 } kritic_attr_union;
 
 typedef struct kritic_attribute_t {
@@ -65,6 +106,46 @@ void* kritic_get_param_value(const char* varname);
         }                                                                                                     \
     }                                                                                                         \
 
+#define KRITIC_BENCHMARK(_samples)                                                                            \
+    &(kritic_attribute_t){                                                                                    \
+        .type = KRITIC_ATTR_BENCHMARK,                                                                        \
+        .attribute.benchmark = { .samples = _samples }                                                        \
+    }
+
+/* Fails a benchmark if the given percentile (e.g. 99.9) of its operation latencies exceeds max_ns */
+#define KRITIC_LATENCY_BUDGET(_percentile, _max_ns)                                                           \
+    &(kritic_attribute_t){                                                                                    \
+        .type = KRITIC_ATTR_LATENCY_BUDGET,                                                                   \
+        .attribute.latency_budget = { .percentile = _percentile, .max_ns = _max_ns }                          \
+    }
+
+/* Also measures a benchmark with caches evicted before every operation */
+#define KRITIC_COLD_CACHE(_eviction)                                                                          \
+    &(kritic_attribute_t){                                                                                    \
+        .type = KRITIC_ATTR_COLD_CACHE,                                                                       \
+        .attribute.cold_cache = { .eviction = _eviction }                                                     \
+    }
+
+/* Competing implementation of a benchmark, measured interleaved with the test body as the baseline */
+#define KRITIC_VARIANT(_name, _fn)                                                                            \
+    &(kritic_attribute_t){                                                                                    \
+        .type = KRITIC_ATTR_VARIANT,                                                                          \
+        .attribute.variant = { .name = #_name, .fn = _fn }                                                    \
+    }
+
+/* Always runs the test, even if the result cache holds a pass for the same code */
+#define KRITIC_NO_CACHE()                                                                                     \
+    &(kritic_attribute_t){                                                                                    \
+        .type = KRITIC_ATTR_NO_CACHE                                                                          \
+    }
+
+/* Needs the KRITIC_RESOURCE() of that name, set up before the first test using it and torn down after the last */
+#define KRITIC_USES(_name)                                                                                    \
+    &(kritic_attribute_t){                                                                                    \
+        .type = KRITIC_ATTR_USES,                                                                             \
+        .attribute.uses = { .name = #_name }                                                                  \
+    }
+
 #define KRITIC_GET_PARAMETER(_type, _varname)                                                                 \
     (*(_type *) kritic_get_param_value(#_varname))
 
@@ -0,0 +1,712 @@
+/* sched_setaffinity() and CPU_SET() are GNU extensions */
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../kritic.h"
+
+#ifdef _WIN32
+#include <direct.h>
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)) || defined(__aarch64__)
+#define KRITIC_BENCH_HAS_FLUSH
+#endif
+
+#ifndef KRITIC_DISABLE_TIMER
+/* Per-operation latencies of the running benchmark */
+static kritic_histogram_t kritic_bench_histogram;
+static kritic_histogram_t kritic_bench_cold_histogram;
+#endif
+
+typedef struct {
+    const unsigned char* data;
+    size_t size;
+} kritic_bench_region_t;
+
+/* Working set declared by the running benchmark */
+static kritic_bench_region_t kritic_bench_regions[KRITIC_BENCH_MAX_WORKING_SET];
+static size_t kritic_bench_region_count;
+static bool kritic_bench_regions_overflow;
+
+/* Randomizes the order of interleaved benchmark variants */
+static uint64_t kritic_bench_rng = 0x9E3779B97F4A7C15ULL;
+
+/* Buffer swept to push everything else out of the caches, allocated on first use */
+static volatile unsigned char* kritic_bench_sweep_buffer;
+static size_t kritic_bench_sweep_size;
+
+/* Set up a low-noise environment before the first benchmark */
+void kritic_bench_set_low_noise(int cpu, bool raise_priority) {
+    kritic_runtime_t* runtime = kritic_get_runtime_state();
+    runtime->bench_config.low_noise      = true;
+    runtime->bench_config.cpu            = cpu;
+    runtime->bench_config.raise_priority = raise_priority;
+}
+
+/* Export latency histograms of every benchmark for plotting */
+void kritic_bench_set_histogram_dir(const char* directory) {
+    kritic_runtime_t* runtime = kritic_get_runtime_state();
+    runtime->bench_config.histogram_dir = directory;
+}
+
+/* Declare memory touched by the current operation, duplicates are ignored */
+void kritic_bench_working_set(const void* data, size_t size) {
+    if (data == NULL || size == 0) return;
+
+    for (size_t i = 0; i < kritic_bench_region_count; ++i) {
+        if (kritic_bench_regions[i].data == data && kritic_bench_regions[i].size == size) return;
+    }
+
+    if (kritic_bench_region_count == KRITIC_BENCH_MAX_WORKING_SET) {
+        kritic_bench_regions_overflow = true;
+        return;
+    }
+    kritic_bench_regions[kritic_bench_region_count++] = (kritic_bench_region_t) { data, size };
+}
+
+#if defined(__linux__)
+
+static cpu_set_t kritic_bench_saved_affinity;
+static int kritic_bench_saved_priority;
+
+/* Read the first line of a sysfs file, returns false if it does not exist */
+static bool kritic_bench_read_file(const char* path, char* value, size_t size) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) return false;
+
+    bool ok = fgets(value, (int) size, file) != NULL;
+    fclose(file);
+    if (!ok) return false;
+
+    value[strcspn(value, "\n")] = '\0';
+    return true;
+}
+
+static kritic_bench_state_t kritic_bench_read_governor(void) {
+    kritic_bench_state_t result = KRITIC_BENCH_STATE_UNKNOWN;
+    long cpus = sysconf(_SC_NPROCESSORS_CONF);
+    char path[128];
+    char value[32];
+
+    for (long cpu = 0; cpu < cpus; ++cpu) {
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%ld/cpufreq/scaling_governor", cpu);
+        if (!kritic_bench_read_file(path, value, sizeof(value))) continue;
+        if (strcmp(value, "performance") != 0) return KRITIC_BENCH_STATE_OFF;
+        result = KRITIC_BENCH_STATE_ON;
+    }
+
+    return result;
+}
+
+static kritic_bench_state_t kritic_bench_read_turbo(void) {
+    char value[32];
+
+    /* intel_pstate exposes the inverse knob */
+    if (kritic_bench_read_file("/sys/devices/system/cpu/intel_pstate/no_turbo", value, sizeof(value))) {
+        return strcmp(value, "1") == 0 ? KRITIC_BENCH_STATE_OFF : KRITIC_BENCH_STATE_ON;
+    }
+    if (kritic_bench_read_file("/sys/devices/system/cpu/cpufreq/boost", value, sizeof(value))) {
+        return strcmp(value, "1") == 0 ? KRITIC_BENCH_STATE_ON : KRITIC_BENCH_STATE_OFF;
+    }
+
+    return KRITIC_BENCH_STATE_UNKNOWN;
+}
+
+#ifndef KRITIC_DISABLE_TIMER
+/* Largest cache reported for cpu0, 0 if unknown, only the cold cache sweep needs it */
+static size_t kritic_bench_read_llc_size(void) {
+    size_t largest = 0;
+    char path[128];
+    char value[32];
+
+    for (int index = 0; index < 8; ++index) {
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/size", index);
+        if (!kritic_bench_read_file(path, value, sizeof(value))) break;
+
+        char* suffix;
+        size_t size = (size_t) strtoull(value, &suffix, 10);
+        if (*suffix == 'K') size <<= 10;
+        if (*suffix == 'M') size <<= 20;
+        if (size > largest) largest = size;
+    }
+
+    return largest;
+}
+#endif // !KRITIC_DISABLE_TIMER
+
+static bool kritic_bench_pin(int cpu) {
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(cpu_set_t), &kritic_bench_saved_affinity) != 0) return false;
+
+    CPU_ZERO(&set);
+    CPU_SET((size_t) cpu, &set);
+    return sched_setaffinity(0, sizeof(cpu_set_t), &set) == 0;
+}
+
+static bool kritic_bench_raise_priority(void) {
+    kritic_bench_saved_priority = getpriority(PRIO_PROCESS, 0);
+    return setpriority(PRIO_PROCESS, 0, -20) == 0;
+}
+
+static void kritic_bench_restore(const kritic_bench_env_t* env) {
+    if (env->pinned_cpu >= 0) sched_setaffinity(0, sizeof(cpu_set_t), &kritic_bench_saved_affinity);
+    if (env->priority_raised) setpriority(PRIO_PROCESS, 0, kritic_bench_saved_priority);
+}
+
+#elif defined(_WIN32)
+
+static DWORD_PTR kritic_bench_saved_affinity;
+static DWORD kritic_bench_saved_priority;
+
+static kritic_bench_state_t kritic_bench_read_governor(void) { return KRITIC_BENCH_STATE_UNKNOWN; }
+static kritic_bench_state_t kritic_bench_read_turbo(void) { return KRITIC_BENCH_STATE_UNKNOWN; }
+#ifndef KRITIC_DISABLE_TIMER
+static size_t kritic_bench_read_llc_size(void) { return 0; }
+#endif
+
+static bool kritic_bench_pin(int cpu) {
+    kritic_bench_saved_affinity = SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR) 1 << cpu);
+    return kritic_bench_saved_affinity != 0;
+}
+
+static bool kritic_bench_raise_priority(void) {
+    kritic_bench_saved_priority = GetPriorityClass(GetCurrentProcess());
+    return SetPriorityClass(GetCurrentProcess(), HIGH_PRIORITY_CLASS) != 0;
+}
+
+static void kritic_bench_restore(const kritic_bench_env_t* env) {
+    if (env->pinned_cpu >= 0) SetThreadAffinityMask(GetCurrentThread(), kritic_bench_saved_affinity);
+    if (env->priority_raised) SetPriorityClass(GetCurrentProcess(), kritic_bench_saved_priority);
+}
+
+#else // Unsupported platform
+
+static kritic_bench_state_t kritic_bench_read_governor(void) { return KRITIC_BENCH_STATE_UNKNOWN; }
+static kritic_bench_state_t kritic_bench_read_turbo(void) { return KRITIC_BENCH_STATE_UNKNOWN; }
+#ifndef KRITIC_DISABLE_TIMER
+static size_t kritic_bench_read_llc_size(void) { return 0; }
+#endif
+static bool kritic_bench_pin(int cpu) { (void) cpu; return false; }
+static bool kritic_bench_raise_priority(void) { return false; }
+static void kritic_bench_restore(const kritic_bench_env_t* env) { (void) env; }
+
+#endif // Unsupported platform
+
+/* Apply the low-noise configuration and record the environment, once per run */
+static void kritic_bench_prepare(kritic_runtime_t* runtime) {
+    kritic_bench_env_t* env = &runtime->bench_env;
+    kritic_bench_config_t* config = &runtime->bench_config;
+    if (env->prepared) return;
+
+    *env = (kritic_bench_env_t) {
+        .prepared             = true,
+        .low_noise            = false,
+        .pinned_cpu           = -1,
+        .priority_raised      = false,
+        .performance_governor = KRITIC_BENCH_STATE_UNKNOWN,
+        .turbo                = KRITIC_BENCH_STATE_UNKNOWN
+    };
+
+    /* A fixed seed reproduces the variant order of a previous run */
+    const char* seed_env = getenv("KRITIC_BENCH_SEED");
+    uint64_t seed = seed_env != NULL && *seed_env != '\0'
+        ? (uint64_t) strtoull(seed_env, NULL, 10)
+        : (uint64_t) time(NULL) ^ (uint64_t) (uintptr_t) &seed;
+    kritic_bench_rng ^= seed;
+    if (kritic_bench_rng == 0) kritic_bench_rng = 1;
+
+    /* Allow enabling these without a custom main() */
+    const char* histogram_env = getenv("KRITIC_BENCH_HISTOGRAM_DIR");
+    if (config->histogram_dir == NULL && histogram_env != NULL && *histogram_env != '\0') {
+        config->histogram_dir = histogram_env;
+    }
+    if (config->histogram_dir != NULL) {
+#ifdef _WIN32
+        _mkdir(config->histogram_dir);
+#else
+        mkdir(config->histogram_dir, 0755);
+#endif
+    }
+
+    const char* cpu_env = getenv("KRITIC_BENCH_CPU");
+    if (!config->low_noise && cpu_env != NULL && *cpu_env != '\0') {
+        const char* priority_env = getenv("KRITIC_BENCH_PRIORITY");
+        config->low_noise = true;
+        config->cpu = atoi(cpu_env);
+        config->raise_priority = priority_env != NULL && strcmp(priority_env, "1") == 0;
+    }
+
+    if (!config->low_noise) return;
+    env->low_noise = true;
+
+    if (config->cpu >= 0) {
+        if (kritic_bench_pin(config->cpu)) {
+            env->pinned_cpu = config->cpu;
+        } else {
+            kritic_error_printerf("[      ] Warning: Could not pin benchmarks to cpu %d\n", config->cpu);
+        }
+    }
+
+    if (config->raise_priority) {
+        env->priority_raised = kritic_bench_raise_priority();
+        if (!env->priority_raised) {
+            kritic_error_printer("[      ] Warning: Could not raise benchmark priority (missing privileges?)\n");
+        }
+    }
+
+    env->performance_governor = kritic_bench_read_governor();
+    env->turbo = kritic_bench_read_turbo();
+
+    if (env->performance_governor == KRITIC_BENCH_STATE_OFF) {
+        kritic_error_printer("[      ] Warning: CPU frequency governor is not \"performance\", timings may be noisy\n");
+    }
+    if (env->turbo == KRITIC_BENCH_STATE_ON) {
+        kritic_error_printer("[      ] Warning: CPU turbo boost is enabled, timings may be noisy\n");
+    }
+}
+
+void kritic_bench_teardown(kritic_runtime_t* runtime) {
+    free((void*) kritic_bench_sweep_buffer);
+    kritic_bench_sweep_buffer = NULL;
+    kritic_bench_sweep_size = 0;
+
+    if (!runtime->bench_env.prepared) return;
+    kritic_bench_restore(&runtime->bench_env);
+    runtime->bench_env.prepared = false;
+}
+
+/* Time a single sample of fn, which covers all parameterized iterations */
+static uint64_t kritic_bench_sample(kritic_runtime_t* runtime, kritic_test_fn fn, size_t iterations) {
+    kritic_test_state_t* state = runtime->test_state;
+    kritic_timer_t timer;
+
+    kritic_timer_start(&timer);
+    for (size_t i = 0; i < iterations; ++i) {
+        state->iteration = i;
+        fn();
+    }
+    return kritic_timer_elapsed(&timer);
+}
+
+/* A skip or a failed assertion ends the benchmark, there is nothing left worth timing */
+static bool kritic_bench_stopped(const kritic_test_state_t* state) {
+    return state->skipped || state->asserts_failed > 0;
+}
+
+static kritic_test_fn kritic_bench_contender(const kritic_test_t* test, size_t index) {
+    return index == 0 ? test->fn : test->variants[index - 1]->fn;
+}
+
+#ifndef KRITIC_DISABLE_TIMER
+
+static int kritic_bench_compare(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*) a;
+    uint64_t y = *(const uint64_t*) b;
+    return (x > y) - (x < y);
+}
+
+/* Sorts the samples in place */
+static uint64_t kritic_bench_median(uint64_t* samples, size_t count) {
+    qsort(samples, count, sizeof(uint64_t), kritic_bench_compare);
+    if (count % 2 == 1) return samples[count / 2];
+    return samples[count / 2 - 1] + (samples[count / 2] - samples[count / 2 - 1]) / 2;
+}
+
+static uint64_t kritic_bench_distance(uint64_t a, uint64_t b) {
+    return a > b ? a - b : b - a;
+}
+
+/* Run warmup windows until the window medians stop drifting */
+static size_t kritic_bench_warmup(kritic_runtime_t* runtime, kritic_test_fn fn, size_t iterations) {
+    uint64_t window[KRITIC_BENCH_WARMUP_WINDOW];
+    uint64_t previous = 0;
+    size_t runs = 0;
+
+    for (size_t w = 0; w < KRITIC_BENCH_WARMUP_MAX_WINDOWS; ++w) {
+        for (size_t i = 0; i < KRITIC_BENCH_WARMUP_WINDOW; ++i) {
+            window[i] = kritic_bench_sample(runtime, fn, iterations);
+            ++runs;
+            if (kritic_bench_stopped(runtime->test_state)) return runs;
+        }
+
+        uint64_t median = kritic_bench_median(window, KRITIC_BENCH_WARMUP_WINDOW);
+        if (w > 0 && kritic_bench_distance(median, previous) * 1000 <= KRITIC_BENCH_STABLE_PERMILLE * previous) break;
+        previous = median;
+    }
+
+    return runs;
+}
+
+/* xorshift64*, good enough to randomize the contender order */
+static uint64_t kritic_bench_random(void) {
+    kritic_bench_rng ^= kritic_bench_rng >> 12;
+    kritic_bench_rng ^= kritic_bench_rng << 25;
+    kritic_bench_rng ^= kritic_bench_rng >> 27;
+    return kritic_bench_rng * 0x2545F4914F6CDD1DULL;
+}
+
+/* Fisher-Yates shuffle of 0..count-1 */
+static void kritic_bench_shuffle(size_t* order, size_t count) {
+    for (size_t i = 0; i < count; ++i) order[i] = i;
+    for (size_t i = count; i > 1; --i) {
+        size_t j = (size_t) (kritic_bench_random() % i);
+        size_t tmp = order[i - 1];
+        order[i - 1] = order[j];
+        order[j] = tmp;
+    }
+}
+
+static int kritic_bench_compare_ratio(const void* a, const void* b) {
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+    return (x > y) - (x < y);
+}
+
+/* Median of the paired per-round speedups with a distribution-free confidence interval from order statistics */
+static void kritic_bench_compare_variant(kritic_bench_variant_result_t* result, const uint64_t* baseline,
+                                         const uint64_t* variant, size_t count) {
+    double* ratios = malloc(count * sizeof(double));
+    if (ratios == NULL) {
+        fprintf(stderr, "[      ] Error: malloc() failed in kritic_bench_compare_variant()\n");
+        exit(1);
+    }
+
+    for (size_t r = 0; r < count; ++r) {
+        uint64_t base_ns = baseline[r] > 0 ? baseline[r] : 1;
+        uint64_t variant_ns = variant[r] > 0 ? variant[r] : 1;
+        ratios[r] = (double) base_ns / (double) variant_ns;
+    }
+    qsort(ratios, count, sizeof(double), kritic_bench_compare_ratio);
+
+    result->speedup = count % 2 == 1 ? ratios[count / 2] : (ratios[count / 2 - 1] + ratios[count / 2]) / 2.0;
+
+    /* Largest rank j with n - 2j >= z * sqrt(n), the interval is [ratio_j, ratio_(n-j+1)] */
+    uint64_t n = (uint64_t) count;
+    size_t j = count / 2;
+    while (j > 1 && (n - 2 * j) * (n - 2 * j) * 10000
+                    < (uint64_t) KRITIC_BENCH_CONFIDENCE_Z100 * KRITIC_BENCH_CONFIDENCE_Z100 * n) {
+        --j;
+    }
+    if (j == 0) j = 1;
+
+    result->ci_low      = ratios[j - 1];
+    result->ci_high     = ratios[count - j];
+    result->significant = result->ci_low > 1.0 || result->ci_high < 1.0;
+    free(ratios);
+}
+
+/* Reject samples outside of the MAD band and summarize the rest */
+static void kritic_bench_summarize(kritic_bench_result_t* result, uint64_t* samples, size_t count) {
+    uint64_t* deviations = malloc(count * sizeof(uint64_t));
+    if (deviations == NULL) {
+        fprintf(stderr, "[      ] Error: malloc() failed in kritic_bench_summarize()\n");
+        exit(1);
+    }
+
+    uint64_t median = kritic_bench_median(samples, count);
+    for (size_t i = 0; i < count; ++i) {
+        deviations[i] = kritic_bench_distance(samples[i], median);
+    }
+    uint64_t mad = kritic_bench_median(deviations, count);
+    free(deviations);
+
+    /* 1.4826 scales the MAD to the standard deviation of normally distributed data */
+    uint64_t limit = (KRITIC_BENCH_MAD_THRESHOLD * 14826 * (mad > 0 ? mad : 1)) / 10000;
+
+    /* Samples are sorted, so the kept ones form a contiguous range */
+    size_t first = 0, last = count;
+    while (first < count && samples[first] < median && median - samples[first] > limit) ++first;
+    while (last > first && samples[last - 1] > median && samples[last - 1] - median > limit) --last;
+
+    uint64_t total = 0;
+    for (size_t i = first; i < last; ++i) total += samples[i];
+
+    result->samples   = count;
+    result->kept      = last - first;
+    result->outliers  = count - result->kept;
+    result->min_ns    = samples[first];
+    result->max_ns    = samples[last - 1];
+    result->mean_ns   = total / result->kept;
+    result->median_ns = median;
+    result->mad_ns    = mad;
+}
+
+/* Export a histogram of the current benchmark if a histogram directory is set */
+static void kritic_bench_export(kritic_runtime_t* runtime, const kritic_histogram_t* histogram, const char* suffix) {
+    const kritic_test_t* test = runtime->test_state->test;
+    const char* directory = runtime->bench_config.histogram_dir;
+    if (directory == NULL) return;
+
+    char path[4096];
+    kritic_snprintf(path, sizeof(path), "%s/%s.%s%s.hgrm", directory, test->suite, test->name, suffix);
+    if (!kritic_histogram_export(histogram, path)) {
+        kritic_error_printerf("[      ] Warning: Could not write latency histogram to %s\n", path);
+    }
+}
+
+/* Summarize the latency histogram, check the latency budgets and export it */
+static void kritic_bench_report_latency(kritic_runtime_t* runtime, const kritic_histogram_t* histogram) {
+    kritic_test_state_t* state = runtime->test_state;
+    kritic_bench_result_t* result = &state->bench;
+    const kritic_test_t* test = state->test;
+
+    result->operations = histogram->total;
+    result->p50_ns     = kritic_histogram_percentile(histogram, 50.0);
+    result->p90_ns     = kritic_histogram_percentile(histogram, 90.0);
+    result->p99_ns     = kritic_histogram_percentile(histogram, 99.0);
+    result->p999_ns    = kritic_histogram_percentile(histogram, 99.9);
+    result->p100_ns    = histogram->max_ns;
+    result->histogram  = histogram;
+
+    kritic_context_t ctx = { test->file, test->suite, test->name, test->line };
+    for (size_t i = 0; i < KRITIC_MAX_LATENCY_BUDGETS && test->latency_budgets[i] != NULL; ++i) {
+        const kritic_attr_latency_budget_t* budget = test->latency_budgets[i];
+        char label[32];
+        kritic_snprintf(label, sizeof(label), "p%g", budget->percentile);
+
+        uint64_t actual = kritic_histogram_percentile(histogram, budget->percentile);
+        kritic_assert_eq(&ctx, (long long) actual, (long long) budget->max_ns, label, NULL, KRITIC_ASSERT_LATENCY);
+    }
+
+    kritic_bench_export(runtime, histogram, "");
+}
+
+#ifdef KRITIC_BENCH_HAS_FLUSH
+/* Write back and invalidate every cache line of the declared working set */
+static void kritic_bench_flush_working_set(void) {
+    for (size_t i = 0; i < kritic_bench_region_count; ++i) {
+        const kritic_bench_region_t* region = &kritic_bench_regions[i];
+        uintptr_t line = (uintptr_t) region->data & ~((uintptr_t) KRITIC_BENCH_CACHE_LINE - 1);
+        uintptr_t end = (uintptr_t) region->data + region->size;
+
+        for (; line < end; line += KRITIC_BENCH_CACHE_LINE) {
+#if defined(__aarch64__)
+            __asm__ volatile("dc civac, %0" : : "r"(line) : "memory");
+#else
+            __builtin_ia32_clflush((const void*) line);
+#endif
+        }
+    }
+
+#if defined(__aarch64__)
+    __asm__ volatile("dsb ish" : : : "memory");
+#else
+    __builtin_ia32_mfence();
+#endif
+}
+#endif // KRITIC_BENCH_HAS_FLUSH
+
+/* Touch a buffer larger than the last level cache so nothing else stays cached */
+static void kritic_bench_sweep(void) {
+    if (kritic_bench_sweep_buffer == NULL) {
+        size_t llc_size = kritic_bench_read_llc_size();
+        if (llc_size == 0) llc_size = KRITIC_BENCH_DEFAULT_LLC_SIZE;
+
+        kritic_bench_sweep_size = llc_size * KRITIC_BENCH_SWEEP_FACTOR;
+        unsigned char* buffer = malloc(kritic_bench_sweep_size);
+        if (buffer == NULL) {
+            fprintf(stderr, "[      ] Error: malloc() failed in kritic_bench_sweep()\n");
+            exit(1);
+        }
+
+        /* Fault the pages in up front */
+        memset(buffer, 0, kritic_bench_sweep_size);
+        kritic_bench_sweep_buffer = buffer;
+    }
+
+    /* Writing every line also forces dirty lines of the working set out */
+    for (size_t i = 0; i < kritic_bench_sweep_size; i += KRITIC_BENCH_CACHE_LINE) {
+        ++kritic_bench_sweep_buffer[i];
+    }
+}
+
+/* Evict the caches before an operation, returns the method that was used */
+static kritic_cache_eviction_t kritic_bench_evict(kritic_cache_eviction_t eviction) {
+#ifdef KRITIC_BENCH_HAS_FLUSH
+    if (eviction != KRITIC_EVICT_SWEEP && kritic_bench_region_count > 0 && !kritic_bench_regions_overflow) {
+        kritic_bench_flush_working_set();
+        return KRITIC_EVICT_FLUSH;
+    }
+#endif
+    (void) eviction;
+
+    kritic_bench_sweep();
+    return KRITIC_EVICT_SWEEP;
+}
+
+/* Time every operation again with the caches evicted right before it, outside of the timed region */
+static void kritic_bench_run_cold(kritic_runtime_t* runtime, size_t iterations, size_t count) {
+    kritic_test_state_t* state = runtime->test_state;
+    kritic_bench_result_t* result = &state->bench;
+    kritic_cache_eviction_t requested = state->test->cold_cache->eviction;
+    kritic_cache_eviction_t used = KRITIC_EVICT_FLUSH;
+    kritic_timer_t timer;
+
+    kritic_histogram_reset(&kritic_bench_cold_histogram);
+    for (size_t s = 0; s < count; ++s) {
+        for (size_t i = 0; i < iterations; ++i) {
+            state->iteration = i;
+            if (kritic_bench_evict(requested) == KRITIC_EVICT_SWEEP) used = KRITIC_EVICT_SWEEP;
+
+            kritic_timer_start(&timer);
+            state->test->fn();
+            kritic_histogram_record(&kritic_bench_cold_histogram, kritic_timer_elapsed(&timer));
+            if (kritic_bench_stopped(state)) return;
+        }
+    }
+
+    if (requested == KRITIC_EVICT_FLUSH && used == KRITIC_EVICT_SWEEP) {
+        kritic_error_printerf("[      ] Warning: Could not flush the working set of \"%s.%s\", swept the caches instead\n",
+            state->test->suite, state->test->name);
+    }
+
+    size_t working_set_bytes = 0;
+    for (size_t i = 0; i < kritic_bench_region_count; ++i) {
+        working_set_bytes += kritic_bench_regions[i].size;
+    }
+
+    const kritic_histogram_t* histogram = &kritic_bench_cold_histogram;
+    result->cold_operations   = histogram->total;
+    result->cold_eviction     = used;
+    result->working_set_bytes = working_set_bytes;
+    result->cold_p50_ns       = kritic_histogram_percentile(histogram, 50.0);
+    result->cold_p90_ns       = kritic_histogram_percentile(histogram, 90.0);
+    result->cold_p99_ns       = kritic_histogram_percentile(histogram, 99.0);
+    result->cold_p100_ns      = histogram->max_ns;
+    result->cold_histogram    = histogram;
+
+    kritic_bench_export(runtime, histogram, ".cold");
+}
+
+/* Time every call of the baseline for the latency histogram, false if the test skipped or failed */
+static bool kritic_bench_sample_latency(kritic_runtime_t* runtime, size_t iterations, size_t count) {
+    kritic_test_state_t* state = runtime->test_state;
+    kritic_timer_t timer;
+
+    for (size_t s = 0; s < count; ++s) {
+        for (size_t i = 0; i < iterations; ++i) {
+            state->iteration = i;
+            kritic_timer_start(&timer);
+            state->test->fn();
+            kritic_histogram_record(&kritic_bench_histogram, kritic_timer_elapsed(&timer));
+            if (kritic_bench_stopped(state)) return false;
+        }
+    }
+    return true;
+}
+
+#endif // !KRITIC_DISABLE_TIMER
+
+/* Warm up, sample and filter outliers, the assertions of the bodies are muted by the caller */
+static void kritic_bench_measure(kritic_runtime_t* runtime, size_t iterations, size_t contenders) {
+    kritic_test_state_t* state = runtime->test_state;
+    const kritic_test_t* test = state->test;
+    size_t count = test->benchmark->samples;
+
+#ifdef KRITIC_DISABLE_TIMER
+    (void) contenders;
+
+    /* Nothing to measure, run it like a regular test */
+    for (size_t i = 0; i < count && !kritic_bench_stopped(state); ++i) {
+        kritic_bench_sample(runtime, test->fn, iterations);
+    }
+#else // !KRITIC_DISABLE_TIMER
+    size_t variant_count = contenders - 1;
+
+    size_t warmup_runs = 0;
+    for (size_t v = 0; v < contenders; ++v) {
+        warmup_runs += kritic_bench_warmup(runtime, kritic_bench_contender(test, v), iterations);
+        if (kritic_bench_stopped(state)) return;
+    }
+
+    /* Sample of contender v in round r is at samples[v * count + r] */
+    uint64_t* samples = malloc(contenders * count * sizeof(uint64_t));
+    if (samples == NULL) {
+        fprintf(stderr, "[      ] Error: malloc() failed in kritic_bench_run()\n");
+        exit(1);
+    }
+    kritic_histogram_reset(&kritic_bench_histogram);
+
+    /* Interleave the contenders in a new random order every round so drift hits all of them alike */
+    size_t order[KRITIC_MAX_VARIANTS + 1];
+    for (size_t r = 0; r < count; ++r) {
+        kritic_bench_shuffle(order, contenders);
+        for (size_t k = 0; k < contenders; ++k) {
+            size_t v = order[k];
+            samples[v * count + r] = kritic_bench_sample(runtime, kritic_bench_contender(test, v), iterations);
+            if (kritic_bench_stopped(state)) {
+                free(samples);
+                return;
+            }
+            /* A sample of a single call is an operation of the latency histogram as it is */
+            if (v == 0 && iterations == 1) kritic_histogram_record(&kritic_bench_histogram, samples[r]);
+        }
+    }
+
+    /* Every contender was timed over whole samples, so per-call latencies of the baseline come from a pass of their own */
+    if (iterations > 1 && !kritic_bench_sample_latency(runtime, iterations, count)) {
+        free(samples);
+        return;
+    }
+
+    /* Compare before summarizing, which sorts the baseline samples and breaks the round pairing */
+    for (size_t v = 1; v < contenders; ++v) {
+        kritic_bench_variant_result_t* variant = &state->bench.variants[v - 1];
+        kritic_bench_compare_variant(variant, samples, samples + v * count, count);
+        variant->name = test->variants[v - 1]->name;
+        variant->median_ns = kritic_bench_median(samples + v * count, count);
+    }
+    state->bench.variant_count = variant_count;
+
+    kritic_bench_summarize(&state->bench, samples, count);
+    state->bench.warmup_runs = warmup_runs;
+    free(samples);
+
+    /* Latency budgets are the benchmark's own assertions */
+    state->asserts_muted = false;
+    kritic_bench_report_latency(runtime, &kritic_bench_histogram);
+    state->asserts_muted = true;
+    if (test->cold_cache != NULL && !kritic_bench_stopped(state)) {
+        kritic_bench_run_cold(runtime, iterations, count);
+    }
+#endif // !KRITIC_DISABLE_TIMER
+}
+
+/* Run the current benchmark test: check it once, then time it */
+void kritic_bench_run(kritic_runtime_t* runtime, size_t iterations) {
+    kritic_test_state_t* state = runtime->test_state;
+    const kritic_test_t* test = state->test;
+
+    kritic_bench_prepare(runtime);
+    state->bench = (kritic_bench_result_t) { .env = runtime->bench_env };
+    kritic_bench_region_count = 0;
+    kritic_bench_regions_overflow = false;
+    if (test->benchmark->samples == 0 || iterations == 0) return;
+
+    /* The test body is the baseline, variants follow it */
+    size_t contenders = 1;
+    while (contenders <= KRITIC_MAX_VARIANTS && test->variants[contenders - 1] != NULL) ++contenders;
+
+    /* One counted pass of every contender checks the assertions, the timed passes repeat the bodies with the
+     * assertions muted so a failure is reported once rather than once per sample */
+    for (size_t v = 0; v < contenders && !kritic_bench_stopped(state); ++v) {
+        kritic_bench_sample(runtime, kritic_bench_contender(test, v), iterations);
+    }
+    if (kritic_bench_stopped(state)) return;
+
+    state->asserts_muted = true;
+    kritic_bench_measure(runtime, iterations, contenders);
+    state->asserts_muted = false;
+}
@@ -0,0 +1,119 @@
+#ifndef KRITIC_BENCH_H
+#define KRITIC_BENCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "attributes.h"
+#include "histogram.h"
+#include "scheduler.h"
+
+/* Warmup runs in windows of this many samples until two consecutive window medians agree */
+#define KRITIC_BENCH_WARMUP_WINDOW     8
+#define KRITIC_BENCH_WARMUP_MAX_WINDOWS 64
+/* Window medians closer than this (in per-mille) are considered stable */
+#define KRITIC_BENCH_STABLE_PERMILLE   20
+/* Samples further than this many (scaled) MADs away from the median are rejected */
+#define KRITIC_BENCH_MAD_THRESHOLD     3
+/* Regions a cold-cache benchmark may declare as its working set */
+#define KRITIC_BENCH_MAX_WORKING_SET   16
+/* Cache line stride used for flushing and sweeping */
+#define KRITIC_BENCH_CACHE_LINE        64
+/* Assumed last level cache size when it cannot be detected */
+#define KRITIC_BENCH_DEFAULT_LLC_SIZE  ((size_t) 32 << 20)
+/* The eviction sweep buffer is this many times larger than the last level cache */
+#define KRITIC_BENCH_SWEEP_FACTOR      2
+/* z-score of the two sided 95% confidence interval for variant speedups, times 100 */
+#define KRITIC_BENCH_CONFIDENCE_Z100   196
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct kritic_runtime_t;
+
+typedef enum {
+    KRITIC_BENCH_STATE_UNKNOWN = 0,
+    KRITIC_BENCH_STATE_OFF,
+    KRITIC_BENCH_STATE_ON
+} kritic_bench_state_t;
+
+/* Low-noise benchmark settings, applied once before the first benchmark runs */
+typedef struct {
+    bool low_noise;
+    int cpu;
+    bool raise_priority;
+    /* Latency histograms are exported here as <suite>.<name>.hgrm, disabled while NULL */
+    const char* histogram_dir;
+} kritic_bench_config_t;
+
+/* Environment conditions the benchmarks were measured under */
+typedef struct {
+    bool prepared;
+    bool low_noise;
+    int pinned_cpu;
+    bool priority_raised;
+    kritic_bench_state_t performance_governor;
+    kritic_bench_state_t turbo;
+} kritic_bench_env_t;
+
+typedef struct {
+    const char* name;
+    uint64_t median_ns;
+    /* Baseline time divided by variant time over interleaved rounds, above 1 the variant is faster */
+    double speedup;
+    double ci_low;
+    double ci_high;
+    /* The confidence interval does not contain 1 */
+    bool significant;
+} kritic_bench_variant_result_t;
+
+typedef struct {
+    size_t samples;
+    size_t kept;
+    size_t outliers;
+    size_t warmup_runs;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint64_t mean_ns;
+    uint64_t median_ns;
+    uint64_t mad_ns;
+    /* Per-operation latency percentiles, outliers included */
+    uint64_t operations;
+    uint64_t p50_ns;
+    uint64_t p90_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+    uint64_t p100_ns;
+    /* Full latency distribution, valid until the next benchmark runs */
+    const kritic_histogram_t* histogram;
+    /* Cold-cache per-operation latencies, only measured for KRITIC_COLD_CACHE benchmarks */
+    uint64_t cold_operations;
+    kritic_cache_eviction_t cold_eviction;
+    size_t working_set_bytes;
+    uint64_t cold_p50_ns;
+    uint64_t cold_p90_ns;
+    uint64_t cold_p99_ns;
+    uint64_t cold_p100_ns;
+    const kritic_histogram_t* cold_histogram;
+    /* KRITIC_VARIANT comparisons against the test body */
+    size_t variant_count;
+    kritic_bench_variant_result_t variants[KRITIC_MAX_VARIANTS];
+    kritic_bench_env_t env;
+} kritic_bench_result_t;
+
+void kritic_bench_set_low_noise(int cpu, bool raise_priority);
+void kritic_bench_set_histogram_dir(const char* directory);
+void kritic_bench_working_set(const void* data, size_t size);
+void kritic_bench_run(struct kritic_runtime_t* runtime, size_t iterations);
+void kritic_bench_teardown(struct kritic_runtime_t* runtime);
+
+/* Declares memory the current benchmark operation touches, flushed before cold-cache operations */
+#define KRITIC_WORKING_SET(_data, _size) kritic_bench_working_set((_data), (_size))
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // KRITIC_BENCH_H
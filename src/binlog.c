@@ -0,0 +1,350 @@
+/* ftruncate() and mmap() are not ISO C */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../kritic.h"
+
+void kritic_binlog_enable(const char* path) {
+    kritic_get_runtime_state()->binlog_config.path = path;
+}
+
+static const char* kritic_binlog_path(kritic_runtime_t* runtime) {
+    const char* path_env = getenv("KRITIC_BINLOG_OUTPUT");
+    if (path_env != NULL && path_env[0] != '\0') return path_env;
+    return runtime->binlog_config.path;
+}
+
+#ifdef _WIN32
+
+void kritic_binlog_init(kritic_runtime_t* runtime) {
+    if (kritic_binlog_path(runtime) == NULL) return;
+
+    fprintf(stderr, "[      ] Error: Binary result logs are not supported on Windows\n");
+    exit(1);
+}
+
+void kritic_binlog_teardown(kritic_runtime_t* runtime) {
+    (void) runtime;
+}
+
+#else // POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static kritic_binlog_t kritic_binlog_storage;
+/* Printers active before the log took over, the summary is still printed through them */
+static kritic_printers_t kritic_binlog_next;
+
+static void kritic_binlog_map(kritic_binlog_t* log, uint64_t capacity) {
+    if (ftruncate(log->fd, (off_t) capacity) != 0) {
+        perror("ftruncate failed");
+        exit(1);
+    }
+
+    void* map = mmap(NULL, (size_t) capacity, PROT_READ | PROT_WRITE, MAP_SHARED, log->fd, 0);
+    if (map == MAP_FAILED) {
+        perror("mmap failed");
+        exit(1);
+    }
+
+    log->map = map;
+    log->capacity = capacity;
+    log->header = (kritic_binlog_header_t*) map;
+}
+
+/* Reserve a record at the end of the log, only visible to readers once committed */
+static void* kritic_binlog_reserve(kritic_binlog_t* log, kritic_binlog_type_t type, size_t size) {
+    uint32_t aligned = (uint32_t) ((size + KRITIC_BINLOG_ALIGN - 1) & ~(size_t) (KRITIC_BINLOG_ALIGN - 1));
+    uint64_t offset = sizeof(kritic_binlog_header_t) + log->header->length;
+
+    if (offset + aligned > log->capacity) {
+        uint64_t capacity = log->capacity * 2;
+        while (offset + aligned > capacity) capacity *= 2;
+
+        munmap(log->map, (size_t) log->capacity);
+        kritic_binlog_map(log, capacity);
+    }
+
+    kritic_binlog_record_t* record = (kritic_binlog_record_t*) (log->map + offset);
+    memset(record, 0, aligned);
+    record->type = (uint32_t) type;
+    record->size = aligned;
+    return record;
+}
+
+static void kritic_binlog_commit(kritic_binlog_t* log, void* record) {
+    log->header->length += ((kritic_binlog_record_t*) record)->size;
+}
+
+/* Write a string without remembering it, for strings that may not outlive the call */
+static uint32_t kritic_binlog_copy_string(kritic_binlog_t* log, const char* string) {
+    if (string == NULL) return 0;
+
+    size_t length = strlen(string);
+    kritic_binlog_string_t* record = kritic_binlog_reserve(log, KRITIC_BINLOG_STRING,
+        sizeof(kritic_binlog_string_t) + length + 1);
+    record->id = log->next_id++;
+    record->length = (uint32_t) length;
+    memcpy(record + 1, string, length);
+    kritic_binlog_commit(log, record);
+
+    return record->id;
+}
+
+static size_t kritic_binlog_slot(const kritic_binlog_intern_t* table, uint32_t capacity, const char* key) {
+    size_t index = (size_t) (((uintptr_t) key >> 3) * 0x9E3779B97F4A7C15ull) & (capacity - 1);
+    while (table[index].key != NULL && table[index].key != key) index = (index + 1) & (capacity - 1);
+    return index;
+}
+
+/* File names, test names and expressions are literals, so the same pointer is the same string */
+static uint32_t kritic_binlog_intern(kritic_binlog_t* log, const char* string) {
+    if (string == NULL) return 0;
+
+    size_t index = kritic_binlog_slot(log->interned, log->interned_capacity, string);
+    if (log->interned[index].key == string) return log->interned[index].id;
+
+    if (2 * (log->interned_count + 1) > log->interned_capacity) {
+        uint32_t capacity = log->interned_capacity * 2;
+        kritic_binlog_intern_t* table = calloc(capacity, sizeof(kritic_binlog_intern_t));
+        if (table == NULL) {
+            fprintf(stderr, "[      ] Error: malloc() failed in kritic_binlog_intern()\n");
+            exit(1);
+        }
+
+        for (uint32_t i = 0; i < log->interned_capacity; ++i) {
+            if (log->interned[i].key == NULL) continue;
+            table[kritic_binlog_slot(table, capacity, log->interned[i].key)] = log->interned[i];
+        }
+        free(log->interned);
+        log->interned = table;
+        log->interned_capacity = capacity;
+        index = kritic_binlog_slot(table, capacity, string);
+    }
+
+    uint32_t id = kritic_binlog_copy_string(log, string);
+    log->interned[index] = (kritic_binlog_intern_t) { .key = string, .id = id };
+    ++log->interned_count;
+    return id;
+}
+
+static void kritic_binlog_init_printer(kritic_runtime_t* state) {
+    kritic_binlog_t* log = &kritic_binlog_storage;
+
+    pthread_mutex_lock(&log->lock);
+    kritic_binlog_run_start_t* record = kritic_binlog_reserve(log, KRITIC_BINLOG_RUN_START, sizeof(*record));
+    record->test_count    = state->test_count;
+    record->version_major = KRITIC_VERSION_MAJOR;
+    record->version_minor = KRITIC_VERSION_MINOR;
+    record->version_patch = KRITIC_VERSION_PATCH;
+    kritic_binlog_commit(log, record);
+    pthread_mutex_unlock(&log->lock);
+}
+
+static void kritic_binlog_pre_test_printer(kritic_runtime_t* state) {
+    kritic_binlog_t* log = &kritic_binlog_storage;
+    const kritic_test_t* test = state->test_state->test;
+
+    pthread_mutex_lock(&log->lock);
+    uint32_t suite = kritic_binlog_intern(log, test->suite);
+    uint32_t name = kritic_binlog_intern(log, test->name);
+    uint32_t file = kritic_binlog_intern(log, test->file);
+
+    kritic_binlog_test_start_t* record = kritic_binlog_reserve(log, KRITIC_BINLOG_TEST_START, sizeof(*record));
+    record->suite = suite;
+    record->name  = name;
+    record->file  = file;
+    record->line  = (uint32_t) test->line;
+    kritic_binlog_commit(log, record);
+    pthread_mutex_unlock(&log->lock);
+}
+
+static void kritic_binlog_assert_printer(
+    const kritic_context_t* ctx,
+    bool passed,
+    long long actual,
+    long long expected,
+    const char* actual_expr,
+    const char* expected_expr,
+    kritic_assert_type_t assert_type
+) {
+    kritic_binlog_t* log = &kritic_binlog_storage;
+    if (passed) return;
+
+    pthread_mutex_lock(&log->lock);
+    if (assert_type == KRITIC_ASSERT_EQ_STR || assert_type == KRITIC_ASSERT_NE_STR) {
+        actual = kritic_binlog_copy_string(log, (const char*)(uintptr_t)actual);
+        expected = kritic_binlog_copy_string(log, (const char*)(uintptr_t)expected);
+    }
+    uint32_t file = kritic_binlog_intern(log, ctx->file);
+    uint32_t actual_id = kritic_binlog_intern(log, actual_expr);
+    uint32_t expected_id = kritic_binlog_intern(log, expected_expr);
+
+    kritic_binlog_assert_t* record = kritic_binlog_reserve(log, KRITIC_BINLOG_ASSERT, sizeof(*record));
+    record->assert_type   = (uint32_t) assert_type;
+    record->file          = file;
+    record->line          = (uint32_t) ctx->line;
+    record->actual_expr   = actual_id;
+    record->expected_expr = expected_id;
+    record->actual        = actual;
+    record->expected      = expected;
+    kritic_binlog_commit(log, record);
+    pthread_mutex_unlock(&log->lock);
+}
+
+static void kritic_binlog_stdout_printer(kritic_runtime_t* state, kritic_redirect_ctx_t* redir_ctx) {
+    kritic_binlog_t* log = &kritic_binlog_storage;
+    (void) state;
+
+    pthread_mutex_lock(&log->lock);
+    kritic_binlog_output_t* record = kritic_binlog_reserve(log, KRITIC_BINLOG_OUTPUT,
+        sizeof(*record) + redir_ctx->length + 1);
+    record->stream           = (uint32_t) redir_ctx->stream;
+    record->is_part_of_split = redir_ctx->is_part_of_split;
+    record->timestamp_ns     = redir_ctx->timestamp_ns;
+    record->length           = redir_ctx->length;
+    memcpy(record + 1, redir_ctx->string, redir_ctx->length);
+    kritic_binlog_commit(log, record);
+    pthread_mutex_unlock(&log->lock);
+}
+
+static void kritic_binlog_skip_printer(kritic_runtime_t* state, const kritic_context_t* ctx) {
+    kritic_binlog_t* log = &kritic_binlog_storage;
+
+    pthread_mutex_lock(&log->lock);
+    uint32_t reason = kritic_binlog_copy_string(log, state->test_state->skip_reason);
+    uint32_t file = kritic_binlog_intern(log, ctx->file);
+
+    kritic_binlog_skip_t* record = kritic_binlog_reserve(log, KRITIC_BINLOG_SKIP, sizeof(*record));
+    record->reason      = reason;
+    record->file        = file;
+    record->line        = (uint32_t) ctx->line;
+    record->duration_ns = state->test_state->duration_ns;
+    kritic_binlog_commit(log, record);
+    pthread_mutex_unlock(&log->lock);
+}
+
+static void kritic_binlog_post_test_printer(kritic_runtime_t* state) {
+    kritic_binlog_t* log = &kritic_binlog_storage;
+    const kritic_test_state_t* test_state = state->test_state;
+
+    pthread_mutex_lock(&log->lock);
+    kritic_binlog_test_end_t* record = kritic_binlog_reserve(log, KRITIC_BINLOG_TEST_END, sizeof(*record));
+    record->status         = (uint32_t) test_state->test->status;
+    record->assert_count   = test_state->assert_count;
+    record->asserts_failed = test_state->asserts_failed;
+    record->skipped        = test_state->skipped;
+    record->duration_ns    = test_state->duration_ns;
+    record->cached         = test_state->cached;
+    kritic_binlog_commit(log, record);
+    pthread_mutex_unlock(&log->lock);
+}
+
+static void kritic_binlog_dep_fail_printer(kritic_runtime_t* state, kritic_test_t* test, kritic_test_t* dep_test) {
+    kritic_binlog_t* log = &kritic_binlog_storage;
+    (void) state;
+
+    pthread_mutex_lock(&log->lock);
+    uint32_t suite = kritic_binlog_intern(log, test->suite);
+    uint32_t name = kritic_binlog_intern(log, test->name);
+    uint32_t file = kritic_binlog_intern(log, test->file);
+    uint32_t dep_suite = kritic_binlog_intern(log, dep_test->suite);
+    uint32_t dep_name = kritic_binlog_intern(log, dep_test->name);
+
+    kritic_binlog_dep_fail_t* record = kritic_binlog_reserve(log, KRITIC_BINLOG_DEP_FAIL, sizeof(*record));
+    record->suite     = suite;
+    record->name      = name;
+    record->file      = file;
+    record->line      = (uint32_t) test->line;
+    record->dep_suite = dep_suite;
+    record->dep_name  = dep_name;
+    kritic_binlog_commit(log, record);
+    pthread_mutex_unlock(&log->lock);
+}
+
+static void kritic_binlog_bench_printer(kritic_runtime_t* state) {
+    (void) state;
+}
+
+static void kritic_binlog_summary_printer(kritic_runtime_t* state) {
+    kritic_binlog_t* log = &kritic_binlog_storage;
+
+    pthread_mutex_lock(&log->lock);
+    kritic_binlog_run_end_t* record = kritic_binlog_reserve(log, KRITIC_BINLOG_RUN_END, sizeof(*record));
+    record->test_count    = state->test_count;
+    record->fail_count    = state->fail_count;
+    record->skip_count    = state->skip_count;
+    record->not_run_count = state->not_run_count;
+    record->duration_ns   = state->duration_ns;
+    record->cached_count  = state->cached_count;
+    kritic_binlog_commit(log, record);
+    pthread_mutex_unlock(&log->lock);
+
+    kritic_binlog_next.summary_printer(state);
+}
+
+void kritic_binlog_init(kritic_runtime_t* runtime) {
+    kritic_binlog_t* log = &kritic_binlog_storage;
+    const char* path = kritic_binlog_path(runtime);
+    if (path == NULL) return;
+
+    memset(log, 0, sizeof(kritic_binlog_t));
+    log->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (log->fd == -1) {
+        fprintf(stderr, "[      ] Error: Could not open binary result log \"%s\"\n", path);
+        exit(1);
+    }
+    kritic_binlog_map(log, KRITIC_BINLOG_EXTENT);
+
+    memcpy(log->header->magic, KRITIC_BINLOG_MAGIC, sizeof(log->header->magic));
+    log->header->version = KRITIC_BINLOG_VERSION;
+    log->header->header_size = sizeof(kritic_binlog_header_t);
+    log->header->length = 0;
+
+    log->interned_capacity = 256;
+    log->interned = calloc(log->interned_capacity, sizeof(kritic_binlog_intern_t));
+    if (log->interned == NULL) {
+        fprintf(stderr, "[      ] Error: malloc() failed in kritic_binlog_init()\n");
+        exit(1);
+    }
+    log->next_id = 1;
+    pthread_mutex_init(&log->lock, NULL);
+
+    /* Nothing is formatted while the tests run, kritic-render does that later */
+    kritic_binlog_next = runtime->printers;
+    runtime->printers = (kritic_printers_t) {
+        .assert_printer    = &kritic_binlog_assert_printer,
+        .pre_test_printer  = &kritic_binlog_pre_test_printer,
+        .post_test_printer = &kritic_binlog_post_test_printer,
+        .summary_printer   = &kritic_binlog_summary_printer,
+        .init_printer      = &kritic_binlog_init_printer,
+        .stdout_printer    = &kritic_binlog_stdout_printer,
+        .skip_printer      = &kritic_binlog_skip_printer,
+        .dep_fail_printer  = &kritic_binlog_dep_fail_printer,
+        .bench_printer     = &kritic_binlog_bench_printer
+    };
+    runtime->binlog = log;
+}
+
+void kritic_binlog_teardown(kritic_runtime_t* runtime) {
+    kritic_binlog_t* log = runtime->binlog;
+    if (log == NULL) return;
+
+    uint64_t size = sizeof(kritic_binlog_header_t) + log->header->length;
+    munmap(log->map, (size_t) log->capacity);
+    if (ftruncate(log->fd, (off_t) size) != 0 || close(log->fd) != 0) {
+        fprintf(stderr, "[      ] Error: Could not write binary result log\n");
+    }
+
+    free(log->interned);
+    pthread_mutex_destroy(&log->lock);
+
+    runtime->printers = kritic_binlog_next;
+    runtime->binlog = NULL;
+}
+
+#endif // POSIX
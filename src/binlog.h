@@ -0,0 +1,173 @@
+#ifndef KRITIC_BINLOG_H
+#define KRITIC_BINLOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define KRITIC_BINLOG_MAGIC   "KRITICLG"
+#define KRITIC_BINLOG_VERSION 2
+/* The log file grows in steps of this size, so most records are only a few stores into the mapping */
+#define KRITIC_BINLOG_EXTENT  (1u << 20)
+/* Records are padded to this alignment */
+#define KRITIC_BINLOG_ALIGN   8
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct kritic_runtime_t;
+
+typedef enum {
+    KRITIC_BINLOG_STRING = 1,
+    KRITIC_BINLOG_RUN_START,
+    KRITIC_BINLOG_TEST_START,
+    KRITIC_BINLOG_ASSERT,
+    KRITIC_BINLOG_SKIP,
+    KRITIC_BINLOG_OUTPUT,
+    KRITIC_BINLOG_TEST_END,
+    KRITIC_BINLOG_DEP_FAIL,
+    KRITIC_BINLOG_RUN_END
+} kritic_binlog_type_t;
+
+/* Start of the file, length only covers complete records so a crashed run still leaves a readable log */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t length;
+} kritic_binlog_header_t;
+
+/* Common head of every record, size includes the head and the padding */
+typedef struct {
+    uint32_t type;
+    uint32_t size;
+} kritic_binlog_record_t;
+
+/* Strings are written once and referred to by id afterwards, id 0 stands for NULL */
+typedef struct {
+    kritic_binlog_record_t record;
+    uint32_t id;
+    uint32_t length;
+    /* Followed by the bytes and a terminator */
+} kritic_binlog_string_t;
+
+typedef struct {
+    kritic_binlog_record_t record;
+    uint32_t test_count;
+    uint32_t version_major;
+    uint32_t version_minor;
+    uint32_t version_patch;
+} kritic_binlog_run_start_t;
+
+typedef struct {
+    kritic_binlog_record_t record;
+    uint32_t suite;
+    uint32_t name;
+    uint32_t file;
+    uint32_t line;
+} kritic_binlog_test_start_t;
+
+/* Only failed assertions are logged, string assertions store string ids in actual/expected */
+typedef struct {
+    kritic_binlog_record_t record;
+    uint32_t assert_type;
+    uint32_t file;
+    uint32_t line;
+    uint32_t actual_expr;
+    uint32_t expected_expr;
+    uint32_t reserved;
+    int64_t actual;
+    int64_t expected;
+} kritic_binlog_assert_t;
+
+typedef struct {
+    kritic_binlog_record_t record;
+    uint32_t reason;
+    uint32_t file;
+    uint32_t line;
+    uint32_t reserved;
+    uint64_t duration_ns;
+} kritic_binlog_skip_t;
+
+typedef struct {
+    kritic_binlog_record_t record;
+    uint32_t stream;
+    uint32_t is_part_of_split;
+    uint64_t timestamp_ns;
+    uint32_t length;
+    uint32_t reserved;
+    /* Followed by the bytes and a terminator */
+} kritic_binlog_output_t;
+
+typedef struct {
+    kritic_binlog_record_t record;
+    uint32_t status;
+    int32_t assert_count;
+    int32_t asserts_failed;
+    uint32_t skipped;
+    uint64_t duration_ns;
+    /* Replayed from the result cache */
+    uint32_t cached;
+    uint32_t reserved;
+} kritic_binlog_test_end_t;
+
+typedef struct {
+    kritic_binlog_record_t record;
+    uint32_t suite;
+    uint32_t name;
+    uint32_t file;
+    uint32_t line;
+    uint32_t dep_suite;
+    uint32_t dep_name;
+} kritic_binlog_dep_fail_t;
+
+typedef struct {
+    kritic_binlog_record_t record;
+    uint32_t test_count;
+    uint32_t fail_count;
+    uint32_t skip_count;
+    uint32_t not_run_count;
+    uint64_t duration_ns;
+    uint32_t cached_count;
+    uint32_t reserved;
+} kritic_binlog_run_end_t;
+
+typedef struct {
+    const char* path;
+} kritic_binlog_config_t;
+
+/* Pointer of a string that was already written, and the id it got */
+typedef struct {
+    const char* key;
+    uint32_t id;
+} kritic_binlog_intern_t;
+
+typedef struct {
+    int fd;
+    char* map;
+    uint64_t capacity;
+    kritic_binlog_header_t* header;
+    kritic_binlog_intern_t* interned;
+    uint32_t interned_capacity;
+    uint32_t interned_count;
+    uint32_t next_id;
+#ifndef _WIN32
+    /* The redirect reader thread logs captured output */
+    pthread_mutex_t lock;
+#endif
+} kritic_binlog_t;
+
+void kritic_binlog_enable(const char* path);
+void kritic_binlog_init(struct kritic_runtime_t* runtime);
+void kritic_binlog_teardown(struct kritic_runtime_t* runtime);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // KRITIC_BINLOG_H
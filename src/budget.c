@@ -0,0 +1,65 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../kritic.h"
+
+void kritic_set_fail_fast(uint32_t max_failures) {
+    kritic_budget_config_t* config = &kritic_get_runtime_state()->budget_config;
+    config->max_failures = max_failures;
+    config->max_failures_set = true;
+}
+
+void kritic_set_time_budget(uint64_t budget_ns) {
+    kritic_budget_config_t* config = &kritic_get_runtime_state()->budget_config;
+    config->time_budget_ns = budget_ns;
+    config->time_budget_set = true;
+}
+
+/* Limits set through the API or the command line win over KRITIC_FAIL_FAST and KRITIC_TIME_BUDGET */
+void kritic_budget_init(kritic_runtime_t* runtime) {
+    kritic_budget_config_t* config = &runtime->budget_config;
+    const char* fail_fast = getenv("KRITIC_FAIL_FAST");
+    const char* time_budget = getenv("KRITIC_TIME_BUDGET");
+
+    if (!config->max_failures_set && fail_fast != NULL && fail_fast[0] != '\0') {
+        char* end;
+        unsigned long failures = strtoul(fail_fast, &end, 10);
+        if (fail_fast[0] == '-' || *end != '\0' || failures == 0 || failures > UINT32_MAX) {
+            fprintf(stderr, "[      ] Error: KRITIC_FAIL_FAST=\"%s\" is not a positive number\n", fail_fast);
+            exit(1);
+        }
+        config->max_failures = (uint32_t) failures;
+    }
+
+    if (!config->time_budget_set && time_budget != NULL && time_budget[0] != '\0') {
+        char* end;
+        double seconds = strtod(time_budget, &end);
+        if (*end != '\0' || !(seconds > 0.0) || seconds > 1e9) {
+            fprintf(stderr, "[      ] Error: KRITIC_TIME_BUDGET=\"%s\" is not a positive number of seconds\n",
+                time_budget);
+            exit(1);
+        }
+        config->time_budget_ns = (uint64_t) (seconds * 1e9);
+    }
+}
+
+/* Checked before every test, a test that already started always runs to the end */
+bool kritic_budget_exhausted(kritic_runtime_t* runtime) {
+    const kritic_budget_config_t* config = &runtime->budget_config;
+
+    if (config->max_failures > 0 && runtime->fail_count >= config->max_failures) return true;
+    return config->time_budget_ns > 0 && kritic_timer_elapsed(&runtime->timer) >= config->time_budget_ns;
+}
+
+void kritic_budget_stop(kritic_runtime_t* runtime, uint32_t remaining) {
+    const kritic_budget_config_t* config = &runtime->budget_config;
+    runtime->not_run_count = remaining;
+
+    if (config->max_failures > 0 && runtime->fail_count >= config->max_failures) {
+        kritic_printerf("[      ] Stopping after %u failed tests, %u tests not run\n", runtime->fail_count, remaining);
+    } else {
+        kritic_printerf("[      ] Time budget of %" PRIu64 "ms spent, %u tests not run\n",
+            config->time_budget_ns / 1000000, remaining);
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef KRITIC_BUDGET_H
+#define KRITIC_BUDGET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct kritic_runtime_t;
+
+/* Limits that end a run before every queued test ran, 0 disables a limit */
+typedef struct {
+    uint32_t max_failures;
+    uint64_t time_budget_ns;
+    /* Set through the API or the command line, even to 0, which keeps the environment out */
+    bool max_failures_set;
+    bool time_budget_set;
+} kritic_budget_config_t;
+
+void kritic_set_fail_fast(uint32_t max_failures);
+void kritic_set_time_budget(uint64_t budget_ns);
+void kritic_budget_init(struct kritic_runtime_t* runtime);
+bool kritic_budget_exhausted(struct kritic_runtime_t* runtime);
+void kritic_budget_stop(struct kritic_runtime_t* runtime, uint32_t remaining);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // KRITIC_BUDGET_H
@@ -0,0 +1,452 @@
+/* dl_iterate_phdr() is a GNU extension, ftruncate(), pread() and mmap() are not ISO C */
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../kritic.h"
+
+#define KRITIC_CACHE_FNV_OFFSET 14695981039346656037ull
+#define KRITIC_CACHE_FNV_PRIME  1099511628211ull
+
+void kritic_cache_enable(const char* path) {
+    kritic_get_runtime_state()->cache_config.path = path;
+}
+
+static const char* kritic_cache_path(kritic_runtime_t* runtime) {
+    const char* path_env = getenv("KRITIC_CACHE");
+    if (path_env != NULL && path_env[0] != '\0') return path_env;
+    return runtime->cache_config.path;
+}
+
+#if defined(__linux__)
+#include <elf.h>
+#include <fcntl.h>
+#include <link.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static uint64_t kritic_cache_hash(uint64_t hash, const void* data, size_t size) {
+    const uint8_t* bytes = data;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= KRITIC_CACHE_FNV_PRIME;
+    }
+    return hash;
+}
+
+/* FNV-1a of "suite.name", never 0 so it cannot be mistaken for a free slot */
+static uint64_t kritic_cache_name_hash(const kritic_test_t* test) {
+    uint64_t hash = KRITIC_CACHE_FNV_OFFSET;
+    hash = kritic_cache_hash(hash, test->suite, strlen(test->suite));
+    hash = kritic_cache_hash(hash, ".", 1);
+    hash = kritic_cache_hash(hash, test->name, strlen(test->name));
+    return hash != 0 ? hash : 1;
+}
+
+/* Function symbol of a loaded object, its address relative to the object's load address */
+typedef struct {
+    uintptr_t value;
+    size_t size;
+} kritic_cache_symbol_t;
+
+/* Loaded object holding a test function and the extents of the functions in it */
+typedef struct {
+    uintptr_t address;
+    uintptr_t base;
+    uintptr_t start;
+    uintptr_t end;
+    const char* path;
+    /* Identity of the whole object, for functions missing from its symbol table */
+    uint64_t identity;
+    kritic_cache_symbol_t* symbols;
+    size_t symbol_count;
+    bool found;
+} kritic_cache_object_t;
+
+static kritic_cache_t kritic_cache_storage;
+
+/* Hash of the GNU build ID note, false if the object was linked without one */
+static bool kritic_cache_build_id(const struct dl_phdr_info* info, uint64_t* identity) {
+    for (ElfW(Half) p = 0; p < info->dlpi_phnum; ++p) {
+        const ElfW(Phdr)* phdr = &info->dlpi_phdr[p];
+        if (phdr->p_type != PT_NOTE) continue;
+
+        const char* note = (const char*) (info->dlpi_addr + phdr->p_vaddr);
+        const char* end = note + phdr->p_memsz;
+        while (note + sizeof(ElfW(Nhdr)) <= end) {
+            const ElfW(Nhdr)* header = (const ElfW(Nhdr)*) (const void*) note;
+            const char* name = note + sizeof(ElfW(Nhdr));
+            const char* desc = name + ((header->n_namesz + 3) & ~3u);
+            note = desc + ((header->n_descsz + 3) & ~3u);
+
+            if (header->n_type == NT_GNU_BUILD_ID && header->n_namesz == 4 && memcmp(name, "GNU", 4) == 0
+                && note <= end) {
+                *identity = kritic_cache_hash(KRITIC_CACHE_FNV_OFFSET, desc, header->n_descsz);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/* Build ID of an object, without one its executable segments stand in for it, they never change at runtime */
+static uint64_t kritic_cache_object_identity(const struct dl_phdr_info* info) {
+    uint64_t identity;
+    if (kritic_cache_build_id(info, &identity)) return identity;
+
+    identity = KRITIC_CACHE_FNV_OFFSET;
+    for (ElfW(Half) p = 0; p < info->dlpi_phnum; ++p) {
+        const ElfW(Phdr)* phdr = &info->dlpi_phdr[p];
+        if (phdr->p_type != PT_LOAD || (phdr->p_flags & PF_X) == 0) continue;
+
+        identity = kritic_cache_hash(identity, (const void*) (info->dlpi_addr + phdr->p_vaddr), phdr->p_filesz);
+    }
+    return identity;
+}
+
+/* Identities of every shared library folded into one, the main program is always reported first and unnamed */
+static int kritic_cache_hash_libraries(struct dl_phdr_info* info, size_t size, void* data) {
+    uint64_t* hash = data;
+    (void) size;
+
+    if (info->dlpi_name == NULL || info->dlpi_name[0] == '\0') return 0;
+    uint64_t identity = kritic_cache_object_identity(info);
+    *hash = kritic_cache_hash(*hash, &identity, sizeof(identity));
+    return 0;
+}
+
+static int kritic_cache_find_object(struct dl_phdr_info* info, size_t size, void* data) {
+    kritic_cache_object_t* object = data;
+    uintptr_t start = UINTPTR_MAX, end = 0;
+    (void) size;
+
+    for (ElfW(Half) p = 0; p < info->dlpi_phnum; ++p) {
+        const ElfW(Phdr)* phdr = &info->dlpi_phdr[p];
+        if (phdr->p_type != PT_LOAD) continue;
+
+        uintptr_t segment = info->dlpi_addr + phdr->p_vaddr;
+        if (segment < start) start = segment;
+        if (segment + phdr->p_memsz > end) end = segment + phdr->p_memsz;
+    }
+    if (object->address < start || object->address >= end) return 0;
+
+    object->base = info->dlpi_addr;
+    object->start = start;
+    object->end = end;
+    object->path = info->dlpi_name != NULL && info->dlpi_name[0] != '\0' ? info->dlpi_name : "/proc/self/exe";
+    object->identity = kritic_cache_object_identity(info);
+    object->found = true;
+    return 1;
+}
+
+static int kritic_cache_compare_symbols(const void* a, const void* b) {
+    uintptr_t left = ((const kritic_cache_symbol_t*) a)->value;
+    uintptr_t right = ((const kritic_cache_symbol_t*) b)->value;
+    return (left > right) - (left < right);
+}
+
+/* Sizes of the functions in the object's file, from .symtab since tests are static, or .dynsym once stripped */
+static void kritic_cache_load_symbols(kritic_cache_object_t* object) {
+    int fd = open(object->path, O_RDONLY);
+    struct stat info;
+    if (fd == -1) return;
+    if (fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(ElfW(Ehdr))) {
+        close(fd);
+        return;
+    }
+
+    size_t length = (size_t) info.st_size;
+    const uint8_t* file = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (file == MAP_FAILED) return;
+
+    const ElfW(Ehdr)* header = (const ElfW(Ehdr)*) (const void*) file;
+    const ElfW(Shdr)* table = NULL;
+    if (memcmp(header->e_ident, ELFMAG, SELFMAG) == 0 && header->e_shentsize == sizeof(ElfW(Shdr))
+        && header->e_shoff + (size_t) header->e_shnum * sizeof(ElfW(Shdr)) <= length) {
+        const ElfW(Shdr)* sections = (const ElfW(Shdr)*) (const void*) (file + header->e_shoff);
+        for (ElfW(Half) i = 0; i < header->e_shnum; ++i) {
+            if (sections[i].sh_type == SHT_SYMTAB || (sections[i].sh_type == SHT_DYNSYM && table == NULL)) {
+                table = &sections[i];
+            }
+        }
+    }
+
+    if (table != NULL && table->sh_entsize == sizeof(ElfW(Sym)) && table->sh_offset + table->sh_size <= length) {
+        const ElfW(Sym)* symbols = (const ElfW(Sym)*) (const void*) (file + table->sh_offset);
+        size_t count = table->sh_size / sizeof(ElfW(Sym));
+
+        object->symbols = malloc((count + 1) * sizeof(kritic_cache_symbol_t));
+        if (object->symbols == NULL) {
+            fprintf(stderr, "[      ] Error: malloc() failed in kritic_cache_load_symbols()\n");
+            exit(1);
+        }
+        /* The symbol type sits in the low bits of st_info for both ELF classes */
+        for (size_t i = 0; i < count; ++i) {
+            if (ELF64_ST_TYPE(symbols[i].st_info) != STT_FUNC || symbols[i].st_size == 0
+                || symbols[i].st_shndx == SHN_UNDEF) continue;
+            object->symbols[object->symbol_count++] = (kritic_cache_symbol_t) {
+                .value = (uintptr_t) symbols[i].st_value,
+                .size  = (size_t) symbols[i].st_size
+            };
+        }
+        qsort(object->symbols, object->symbol_count, sizeof(kritic_cache_symbol_t), kritic_cache_compare_symbols);
+    }
+    munmap((void*) (uintptr_t) file, length);
+}
+
+/* Identity of the code a test runs: the bytes of its own function and the shared libraries it may call into, editing
+ * one test leaves the others cached. Functions missing from the symbol table fall back to the whole object. Tests of
+ * one binary share the object of the last lookup */
+static bool kritic_cache_code_identity(kritic_cache_object_t* last, kritic_test_fn fn, uint64_t* identity) {
+    static uint64_t libraries = 0;
+    uintptr_t address = (uintptr_t) fn;
+
+    if (libraries == 0) {
+        libraries = KRITIC_CACHE_FNV_OFFSET;
+        dl_iterate_phdr(kritic_cache_hash_libraries, &libraries);
+    }
+
+    if (!last->found || address < last->start || address >= last->end) {
+        kritic_cache_object_t object = { .address = address };
+        dl_iterate_phdr(kritic_cache_find_object, &object);
+        if (!object.found) return false;
+
+        free(last->symbols);
+        kritic_cache_load_symbols(&object);
+        *last = object;
+    }
+
+    kritic_cache_symbol_t key = { .value = address - last->base };
+    const kritic_cache_symbol_t* symbol = bsearch(&key, last->symbols, last->symbol_count,
+        sizeof(kritic_cache_symbol_t), kritic_cache_compare_symbols);
+
+    *identity = symbol != NULL ? kritic_cache_hash(libraries, (const void*) address, symbol->size)
+                               : kritic_cache_hash(libraries, &last->identity, sizeof(last->identity));
+    return true;
+}
+
+/* Benchmarks measure rather than check, so they always run; a test depending on one that cannot be cached cannot be
+ * either since that dependency's side effects would be missing */
+static uint64_t kritic_cache_fingerprint(const kritic_cache_t* cache, kritic_cache_object_t* object,
+    const kritic_test_t* test) {
+    uint64_t identity;
+    if (test->no_cache || test->benchmark != NULL || !kritic_cache_code_identity(object, test->fn, &identity)) {
+        return 0;
+    }
+
+    uint64_t hash = kritic_cache_hash(KRITIC_CACHE_FNV_OFFSET, &identity, sizeof(identity));
+    hash = kritic_cache_hash(hash, test->suite, strlen(test->suite) + 1);
+    hash = kritic_cache_hash(hash, test->name, strlen(test->name) + 1);
+
+    for (size_t p = 0; p < KRITIC_MAX_PARAMETERIZED && test->parameterized[p] != NULL; ++p) {
+        const kritic_attr_parameterized_t* param = test->parameterized[p];
+        hash = kritic_cache_hash(hash, param->varname, strlen(param->varname) + 1);
+        hash = kritic_cache_hash(hash, &param->size, sizeof(param->size));
+        hash = kritic_cache_hash(hash, &param->elem_size, sizeof(param->elem_size));
+        hash = kritic_cache_hash(hash, param->array, param->size * param->elem_size);
+    }
+
+    for (size_t d = 0; test->dependencies[d] != NULL; ++d) {
+        uint64_t dependency = cache->fingerprints[test->dependencies[d]->index];
+        if (dependency == 0) return 0;
+        hash = kritic_cache_hash(hash, &dependency, sizeof(dependency));
+    }
+    return hash != 0 ? hash : 1;
+}
+
+static kritic_cache_entry_t* kritic_cache_slot(kritic_cache_entry_t* entries, uint64_t capacity, uint64_t hash) {
+    uint64_t mask = capacity - 1;
+    uint64_t i = hash & mask;
+
+    while (entries[i].name_hash != 0 && entries[i].name_hash != hash) i = (i + 1) & mask;
+    return &entries[i];
+}
+
+static void kritic_cache_map(kritic_cache_t* cache, uint64_t capacity, bool resize) {
+    size_t size = sizeof(kritic_cache_header_t) + (size_t) capacity * sizeof(kritic_cache_entry_t);
+
+    if (resize && ftruncate(cache->fd, (off_t) size) != 0) {
+        perror("ftruncate failed");
+        exit(1);
+    }
+
+    void* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, cache->fd, 0);
+    if (map == MAP_FAILED) {
+        perror("mmap failed");
+        exit(1);
+    }
+
+    cache->map = map;
+    cache->size = size;
+    cache->header = (kritic_cache_header_t*) map;
+    cache->entries = (kritic_cache_entry_t*) (cache->map + sizeof(kritic_cache_header_t));
+}
+
+/* A cache written by another version is dropped, the worst that costs is running every test once more */
+static bool kritic_cache_valid(int fd) {
+    struct stat info;
+    kritic_cache_header_t header;
+
+    if (fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(header)) return false;
+    if (pread(fd, &header, sizeof(header), 0) != (ssize_t) sizeof(header)) return false;
+
+    return memcmp(header.magic, KRITIC_CACHE_MAGIC, sizeof(header.magic)) == 0
+        && header.version == KRITIC_CACHE_VERSION
+        && header.header_size == sizeof(kritic_cache_header_t)
+        && header.capacity > 0 && (header.capacity & (header.capacity - 1)) == 0
+        && (uint64_t) info.st_size == sizeof(header) + header.capacity * sizeof(kritic_cache_entry_t);
+}
+
+static void kritic_cache_reset(kritic_cache_t* cache, uint64_t capacity) {
+    kritic_cache_map(cache, capacity, true);
+    memset(cache->map, 0, cache->size);
+    memcpy(cache->header->magic, KRITIC_CACHE_MAGIC, sizeof(cache->header->magic));
+    cache->header->version = KRITIC_CACHE_VERSION;
+    cache->header->header_size = sizeof(kritic_cache_header_t);
+    cache->header->capacity = capacity;
+}
+
+/* Double the table, the entries are rehashed through a copy since the mapping moves */
+static void kritic_cache_grow(kritic_cache_t* cache) {
+    uint64_t capacity = cache->header->capacity;
+    uint64_t count = cache->header->count;
+    kritic_cache_entry_t* entries = malloc((size_t) capacity * sizeof(kritic_cache_entry_t));
+    if (entries == NULL) {
+        fprintf(stderr, "[      ] Error: malloc() failed in kritic_cache_grow()\n");
+        exit(1);
+    }
+
+    memcpy(entries, cache->entries, (size_t) capacity * sizeof(kritic_cache_entry_t));
+    munmap(cache->map, cache->size);
+    kritic_cache_reset(cache, capacity * 2);
+
+    for (uint64_t i = 0; i < capacity; ++i) {
+        if (entries[i].name_hash == 0) continue;
+        *kritic_cache_slot(cache->entries, capacity * 2, entries[i].name_hash) = entries[i];
+    }
+    cache->header->count = count;
+    free(entries);
+}
+
+/* Open the cache and fingerprint the queue, called once the queue is final */
+void kritic_cache_init(kritic_runtime_t* runtime) {
+    kritic_cache_t* cache = &kritic_cache_storage;
+    const char* path = kritic_cache_path(runtime);
+    if (path == NULL || runtime->cache != NULL) return;
+
+    memset(cache, 0, sizeof(kritic_cache_t));
+    cache->fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (cache->fd == -1) {
+        fprintf(stderr, "[      ] Error: Could not open result cache \"%s\"\n", path);
+        exit(1);
+    }
+
+    if (kritic_cache_valid(cache->fd)) {
+        kritic_cache_header_t header;
+        if (pread(cache->fd, &header, sizeof(header), 0) != (ssize_t) sizeof(header)) {
+            fprintf(stderr, "[      ] Error: Could not read result cache \"%s\"\n", path);
+            exit(1);
+        }
+        kritic_cache_map(cache, header.capacity, false);
+    } else {
+        kritic_cache_reset(cache, KRITIC_CACHE_CAPACITY);
+    }
+
+    cache->fingerprints = malloc(((size_t) runtime->test_count + 1) * sizeof(uint64_t));
+    if (cache->fingerprints == NULL) {
+        fprintf(stderr, "[      ] Error: malloc() failed in kritic_cache_init()\n");
+        exit(1);
+    }
+    /* Dependencies come first in the queue, so theirs are always done already */
+    kritic_cache_object_t object = { 0 };
+    for (size_t i = 0; i < runtime->test_count; ++i) {
+        cache->fingerprints[i] = kritic_cache_fingerprint(cache, &object, runtime->queue[i]);
+    }
+    free(object.symbols);
+    runtime->cache = cache;
+}
+
+/* Replay the last pass of the test if nothing it depends on changed since */
+bool kritic_cache_hit(kritic_runtime_t* runtime, size_t position) {
+    kritic_cache_t* cache = runtime->cache;
+    if (cache == NULL || cache->fingerprints[position] == 0) return false;
+    /* A test replayed while recording the impact index would be missing from it */
+    if (runtime->impact != NULL && runtime->impact->recording) return false;
+
+    const kritic_test_t* test = runtime->queue[position];
+    const kritic_cache_entry_t* entry = kritic_cache_slot(cache->entries, cache->header->capacity,
+        kritic_cache_name_hash(test));
+    if (entry->name_hash == 0 || entry->fingerprint != cache->fingerprints[position]) return false;
+
+    runtime->test_state->assert_count = entry->assert_count;
+    runtime->test_state->cached = true;
+    return true;
+}
+
+/* Passes are stored for the next run, anything else invalidates what was stored */
+void kritic_cache_record(kritic_runtime_t* runtime, size_t position) {
+    kritic_cache_t* cache = runtime->cache;
+    if (cache == NULL || runtime->test_state->cached) return;
+
+    const kritic_test_t* test = runtime->queue[position];
+    uint64_t name_hash = kritic_cache_name_hash(test);
+    kritic_cache_entry_t* entry = kritic_cache_slot(cache->entries, cache->header->capacity, name_hash);
+    bool passed = test->status == KRITIC_PASSED && cache->fingerprints[position] != 0;
+
+    if (entry->name_hash == 0) {
+        if (!passed) return;
+        if (2 * (cache->header->count + 1) > cache->header->capacity) {
+            kritic_cache_grow(cache);
+            entry = kritic_cache_slot(cache->entries, cache->header->capacity, name_hash);
+        }
+        ++cache->header->count;
+    }
+
+    /* The slot is kept with fingerprint 0, which no test ever gets, so probe chains stay intact */
+    *entry = (kritic_cache_entry_t) {
+        .name_hash    = name_hash,
+        .fingerprint  = passed ? cache->fingerprints[position] : 0,
+        .duration_ns  = runtime->test_state->duration_ns,
+        .assert_count = runtime->test_state->assert_count
+    };
+}
+
+void kritic_cache_teardown(kritic_runtime_t* runtime) {
+    kritic_cache_t* cache = runtime->cache;
+    if (cache == NULL) return;
+
+    free(cache->fingerprints);
+    munmap(cache->map, cache->size);
+    if (close(cache->fd) != 0) {
+        fprintf(stderr, "[      ] Error: Could not write result cache\n");
+    }
+    runtime->cache = NULL;
+}
+
+#else // Unsupported platform
+
+void kritic_cache_init(kritic_runtime_t* runtime) {
+    if (kritic_cache_path(runtime) == NULL) return;
+    fprintf(stderr, "[      ] Warning: The result cache is only supported on Linux, every test runs\n");
+}
+
+bool kritic_cache_hit(kritic_runtime_t* runtime, size_t position) {
+    (void) runtime;
+    (void) position;
+    return false;
+}
+
+void kritic_cache_record(kritic_runtime_t* runtime, size_t position) {
+    (void) runtime;
+    (void) position;
+}
+
+void kritic_cache_teardown(kritic_runtime_t* runtime) {
+    (void) runtime;
+}
+
+#endif // Unsupported platform
@@ -0,0 +1,62 @@
+#ifndef KRITIC_CACHE_H
+#define KRITIC_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define KRITIC_CACHE_MAGIC    "KRITICCA"
+#define KRITIC_CACHE_VERSION  1
+/* Slots of a new cache file, the table doubles whenever it gets half full */
+#define KRITIC_CACHE_CAPACITY 256
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct kritic_runtime_t;
+
+/* Start of the file, followed by capacity entries */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t capacity;
+    uint64_t count;
+} kritic_cache_header_t;
+
+/* Last pass of a test, keyed by the 64-bit FNV-1a hash of "suite.name", name_hash 0 marks a free slot */
+typedef struct {
+    uint64_t name_hash;
+    /* Code, parameters and dependencies the pass was recorded with */
+    uint64_t fingerprint;
+    uint64_t duration_ns;
+    int32_t assert_count;
+    uint32_t reserved;
+} kritic_cache_entry_t;
+
+typedef struct {
+    const char* path;
+} kritic_cache_config_t;
+
+typedef struct {
+    int fd;
+    char* map;
+    size_t size;
+    kritic_cache_header_t* header;
+    kritic_cache_entry_t* entries;
+    /* Fingerprint of every queued test by queue position, 0 if the test cannot be cached */
+    uint64_t* fingerprints;
+} kritic_cache_t;
+
+void kritic_cache_enable(const char* path);
+void kritic_cache_init(struct kritic_runtime_t* runtime);
+bool kritic_cache_hit(struct kritic_runtime_t* runtime, size_t position);
+void kritic_cache_record(struct kritic_runtime_t* runtime, size_t position);
+void kritic_cache_teardown(struct kritic_runtime_t* runtime);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // KRITIC_CACHE_H
@@ -0,0 +1,219 @@
+/* fileno() and isatty() are not ISO C */
+#define _POSIX_C_SOURCE 200112L
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../kritic.h"
+
+#ifdef _WIN32
+#define kritic_console_isatty(f) _isatty(_fileno(f))
+#else // POSIX
+#define kritic_console_isatty(f) isatty(fileno(f))
+#endif // POSIX
+
+static kritic_console_t kritic_console_storage;
+/* Printers the console filters */
+static kritic_printers_t kritic_console_next;
+
+void kritic_console_set_mode(kritic_console_mode_t mode) {
+    kritic_get_runtime_state()->console_config.mode = mode;
+}
+
+void kritic_console_set_color(kritic_color_mode_t color) {
+    kritic_get_runtime_state()->console_config.color = color;
+}
+
+/* Erase the status line so the next line starts in the first column */
+static void kritic_console_clear(kritic_console_t* console) {
+    if (!console->status_drawn) return;
+
+    kritic_output_write(KRITIC_STREAM_STDOUT, "\r\033[K", 4);
+    console->status_drawn = false;
+}
+
+/* Tests only get their EXEC line once they have something to show */
+static void kritic_console_header(kritic_runtime_t* state) {
+    kritic_console_t* console = &kritic_console_storage;
+
+    kritic_console_clear(console);
+    if (state->test_state == NULL || console->header_test == state->test_state->test) return;
+
+    console->header_test = state->test_state->test;
+    kritic_console_next.pre_test_printer(state);
+}
+
+static void kritic_console_status(kritic_runtime_t* state, bool force) {
+    kritic_console_t* console = &kritic_console_storage;
+    uint64_t elapsed_ns = kritic_timer_elapsed(&state->timer);
+
+    if (console->mode != KRITIC_CONSOLE_PROGRESS) return;
+    if (!force && elapsed_ns < console->next_refresh_ns) return;
+    console->next_refresh_ns = elapsed_ns + (console->tty ? KRITIC_CONSOLE_REFRESH_NS : KRITIC_CONSOLE_LOG_REFRESH_NS);
+
+    /* Integer math, the default printers may be built without floating point */
+    uint64_t elapsed_ms = elapsed_ns / 1000000u;
+    uint64_t rate = elapsed_ms > 0 ? (uint64_t) console->completed * 1000u / elapsed_ms : 0;
+    uint32_t remaining = state->test_count - console->completed;
+    uint64_t eta_ms = console->completed > 0 ? elapsed_ms * remaining / console->completed : 0;
+
+    char line[256];
+    int length = kritic_snprintf(line, sizeof(line),
+        "%s[ %u/%u ] %s%u failed%s, %u skipped, %" PRIu64 " tests/s, ETA %" PRIu64 ".%" PRIu64 "s%s",
+        console->tty ? "\r\033[K" : "",
+        console->completed,
+        state->test_count,
+        console->failed > 0 ? "\033[1;31m" : "",
+        console->failed,
+        console->failed > 0 ? "\033[0m" : "",
+        console->skipped,
+        rate,
+        eta_ms / 1000u,
+        (eta_ms / 100u) % 10u,
+        console->tty ? "" : "\n"
+    );
+    if (length <= 0 || length >= (int) sizeof(line)) return;
+
+    kritic_output_write(KRITIC_STREAM_STDOUT, line, (size_t) length);
+    kritic_output_flush(state);
+    console->status_drawn = console->tty;
+}
+
+static void kritic_console_assert_printer(
+    const kritic_context_t* ctx,
+    bool passed,
+    long long actual,
+    long long expected,
+    const char* actual_expr,
+    const char* expected_expr,
+    kritic_assert_type_t assert_type
+) {
+    if (passed) return;
+
+    kritic_console_header(kritic_get_runtime_state());
+    kritic_console_next.assert_printer(ctx, passed, actual, expected, actual_expr, expected_expr, assert_type);
+}
+
+/* Only reached for held back output of tests that did not pass */
+static void kritic_console_stdout_printer(kritic_runtime_t* state, kritic_redirect_ctx_t* redir_ctx) {
+    kritic_console_header(state);
+    kritic_console_next.stdout_printer(state, redir_ctx);
+}
+
+static void kritic_console_skip_printer(kritic_runtime_t* state, const kritic_context_t* ctx) {
+    kritic_console_header(state);
+    kritic_console_next.skip_printer(state, ctx);
+}
+
+static void kritic_console_post_test_printer(kritic_runtime_t* state) {
+    kritic_console_t* console = &kritic_console_storage;
+    kritic_test_status_t status = state->test_state->test->status;
+
+    ++console->completed;
+    if (status == KRITIC_FAILED) {
+        ++console->failed;
+        kritic_console_header(state);
+        kritic_console_next.post_test_printer(state);
+    } else if (status == KRITIC_SKIPPED) {
+        ++console->skipped;
+    }
+    kritic_console_status(state, false);
+}
+
+static void kritic_console_dep_fail_printer(kritic_runtime_t* state, kritic_test_t* test, kritic_test_t* dep_test) {
+    kritic_console_t* console = &kritic_console_storage;
+
+    ++console->completed;
+    ++console->skipped;
+    kritic_console_clear(console);
+    kritic_console_next.dep_fail_printer(state, test, dep_test);
+    kritic_console_status(state, false);
+}
+
+static void kritic_console_summary_printer(kritic_runtime_t* state) {
+    kritic_console_t* console = &kritic_console_storage;
+
+    /* Leave the final counts on screen above the summary */
+    if (console->mode == KRITIC_CONSOLE_PROGRESS) {
+        kritic_console_status(state, true);
+        if (console->tty) kritic_output_write(KRITIC_STREAM_STDOUT, "\n", 1);
+        console->status_drawn = false;
+    }
+    kritic_console_next.summary_printer(state);
+}
+
+static kritic_console_mode_t kritic_console_mode(kritic_runtime_t* runtime) {
+    const char* mode = getenv("KRITIC_CONSOLE");
+    if (mode == NULL || mode[0] == '\0') return runtime->console_config.mode;
+
+    if (strcmp(mode, "quiet") == 0) return KRITIC_CONSOLE_QUIET;
+    if (strcmp(mode, "progress") == 0) return KRITIC_CONSOLE_PROGRESS;
+    if (strcmp(mode, "verbose") == 0) return KRITIC_CONSOLE_VERBOSE;
+
+    fprintf(stderr, "[      ] Error: Unknown console mode \"%s\", expected quiet, progress or verbose\n", mode);
+    exit(1);
+}
+
+static kritic_color_mode_t kritic_console_color(kritic_runtime_t* runtime) {
+    const char* color = getenv("KRITIC_COLOR");
+    if (color == NULL || color[0] == '\0') return runtime->console_config.color;
+
+    if (strcmp(color, "auto") == 0) return KRITIC_COLOR_AUTO;
+    if (strcmp(color, "always") == 0) return KRITIC_COLOR_ALWAYS;
+    if (strcmp(color, "never") == 0) return KRITIC_COLOR_NEVER;
+
+    fprintf(stderr, "[      ] Error: Unknown color mode \"%s\", expected auto, always or never\n", color);
+    exit(1);
+}
+
+void kritic_console_init(kritic_runtime_t* runtime) {
+    kritic_console_t* console = &kritic_console_storage;
+    kritic_console_mode_t mode = kritic_console_mode(runtime);
+    kritic_color_mode_t color = kritic_console_color(runtime);
+
+    memset(console, 0, sizeof(kritic_console_t));
+    console->mode = mode;
+
+    bool tty[KRITIC_STREAM_COUNT] = {
+        kritic_console_isatty(stdout) != 0,
+        kritic_console_isatty(stderr) != 0
+    };
+    console->tty = tty[KRITIC_STREAM_STDOUT];
+
+    /* The verbose console has always been colored, logs of the short ones stay plain */
+    if (runtime->output != NULL) {
+        for (uint32_t s = 0; s < KRITIC_STREAM_COUNT; ++s) {
+            runtime->output->strip_color[s] = color == KRITIC_COLOR_NEVER
+                || (color == KRITIC_COLOR_AUTO && mode != KRITIC_CONSOLE_VERBOSE && !tty[s]);
+        }
+    }
+
+    if (mode == KRITIC_CONSOLE_VERBOSE) return;
+
+    /* Captured output of passing tests is not shown either */
+    console->failure_only = runtime->redirect_config.failure_only;
+    runtime->redirect_config.failure_only = true;
+
+    kritic_console_next = runtime->printers;
+    runtime->printers.assert_printer    = &kritic_console_assert_printer;
+    runtime->printers.pre_test_printer  = KRITIC_NOOP(kritic_pre_test_printer_fn);
+    runtime->printers.post_test_printer = &kritic_console_post_test_printer;
+    runtime->printers.summary_printer   = &kritic_console_summary_printer;
+    runtime->printers.init_printer      = KRITIC_NOOP(kritic_init_printer_fn);
+    runtime->printers.stdout_printer    = &kritic_console_stdout_printer;
+    runtime->printers.skip_printer      = &kritic_console_skip_printer;
+    runtime->printers.dep_fail_printer  = &kritic_console_dep_fail_printer;
+    runtime->printers.bench_printer     = KRITIC_NOOP(kritic_bench_printer_fn);
+    runtime->console = console;
+}
+
+void kritic_console_teardown(kritic_runtime_t* runtime) {
+    kritic_console_t* console = runtime->console;
+    if (console == NULL) return;
+
+    runtime->printers = kritic_console_next;
+    runtime->redirect_config.failure_only = console->failure_only;
+    runtime->console = NULL;
+}
@@ -0,0 +1,64 @@
+#ifndef KRITIC_CONSOLE_H
+#define KRITIC_CONSOLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "defaults.h"
+
+/* Redraw interval of the status line on a terminal */
+#define KRITIC_CONSOLE_REFRESH_NS     100000000ull
+/* Interval of the plain status lines written to logs */
+#define KRITIC_CONSOLE_LOG_REFRESH_NS 1000000000ull
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct kritic_runtime_t;
+
+typedef enum {
+    KRITIC_CONSOLE_VERBOSE = 0,
+    /* Only failures, skips and the summary */
+    KRITIC_CONSOLE_QUIET,
+    /* Like quiet, with a status line that is redrawn while the tests run */
+    KRITIC_CONSOLE_PROGRESS
+} kritic_console_mode_t;
+
+typedef enum {
+    /* Colors unless a quiet or progress console writes somewhere else than a terminal */
+    KRITIC_COLOR_AUTO = 0,
+    KRITIC_COLOR_ALWAYS,
+    KRITIC_COLOR_NEVER
+} kritic_color_mode_t;
+
+typedef struct {
+    kritic_console_mode_t mode;
+    kritic_color_mode_t color;
+} kritic_console_config_t;
+
+typedef struct {
+    kritic_console_mode_t mode;
+    bool tty;
+    /* Test of the last header, printed once the test has something to show */
+    const kritic_test_t* header_test;
+    /* A status line is on screen and has to be cleared before anything else is printed */
+    bool status_drawn;
+    uint64_t next_refresh_ns;
+    uint32_t completed;
+    uint32_t failed;
+    uint32_t skipped;
+    /* Failure-only capture setting before the console changed it */
+    bool failure_only;
+} kritic_console_t;
+
+void kritic_console_set_mode(kritic_console_mode_t mode);
+void kritic_console_set_color(kritic_color_mode_t color);
+void kritic_console_init(struct kritic_runtime_t* runtime);
+void kritic_console_teardown(struct kritic_runtime_t* runtime);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // KRITIC_CONSOLE_H
@@ -28,9 +28,13 @@ void kritic_default_pre_test_printer(kritic_runtime_t* state) {
 void kritic_default_stdout_printer(kritic_runtime_t* state, kritic_redirect_ctx_t* redir_ctx) {
     (void) state;
     if (!redir_ctx->is_part_of_split) {
-        _write(redir_ctx->stdout_copy, "[ \033[34mINFO\033[0m ] ", 18);
+        if (redir_ctx->stream == KRITIC_STREAM_STDERR) {
+            kritic_output_write(KRITIC_STREAM_STDERR, KRITIC_STDERR_LABEL, sizeof(KRITIC_STDERR_LABEL) - 1);
+        } else {
+            kritic_output_write(KRITIC_STREAM_STDOUT, KRITIC_STDOUT_LABEL, sizeof(KRITIC_STDOUT_LABEL) - 1);
+        }
     }
-    _write(redir_ctx->stdout_copy, redir_ctx->string, redir_ctx->length);
+    kritic_output_write(redir_ctx->stream, redir_ctx->string, redir_ctx->length);
 }
 
 void kritic_default_assert_printer(
@@ -111,6 +115,17 @@ void kritic_default_assert_printer(
                     label, ctx->suite, ctx->test, ctx->file, ctx->line);
             break;
 
+        case KRITIC_ASSERT_LATENCY:
+            kritic_error_printerf("%s  %s.%s: %s latency budget exceeded at %s:%d\n",
+                    label, ctx->suite, ctx->test, actual_expr, ctx->file, ctx->line);
+            kritic_error_printerf("[      ]  -> %s = %lldns, budget = %lldns\n", actual_expr, actual, expected);
+            break;
+
+        case KRITIC_ASSERT_CRASH:
+            kritic_error_printerf("%s  %s.%s: snapshot process %s %lld at %s:%d\n",
+                    label, ctx->suite, ctx->test, actual_expr, actual, ctx->file, ctx->line);
+            break;
+
         default:
             kritic_error_printerf("%s  %s.%s: unknown assertion type at %s:%d\n",
                     label, ctx->suite, ctx->test, ctx->file, ctx->line);
@@ -118,6 +133,25 @@ void kritic_default_assert_printer(
     }
 }
 
+/* Last line of the summary, stopping early without failures is not a pass of the whole suite */
+static const char* kritic_default_verdict(const kritic_runtime_t* state) {
+    if (state->fail_count > 0) return "[ \033[1;31m!!!!\033[0m ] Some tests failed!";
+    if (state->not_run_count > 0) return "[ \033[1;33m....\033[0m ] Stopped before all tests ran!";
+    return "[ \033[1;32m****\033[0m ] All tests passed!";
+}
+
+/* Summary lines for tests left out by --fail-fast or --time-budget and passes replayed from the result cache */
+static void kritic_default_not_run(const kritic_runtime_t* state, char* line, size_t size) {
+    int len = 0;
+    line[0] = '\0';
+    if (state->not_run_count > 0) {
+        len = kritic_snprintf(line, size, "[      ]   Not run: \033[33m%u\033[0m\n", state->not_run_count);
+    }
+    if (state->cached_count > 0 && len >= 0 && (size_t) len < size) {
+        kritic_snprintf(line + len, size - (size_t) len, "[      ]   Cached : %u\n", state->cached_count);
+    }
+}
+
 /* Floating point enabled for default printers */
 #ifndef KRITIC_DEFAULT_PRINTERS_NO_FLOAT
 void kritic_default_skip_printer(kritic_runtime_t* state, const kritic_context_t* ctx) {
@@ -154,7 +188,7 @@ void kritic_default_skip_printer(kritic_runtime_t* state, const kritic_context_t
     }
 
     if (len > 0 && len < (int) sizeof(buffer)) {
-        _write(state->redirect->stdout_copy, buffer, (uint32_t) len);
+        kritic_output_write(KRITIC_STREAM_STDOUT, buffer, (size_t) len);
     }
 }
 
@@ -167,16 +201,17 @@ void kritic_default_post_test_printer(kritic_runtime_t* state) {
     const char* color = (failed_asserts > 0) ? "\033[1;31m" : "\033[1;32m";
     const char* label = (failed_asserts > 0) ? "FAIL" : "PASS";
 
-    if (duration_ns == UINT64_MAX) {
-        /* Timer is disabled (or the test ran for 584.5 years) */
-        kritic_printerf("[ %s%s\033[0m ] %s.%s (%s%d\033[0m/%d)\n",
+    if (state->test_state->cached || duration_ns == UINT64_MAX) {
+        /* The pass came from the result cache or the timer is disabled, nothing was timed */
+        kritic_printerf("[ %s%s\033[0m ] %s.%s (%s%d\033[0m/%d)%s\n",
             color,
             label,
             KRITIC_GET_CURRENT_SUITE(),
             KRITIC_GET_CURRENT_TEST(),
             color,
             passed_asserts,
-            total_asserts
+            total_asserts,
+            state->test_state->cached ? " cached" : ""
         );
     } else {
         double duration_ms = (double) duration_ns / 1000000.0;
@@ -212,7 +247,9 @@ void kritic_default_summary_printer(kritic_runtime_t* state) {
     const char* RED    = "\033[31m";
     const char* CYAN   = "\033[36m";
 
-    uint32_t passed = state->test_count - state->fail_count;
+    uint32_t passed = state->test_count - state->fail_count - state->not_run_count;
+    char not_run[128];
+    kritic_default_not_run(state, not_run, sizeof(not_run));
     float pass_rate = state->test_count > 0
         ? 100.0f * (float) passed / (float) state->test_count
         : 0.0f;
@@ -228,6 +265,7 @@ void kritic_default_summary_printer(kritic_runtime_t* state) {
             "[      ]   Total  : %d\n"
             "[      ]   Passed : %s%d%s\n"
             "[      ]   Failed : %s%d%s\n"
+            "%s"
             "[      ]   Rate   : %s%.1f%%%s\n"
             "[      ]\n"
             "%s\n",
@@ -235,10 +273,9 @@ void kritic_default_summary_printer(kritic_runtime_t* state) {
             state->test_count,
             GREEN, passed, RESET,
             RED, state->fail_count, RESET,
+            not_run,
             CYAN, (double) pass_rate, RESET,
-            state->fail_count > 0
-                ? "[ \033[1;31m!!!!\033[0m ] Some tests failed!"
-                : "[ \033[1;32m****\033[0m ] All tests passed!"
+            kritic_default_verdict(state)
         );
     } else {
         double duration_ms = (double) state->duration_ns / 1000000.0;
@@ -250,6 +287,7 @@ void kritic_default_summary_printer(kritic_runtime_t* state) {
             "[      ]   Total  : %d\n"
             "[      ]   Passed : %s%d%s\n"
             "[      ]   Failed : %s%d%s\n"
+            "%s"
             "[      ]   Rate   : %s%.1f%%%s\n"
             "[      ]   Time   : %.3fms\n"
             "[      ]\n"
@@ -258,16 +296,15 @@ void kritic_default_summary_printer(kritic_runtime_t* state) {
             state->test_count,
             GREEN, passed, RESET,
             RED, state->fail_count, RESET,
+            not_run,
             CYAN, (double) pass_rate, RESET,
             duration_ms,
-            state->fail_count > 0
-                ? "[ \033[1;31m!!!!\033[0m ] Some tests failed!"
-                : "[ \033[1;32m****\033[0m ] All tests passed!"
+            kritic_default_verdict(state)
         );
     }
 
     if (len > 0 && len < (int) sizeof(buffer)) {
-        _write(1, buffer, (uint32_t) len);
+        kritic_output_write(KRITIC_STREAM_STDOUT, buffer, (size_t) len);
     }
 }
 
@@ -312,7 +349,7 @@ void kritic_default_skip_printer(kritic_runtime_t* state, const kritic_context_t
     }
 
     if (len > 0 && len < (int) sizeof(buffer)) {
-        _write(state->redirect->stdout_copy, buffer, (uint32_t) len);
+        kritic_output_write(KRITIC_STREAM_STDOUT, buffer, (size_t) len);
     }
 }
 
@@ -326,15 +363,16 @@ void kritic_default_post_test_printer(kritic_runtime_t* state) {
     const char* color = (failed_asserts > 0) ? "\033[1;31m" : "\033[1;32m";
     const char* label = (failed_asserts > 0) ? "FAIL" : "PASS";
 
-    if (duration_ns == UINT64_MAX) {
-        kritic_printerf("[ %s%s\033[0m ] %s.%s (%s%d\033[0m/%d)\n",
+    if (state->test_state->cached || duration_ns == UINT64_MAX) {
+        kritic_printerf("[ %s%s\033[0m ] %s.%s (%s%d\033[0m/%d)%s\n",
             color,
             label,
             KRITIC_GET_CURRENT_SUITE(),
             KRITIC_GET_CURRENT_TEST(),
             color,
             passed_asserts,
-            total_asserts
+            total_asserts,
+            state->test_state->cached ? " cached" : ""
         );
     } else if (duration_ns < 1000) {
         kritic_printerf("[ %s%s\033[0m ] %s.%s (%s%d\033[0m/%d) in less than 1us\n",
@@ -377,7 +415,9 @@ void kritic_default_summary_printer(kritic_runtime_t* state) {
     const char* RED    = "\033[31m";
     const char* CYAN   = "\033[36m";
 
-    uint32_t passed = state->test_count - state->fail_count;
+    uint32_t passed = state->test_count - state->fail_count - state->not_run_count;
+    char not_run[128];
+    kritic_default_not_run(state, not_run, sizeof(not_run));
     uint32_t pass_rate_x10 = (state->test_count > 0)
         ? (1000 * passed) / state->test_count
         : 0;
@@ -395,6 +435,7 @@ void kritic_default_summary_printer(kritic_runtime_t* state) {
             "[      ]   Total  : %d\n"
             "[      ]   Passed : %s%d%s\n"
             "[      ]   Failed : %s%d%s\n"
+            "%s"
             "[      ]   Rate   : %s%d.%d%%%s\n"
             "[      ]\n"
             "%s\n",
@@ -402,10 +443,9 @@ void kritic_default_summary_printer(kritic_runtime_t* state) {
             state->test_count,
             GREEN, passed, RESET,
             RED, state->fail_count, RESET,
+            not_run,
             CYAN, pass_rate_x10 / 10, pass_rate_x10 % 10, RESET,
-            state->fail_count > 0
-                ? "[ \033[1;31m!!!!\033[0m ] Some tests failed!"
-                : "[ \033[1;32m****\033[0m ] All tests passed!"
+            kritic_default_verdict(state)
         );
     } else {
         uint64_t duration_ms = duration_ns / 1000000;
@@ -417,6 +457,7 @@ void kritic_default_summary_printer(kritic_runtime_t* state) {
             "[      ]   Total  : %d\n"
             "[      ]   Passed : %s%d%s\n"
             "[      ]   Failed : %s%d%s\n"
+            "%s"
             "[      ]   Rate   : %s%d.%d%%%s\n"
             "[      ]   Time   : %" PRIu64 "ms\n"
             "[      ]\n"
@@ -425,16 +466,15 @@ void kritic_default_summary_printer(kritic_runtime_t* state) {
             state->test_count,
             GREEN, passed, RESET,
             RED, state->fail_count, RESET,
+            not_run,
             CYAN, pass_rate_x10 / 10, pass_rate_x10 % 10, RESET,
             duration_ms,
-            state->fail_count > 0
-                ? "[ \033[1;31m!!!!\033[0m ] Some tests failed!"
-                : "[ \033[1;32m****\033[0m ] All tests passed!"
+            kritic_default_verdict(state)
         );
     }
 
     if (len > 0 && len < (int) sizeof(buffer)) {
-        _write(1, buffer, (uint32_t) len);
+        kritic_output_write(KRITIC_STREAM_STDOUT, buffer, (size_t) len);
     }
 }
 
@@ -445,3 +485,88 @@ void kritic_default_dep_fail_printer(kritic_runtime_t* state, kritic_test_t* tes
     kritic_printerf("[ SKIP ] Test \"%s.%s\" at %s:%d is being skipped because underlying dependency \"%s.%s\" failed\n",
         test->suite, test->name, test->file, test->line, dep_test->suite, dep_test->name);
 }
+
+static const char* kritic_bench_state_name(kritic_bench_state_t state, const char* on, const char* off) {
+    switch (state) {
+        case KRITIC_BENCH_STATE_ON:  return on;
+        case KRITIC_BENCH_STATE_OFF: return off;
+        case KRITIC_BENCH_STATE_UNKNOWN:
+        default:                     return "unknown";
+    }
+}
+
+#ifdef KRITIC_DEFAULT_PRINTERS_NO_FLOAT
+/* Ratio rounded to hundredths, printed as fixed point so no float formatting gets linked in */
+static uint64_t kritic_default_ratio_x100(double ratio) {
+    if (!(ratio > 0.0)) return 0;
+    return (uint64_t) (ratio * 100.0 + 0.5);
+}
+#endif // KRITIC_DEFAULT_PRINTERS_NO_FLOAT
+
+void kritic_default_bench_printer(kritic_runtime_t* state) {
+    const kritic_bench_result_t* bench = &state->test_state->bench;
+    if (bench->samples == 0) return;
+
+    kritic_printerf("[ \033[1;35mBNCH\033[0m ] %s.%s: median %" PRIu64 "ns, mean %" PRIu64 "ns, min %" PRIu64
+        "ns, max %" PRIu64 "ns, mad %" PRIu64 "ns\n",
+        KRITIC_GET_CURRENT_SUITE(),
+        KRITIC_GET_CURRENT_TEST(),
+        bench->median_ns,
+        bench->mean_ns,
+        bench->min_ns,
+        bench->max_ns,
+        bench->mad_ns
+    );
+    kritic_printerf("[      ]  -> %zu samples, %zu outliers rejected, %zu warmup runs\n",
+        bench->samples, bench->outliers, bench->warmup_runs);
+    kritic_printerf("[      ]  -> p50 %" PRIu64 "ns, p90 %" PRIu64 "ns, p99 %" PRIu64 "ns, p99.9 %" PRIu64 "ns, max %" PRIu64
+        "ns over %" PRIu64 " operations\n",
+        bench->p50_ns, bench->p90_ns, bench->p99_ns, bench->p999_ns, bench->p100_ns, bench->operations);
+
+    for (size_t i = 0; i < bench->variant_count; ++i) {
+        const kritic_bench_variant_result_t* variant = &bench->variants[i];
+#ifndef KRITIC_DEFAULT_PRINTERS_NO_FLOAT
+        kritic_printerf("[      ]  -> variant %s: median %" PRIu64 "ns, speedup %.2fx (95%% CI %.2fx-%.2fx), %s\n",
+            variant->name, variant->median_ns, variant->speedup, variant->ci_low, variant->ci_high,
+            variant->significant ? "significant" : "not significant");
+#else
+        uint64_t speedup_x100 = kritic_default_ratio_x100(variant->speedup);
+        uint64_t ci_low_x100  = kritic_default_ratio_x100(variant->ci_low);
+        uint64_t ci_high_x100 = kritic_default_ratio_x100(variant->ci_high);
+
+        kritic_printerf("[      ]  -> variant %s: median %" PRIu64 "ns, speedup %" PRIu64 ".%02" PRIu64 "x (95%% CI %"
+            PRIu64 ".%02" PRIu64 "x-%" PRIu64 ".%02" PRIu64 "x), %s\n",
+            variant->name, variant->median_ns,
+            speedup_x100 / 100, speedup_x100 % 100,
+            ci_low_x100 / 100, ci_low_x100 % 100,
+            ci_high_x100 / 100, ci_high_x100 % 100,
+            variant->significant ? "significant" : "not significant");
+#endif // KRITIC_DEFAULT_PRINTERS_NO_FLOAT
+    }
+
+    if (bench->cold_operations > 0) {
+        char eviction[64] = "buffer sweep";
+        if (bench->cold_eviction == KRITIC_EVICT_FLUSH) {
+            kritic_snprintf(eviction, sizeof(eviction), "flushed %zu bytes", bench->working_set_bytes);
+        }
+
+        kritic_printerf("[      ]  -> cold (%s): p50 %" PRIu64 "ns, p90 %" PRIu64 "ns, p99 %" PRIu64 "ns, max %" PRIu64
+            "ns over %" PRIu64 " operations\n",
+            eviction, bench->cold_p50_ns, bench->cold_p90_ns, bench->cold_p99_ns, bench->cold_p100_ns,
+            bench->cold_operations);
+    }
+
+    if (bench->env.low_noise) {
+        char cpu[32] = "unpinned";
+        if (bench->env.pinned_cpu >= 0) {
+            kritic_snprintf(cpu, sizeof(cpu), "pinned to %d", bench->env.pinned_cpu);
+        }
+
+        kritic_printerf("[      ]  -> cpu: %s, priority: %s, governor: %s, turbo: %s\n",
+            cpu,
+            bench->env.priority_raised ? "raised" : "default",
+            kritic_bench_state_name(bench->env.performance_governor, "performance", "other"),
+            kritic_bench_state_name(bench->env.turbo, "on", "off")
+        );
+    }
+}
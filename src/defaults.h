@@ -3,6 +3,7 @@
 
 #include "assert_types.h"
 
+#include "output.h"
 #include "scheduler.h"
 #include "redirect.h"
 
@@ -25,6 +26,7 @@ typedef void (*kritic_post_test_printer_fn)(struct kritic_runtime_t* state);
 typedef void (*kritic_stdout_printer_fn)(struct kritic_runtime_t* _, kritic_redirect_ctx_t* redir_ctx);
 typedef void (*kritic_skip_printer_fn)(struct kritic_runtime_t* state, const kritic_context_t* ctx);
 typedef void (*kritic_dep_fail_printer_fn)(struct kritic_runtime_t* state, kritic_test_t* test, kritic_test_t* dep_test);
+typedef void (*kritic_bench_printer_fn)(struct kritic_runtime_t* state);
 
 typedef struct {
     kritic_assert_printer_fn assert_printer;
@@ -35,6 +37,7 @@ typedef struct {
     kritic_stdout_printer_fn stdout_printer;
     kritic_skip_printer_fn skip_printer;
     kritic_dep_fail_printer_fn dep_fail_printer;
+    kritic_bench_printer_fn bench_printer;
 } kritic_printers_t;
 
 void kritic_default_assert_printer(
@@ -53,22 +56,27 @@ void kritic_default_init_printer(struct kritic_runtime_t* state);
 void kritic_default_stdout_printer(struct kritic_runtime_t* _, kritic_redirect_ctx_t* redir_ctx);
 void kritic_default_skip_printer(struct kritic_runtime_t* state, const kritic_context_t* ctx);
 void kritic_default_dep_fail_printer(struct kritic_runtime_t* state, kritic_test_t* test, kritic_test_t* dep_test);
+void kritic_default_bench_printer(struct kritic_runtime_t* state);
+
+/* Prefixes of captured lines, also written by the forwarding fast path in redirect.c */
+#define KRITIC_STDOUT_LABEL "[ \033[34mINFO\033[0m ] "
+#define KRITIC_STDERR_LABEL "[ \033[33mINFO\033[0m ] "
 
 /* These macros are used to print by default, can be overridden */
 #ifndef kritic_error_printer
-#define kritic_error_printer(f) fprintf(stderr, f)
+#define kritic_error_printer(f) kritic_output_printf(KRITIC_STREAM_STDERR, f)
 #endif
 
 #ifndef kritic_error_printerf
-#define kritic_error_printerf(f, ...) fprintf(stderr, f __VA_OPT__(,) __VA_ARGS__)
+#define kritic_error_printerf(f, ...) kritic_output_printf(KRITIC_STREAM_STDERR, f __VA_OPT__(,) __VA_ARGS__)
 #endif
 
 #ifndef kritic_printer
-#define kritic_printer(f) printf(f)
+#define kritic_printer(f) kritic_output_printf(KRITIC_STREAM_STDOUT, f)
 #endif
 
 #ifndef kritic_printerf
-#define kritic_printerf(f, ...) printf(f __VA_OPT__(,) __VA_ARGS__)
+#define kritic_printerf(f, ...) kritic_output_printf(KRITIC_STREAM_STDOUT, f __VA_OPT__(,) __VA_ARGS__)
 #endif
 
 #ifndef kritic_snprintf
@@ -0,0 +1,244 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../kritic.h"
+
+#ifndef _WIN32
+#include <regex.h>
+#endif
+
+/* Tests picked so far, dependencies are appended while walking it */
+typedef struct {
+    kritic_test_t** tests;
+    size_t count;
+    /* Scratch space for "suite.name" */
+    char* name;
+    size_t name_capacity;
+} kritic_filter_selection_t;
+
+static void kritic_filter_add(const char** patterns, uint32_t* count, const char* pattern) {
+    if (*count == KRITIC_MAX_FILTERS) {
+        fprintf(stderr, "[      ] Error: Too many filters, at most %d of each kind are supported\n", KRITIC_MAX_FILTERS);
+        exit(1);
+    }
+    patterns[(*count)++] = pattern;
+}
+
+void kritic_filter_include(const char* glob) {
+    kritic_filter_config_t* config = &kritic_get_runtime_state()->filter_config;
+    kritic_filter_add(config->includes, &config->include_count, glob);
+}
+
+void kritic_filter_include_regex(const char* regex) {
+    kritic_filter_config_t* config = &kritic_get_runtime_state()->filter_config;
+    kritic_filter_add(config->regexes, &config->regex_count, regex);
+}
+
+void kritic_filter_exclude(const char* glob) {
+    kritic_filter_config_t* config = &kritic_get_runtime_state()->filter_config;
+    kritic_filter_add(config->excludes, &config->exclude_count, glob);
+}
+
+bool kritic_filter_active(const kritic_runtime_t* runtime) {
+    const kritic_filter_config_t* config = &runtime->filter_config;
+    return config->include_count > 0 || config->regex_count > 0 || config->exclude_count > 0
+        || (runtime->impact != NULL && !runtime->impact->recording);
+}
+
+/* Shell style matching of the whole string, * matches any run of characters and ? a single one */
+bool kritic_glob_match(const char* pattern, const char* string) {
+    const char* star = NULL;
+    const char* resume = NULL;
+
+    while (*string != '\0') {
+        if (*pattern == '*') {
+            star = pattern++;
+            resume = string;
+        } else if (*pattern == '?' || *pattern == *string) {
+            ++pattern;
+            ++string;
+        } else if (star != NULL) {
+            pattern = star + 1;
+            string = ++resume;
+        } else {
+            return false;
+        }
+    }
+
+    while (*pattern == '*') ++pattern;
+    return *pattern == '\0';
+}
+
+static const char* kritic_filter_full_name(kritic_filter_selection_t* selection, const kritic_test_t* test) {
+    size_t suite_length = strlen(test->suite);
+    size_t name_length = strlen(test->name);
+    size_t needed = suite_length + name_length + 2;
+
+    if (needed > selection->name_capacity) {
+        char* name = realloc(selection->name, needed);
+        if (name == NULL) {
+            fprintf(stderr, "[      ] Error: realloc() failed in kritic_filter_full_name()\n");
+            exit(1);
+        }
+        selection->name = name;
+        selection->name_capacity = needed;
+    }
+
+    memcpy(selection->name, test->suite, suite_length);
+    selection->name[suite_length] = '.';
+    memcpy(selection->name + suite_length + 1, test->name, name_length + 1);
+    return selection->name;
+}
+
+static void kritic_filter_pick(kritic_filter_selection_t* selection, kritic_test_t* test) {
+    if (test->status == KRITIC_QUEUED) return;
+
+    test->status = KRITIC_QUEUED;
+    selection->tests[selection->count++] = test;
+}
+
+/* Suite names cannot contain dots, so a literal part before the first one pins the suite */
+static bool kritic_filter_select_glob(kritic_runtime_t* runtime, kritic_filter_selection_t* selection,
+                                      const char* pattern) {
+    const kritic_index_t* index = &runtime->index;
+    const char* dot = strchr(pattern, '.');
+    bool matched = false;
+    size_t suite_length = dot != NULL ? (size_t) (dot - pattern) : strlen(pattern);
+
+    if (strcspn(pattern, "*?") >= suite_length) {
+        const kritic_index_suite_t* suite = kritic_index_find_suite(index, pattern, suite_length);
+        if (suite == NULL) return false;
+
+        /* A bare suite name selects the whole suite */
+        const char* name = dot != NULL ? dot + 1 : "*";
+        if (strpbrk(name, "*?") == NULL) {
+            kritic_test_t* test = kritic_index_find(index, pattern, suite_length, name, strlen(name));
+            if (test != NULL) kritic_filter_pick(selection, test);
+            return test != NULL;
+        }
+
+        for (uint32_t t = 0; t < suite->count; ++t) {
+            if (kritic_glob_match(name, suite->tests[t]->name)) {
+                kritic_filter_pick(selection, suite->tests[t]);
+                matched = true;
+            }
+        }
+        return matched;
+    }
+
+    for (size_t s = 0; s < index->suite_capacity; ++s) {
+        const kritic_index_suite_t* suite = &index->suites[s];
+        for (uint32_t t = 0; t < suite->count; ++t) {
+            if (kritic_glob_match(pattern, kritic_filter_full_name(selection, suite->tests[t]))) {
+                kritic_filter_pick(selection, suite->tests[t]);
+                matched = true;
+            }
+        }
+    }
+    return matched;
+}
+
+static bool kritic_filter_select_regex(kritic_runtime_t* runtime, kritic_filter_selection_t* selection,
+                                       const char* pattern) {
+#ifdef _WIN32
+    (void) runtime;
+    (void) selection;
+    fprintf(stderr, "[      ] Error: Regular expression filters are not supported on Windows: \"%s\"\n", pattern);
+    exit(1);
+#else // POSIX
+    const kritic_index_t* index = &runtime->index;
+    regex_t regex;
+    bool matched = false;
+
+    int error = regcomp(&regex, pattern, REG_EXTENDED | REG_NOSUB);
+    if (error != 0) {
+        char message[256];
+        regerror(error, &regex, message, sizeof(message));
+        fprintf(stderr, "[      ] Error: Invalid regular expression \"%s\": %s\n", pattern, message);
+        exit(1);
+    }
+
+    /* A regular expression can match anywhere, so every test has to be checked */
+    for (size_t s = 0; s < index->suite_capacity; ++s) {
+        const kritic_index_suite_t* suite = &index->suites[s];
+        for (uint32_t t = 0; t < suite->count; ++t) {
+            if (regexec(&regex, kritic_filter_full_name(selection, suite->tests[t]), 0, NULL, 0) == 0) {
+                kritic_filter_pick(selection, suite->tests[t]);
+                matched = true;
+            }
+        }
+    }
+    regfree(&regex);
+    return matched;
+#endif // POSIX
+}
+
+/* Excluded tests and tests the impact index shows to be unaffected by the changed files are dropped */
+static void kritic_filter_apply_excludes(const kritic_runtime_t* runtime, kritic_filter_selection_t* selection) {
+    const kritic_filter_config_t* config = &runtime->filter_config;
+    size_t kept = 0;
+
+    for (size_t i = 0; i < selection->count; ++i) {
+        kritic_test_t* test = selection->tests[i];
+        const char* name = kritic_filter_full_name(selection, test);
+        bool excluded = !kritic_impact_affected(runtime->impact, test);
+
+        for (uint32_t e = 0; e < config->exclude_count && !excluded; ++e) {
+            excluded = kritic_glob_match(config->excludes[e], name);
+        }
+
+        if (excluded) {
+            test->status = KRITIC_REGISTERED;
+        } else {
+            selection->tests[kept++] = test;
+        }
+    }
+    selection->count = kept;
+}
+
+/* Mark the tests to run as queued, dependencies of selected tests are pulled in even if excluded */
+void kritic_filter_select(kritic_runtime_t* runtime) {
+    kritic_filter_config_t* config = &runtime->filter_config;
+    const kritic_index_t* index = &runtime->index;
+    kritic_filter_selection_t selection = { 0 };
+
+    selection.tests = malloc((index->slot_count + 1) * sizeof(kritic_test_t*));
+    if (selection.tests == NULL) {
+        fprintf(stderr, "[      ] Error: malloc() failed in kritic_filter_select()\n");
+        exit(1);
+    }
+
+    if (config->include_count == 0 && config->regex_count == 0) {
+        kritic_filter_select_glob(runtime, &selection, "*");
+    }
+    /* A pattern that matches nothing is most likely a typo, running the rest would hide it */
+    for (uint32_t i = 0; i < config->include_count; ++i) {
+        if (!kritic_filter_select_glob(runtime, &selection, config->includes[i])) {
+            kritic_error_printerf("[      ] Warning: Filter \"%s\" matches no test\n", config->includes[i]);
+            ++config->unmatched_count;
+        }
+    }
+    for (uint32_t i = 0; i < config->regex_count; ++i) {
+        if (!kritic_filter_select_regex(runtime, &selection, config->regexes[i])) {
+            kritic_error_printerf("[      ] Warning: Regular expression \"%s\" matches no test\n", config->regexes[i]);
+            ++config->unmatched_count;
+        }
+    }
+    kritic_filter_apply_excludes(runtime, &selection);
+
+    for (size_t i = 0; i < selection.count; ++i) {
+        kritic_test_t* test = selection.tests[i];
+        for (size_t d = 0; test->dependencies[d] != NULL; ++d) {
+            const kritic_test_index_t* dep = test->dependencies[d];
+            kritic_test_t* dep_test = kritic_index_find(index, dep->suite, strlen(dep->suite), dep->name,
+                strlen(dep->name));
+
+            /* Unknown dependencies are reported when the queue is sorted */
+            if (dep_test != NULL) kritic_filter_pick(&selection, dep_test);
+        }
+    }
+
+    free(selection.tests);
+    free(selection.name);
+}
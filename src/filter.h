@@ -0,0 +1,38 @@
+#ifndef KRITIC_FILTER_H
+#define KRITIC_FILTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define KRITIC_MAX_FILTERS 32
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct kritic_runtime_t;
+
+/* Patterns on "suite.name", tests matching any include and no exclude are queued */
+typedef struct {
+    const char* includes[KRITIC_MAX_FILTERS];
+    uint32_t include_count;
+    const char* regexes[KRITIC_MAX_FILTERS];
+    uint32_t regex_count;
+    const char* excludes[KRITIC_MAX_FILTERS];
+    uint32_t exclude_count;
+    /* Includes and regular expressions that matched no test, the run fails if there are any */
+    uint32_t unmatched_count;
+} kritic_filter_config_t;
+
+void kritic_filter_include(const char* glob);
+void kritic_filter_include_regex(const char* regex);
+void kritic_filter_exclude(const char* glob);
+bool kritic_filter_active(const struct kritic_runtime_t* runtime);
+void kritic_filter_select(struct kritic_runtime_t* runtime);
+bool kritic_glob_match(const char* pattern, const char* string);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // KRITIC_FILTER_H
@@ -0,0 +1,464 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../kritic.h"
+
+#ifndef _WIN32
+#include <errno.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+/* Fixture of the suite, created on the first hook registered for it */
+static kritic_fixture_t* kritic_fixture_get(const kritic_context_t* ctx) {
+    kritic_fixtures_t* registry = &kritic_get_runtime_state()->fixtures;
+
+    for (size_t f = 0; f < registry->count; ++f) {
+        if (strcmp(registry->fixtures[f].suite, ctx->suite) == 0) return &registry->fixtures[f];
+    }
+
+    if (registry->count == registry->capacity) {
+        registry->capacity = registry->capacity == 0 ? 8 : registry->capacity * 2;
+        kritic_fixture_t* grown = realloc(registry->fixtures, registry->capacity * sizeof(kritic_fixture_t));
+        if (grown == NULL) {
+            fprintf(stderr, "[      ] Error: realloc() failed in kritic_fixture_get()\n");
+            exit(1);
+        }
+        registry->fixtures = grown;
+    }
+
+    kritic_fixture_t* fixture = &registry->fixtures[registry->count++];
+    *fixture = (kritic_fixture_t) { .suite = ctx->suite, .file = ctx->file, .line = ctx->line };
+    return fixture;
+}
+
+void kritic_register_suite_setup(const kritic_context_t* ctx, kritic_suite_setup_fn setup) {
+    kritic_fixture_t* fixture = kritic_fixture_get(ctx);
+    if (fixture->setup != NULL) {
+        fprintf(stderr, "[      ] Error: Setup defined twice for suite \"%s\" in %s:%d\n", ctx->suite, ctx->file,
+            ctx->line);
+        exit(2);
+    }
+    fixture->setup = setup;
+}
+
+void kritic_register_suite_teardown(const kritic_context_t* ctx, kritic_suite_teardown_fn teardown) {
+    kritic_fixture_t* fixture = kritic_fixture_get(ctx);
+    if (fixture->teardown != NULL) {
+        fprintf(stderr, "[      ] Error: Teardown defined twice for suite \"%s\" in %s:%d\n", ctx->suite, ctx->file,
+            ctx->line);
+        exit(2);
+    }
+    fixture->teardown = teardown;
+}
+
+void kritic_register_resource(const kritic_context_t* ctx, kritic_resource_init_fn init, kritic_resource_fini_fn fini) {
+    kritic_resources_t* registry = &kritic_get_runtime_state()->resources;
+
+    for (size_t r = 0; r < registry->count; ++r) {
+        if (strcmp(registry->resources[r].name, ctx->test) == 0) {
+            fprintf(stderr, "[      ] Error: Resource \"%s\" defined twice in %s:%d and %s:%d\n", ctx->test,
+                registry->resources[r].file, registry->resources[r].line, ctx->file, ctx->line);
+            exit(2);
+        }
+    }
+
+    if (registry->count == registry->capacity) {
+        registry->capacity = registry->capacity == 0 ? 8 : registry->capacity * 2;
+        kritic_resource_t* grown = realloc(registry->resources, registry->capacity * sizeof(kritic_resource_t));
+        if (grown == NULL) {
+            fprintf(stderr, "[      ] Error: realloc() failed in kritic_register_resource()\n");
+            exit(1);
+        }
+        registry->resources = grown;
+    }
+
+    registry->resources[registry->count++] = (kritic_resource_t) {
+        .name = ctx->test, .file = ctx->file, .line = ctx->line, .init = init, .fini = fini
+    };
+}
+
+void kritic_register_suite_snapshot(const kritic_context_t* ctx) {
+    kritic_fixture_get(ctx)->snapshot = true;
+}
+
+static int kritic_fixture_compare(const void* a, const void* b) {
+    return strcmp(((const kritic_fixture_t*) a)->suite, ((const kritic_fixture_t*) b)->suite);
+}
+
+static int kritic_resource_compare(const void* a, const void* b) {
+    return strcmp(((const kritic_resource_t*) a)->name, ((const kritic_resource_t*) b)->name);
+}
+
+static kritic_resource_t* kritic_resource_find(kritic_resources_t* registry, const char* name) {
+    if (registry->count == 0) return NULL;
+
+    kritic_resource_t key = { .name = name };
+    return bsearch(&key, registry->resources, registry->count, sizeof(kritic_resource_t), kritic_resource_compare);
+}
+
+/* Count the queued tests of every suite and every resource, the ordering may spread them over the whole queue */
+void kritic_fixture_init(kritic_runtime_t* runtime) {
+    kritic_fixtures_t* registry = &runtime->fixtures;
+    kritic_resources_t* resources = &runtime->resources;
+
+    if (registry->count > 0) {
+        qsort(registry->fixtures, registry->count, sizeof(kritic_fixture_t), kritic_fixture_compare);
+    }
+    if (resources->count > 0) {
+        qsort(resources->resources, resources->count, sizeof(kritic_resource_t), kritic_resource_compare);
+    }
+
+    for (kritic_test_t** t = runtime->queue; *t != NULL; ++t) {
+        if (registry->count > 0) {
+            kritic_fixture_t key = { .suite = (*t)->suite };
+            (*t)->fixture = bsearch(&key, registry->fixtures, registry->count, sizeof(kritic_fixture_t),
+                kritic_fixture_compare);
+            if ((*t)->fixture != NULL) ++(*t)->fixture->remaining;
+        }
+
+        for (size_t r = 0; r < KRITIC_MAX_RESOURCES && (*t)->uses[r] != NULL; ++r) {
+            kritic_resource_t* resource = kritic_resource_find(resources, (*t)->uses[r]);
+            if (resource == NULL) {
+                fprintf(stderr, "[      ] Error: Unknown resource \"%s\" used by test \"%s.%s\" in %s:%d\n",
+                    (*t)->uses[r], (*t)->suite, (*t)->name, (*t)->file, (*t)->line);
+                exit(2);
+            }
+            (*t)->resources[r] = resource;
+            ++resource->remaining;
+        }
+    }
+}
+
+/* Create the resources of the test and set up its suite if this is the first of their tests that runs */
+void kritic_fixture_acquire(kritic_runtime_t* runtime, kritic_test_t* test) {
+    for (size_t r = 0; r < KRITIC_MAX_RESOURCES && test->resources[r] != NULL; ++r) {
+        kritic_resource_t* resource = test->resources[r];
+        if (resource->active) continue;
+
+        kritic_output_flush(runtime);
+        resource->active = true;
+        resource->state = resource->init != NULL ? resource->init() : NULL;
+    }
+
+    kritic_fixture_t* fixture = test->fixture;
+    runtime->fixture = fixture;
+    if (fixture == NULL || fixture->active) return;
+
+    /* Whatever the hook prints comes after what was printed before it */
+    kritic_output_flush(runtime);
+    fixture->active = true;
+    fixture->state = fixture->setup != NULL ? fixture->setup() : NULL;
+}
+
+static void kritic_resource_finish(kritic_runtime_t* runtime, kritic_resource_t* resource) {
+    kritic_output_flush(runtime);
+    if (resource->fini != NULL) resource->fini(resource->state);
+    resource->active = false;
+    resource->state = NULL;
+}
+
+static void kritic_fixture_finish(kritic_runtime_t* runtime, kritic_fixture_t* fixture) {
+    runtime->fixture = fixture;
+    kritic_output_flush(runtime);
+    if (fixture->teardown != NULL) fixture->teardown();
+    fixture->active = false;
+    fixture->state = NULL;
+    runtime->fixture = NULL;
+}
+
+/* Every queued test is released once, whether it ran or not, and the last one tears the suite and resources down */
+void kritic_fixture_release(kritic_runtime_t* runtime, kritic_test_t* test) {
+    kritic_fixture_t* fixture = test->fixture;
+    runtime->fixture = NULL;
+    if (fixture != NULL && --fixture->remaining == 0 && fixture->active) kritic_fixture_finish(runtime, fixture);
+
+    /* The suite's teardown may still use the resources */
+    for (size_t r = 0; r < KRITIC_MAX_RESOURCES && test->resources[r] != NULL; ++r) {
+        kritic_resource_t* resource = test->resources[r];
+        if (--resource->remaining == 0 && resource->active) kritic_resource_finish(runtime, resource);
+    }
+}
+
+/* Tear down what a run that stopped early left set up */
+void kritic_fixture_teardown(kritic_runtime_t* runtime) {
+    kritic_fixtures_t* registry = &runtime->fixtures;
+
+    for (size_t f = 0; f < registry->count; ++f) {
+        if (registry->fixtures[f].active) kritic_fixture_finish(runtime, &registry->fixtures[f]);
+        registry->fixtures[f].remaining = 0;
+    }
+
+    kritic_resources_t* resources = &runtime->resources;
+    for (size_t r = 0; r < resources->count; ++r) {
+        if (resources->resources[r].active) kritic_resource_finish(runtime, &resources->resources[r]);
+        resources->resources[r].remaining = 0;
+    }
+}
+
+void* kritic_suite_state(void) {
+    kritic_runtime_t* runtime = kritic_get_runtime_state();
+    if (runtime->fixture == NULL) {
+        fprintf(stderr, "[      ] Error: KRITIC_SUITE_STATE() used outside of a suite with a KRITIC_SUITE_SETUP()\n");
+        exit(1);
+    }
+    return runtime->fixture->state;
+}
+
+void* kritic_resource_state(const char* name) {
+    kritic_resource_t* resource = kritic_resource_find(&kritic_get_runtime_state()->resources, name);
+    if (resource == NULL || !resource->active) {
+        fprintf(stderr, "[      ] Error: KRITIC_RESOURCE_GET(%s) used outside of a test with KRITIC_USES(%s)\n", name,
+            name);
+        exit(1);
+    }
+    return resource->state;
+}
+
+/* Benchmarks report their samples in the runner and coverage is recorded in the runner, so those tests never fork */
+bool kritic_fixture_snapshot(const kritic_runtime_t* runtime, const kritic_test_t* test) {
+#ifdef _WIN32
+    (void) runtime;
+    (void) test;
+    return false;
+#else // POSIX
+    return test->fixture != NULL && test->fixture->snapshot && test->benchmark == NULL
+        && (runtime->impact == NULL || !runtime->impact->recording);
+#endif // POSIX
+}
+
+#ifndef _WIN32
+
+typedef enum {
+    KRITIC_FORK_ASSERT = 1,
+    KRITIC_FORK_SKIP,
+    KRITIC_FORK_DONE
+} kritic_fork_record_type_t;
+
+/* Sent by the forked test for every assertion and skip, followed by the strings it points to in its own memory */
+typedef struct {
+    uint32_t type;
+    uint32_t assert_type;
+    int line;
+    bool passed;
+    /* Literals of the test binary, at the same address in both processes */
+    const char* file;
+    const char* actual_expr;
+    const char* expected_expr;
+    long long actual;
+    long long expected;
+    /* Bytes of the string operands or of the skip reason that follow, UINT32_MAX for NULL */
+    uint32_t actual_length;
+    uint32_t expected_length;
+} kritic_fork_record_t;
+
+/* Write end of the pipe in the forked test */
+static int kritic_fork_fd = -1;
+
+static void kritic_fork_write(const void* data, size_t length) {
+    const char* bytes = data;
+    while (length > 0) {
+        ssize_t written = write(kritic_fork_fd, bytes, length);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) _exit(3);
+        bytes += written;
+        length -= (size_t) written;
+    }
+}
+
+static uint32_t kritic_fork_length(const char* string) {
+    return string != NULL ? (uint32_t) strlen(string) : UINT32_MAX;
+}
+
+static void kritic_fork_write_string(const char* string, uint32_t length) {
+    if (string != NULL) kritic_fork_write(string, length);
+}
+
+static void kritic_fork_assert_printer(
+    const kritic_context_t* ctx,
+    bool passed,
+    long long actual,
+    long long expected,
+    const char* actual_expr,
+    const char* expected_expr,
+    kritic_assert_type_t assert_type
+) {
+    kritic_fork_record_t record = {
+        .type = KRITIC_FORK_ASSERT, .assert_type = (uint32_t) assert_type, .line = ctx->line, .passed = passed,
+        .file = ctx->file, .actual_expr = actual_expr, .expected_expr = expected_expr,
+        .actual = actual, .expected = expected, .actual_length = 0, .expected_length = 0
+    };
+    bool strings = assert_type == KRITIC_ASSERT_EQ_STR || assert_type == KRITIC_ASSERT_NE_STR;
+    const char* actual_s = strings ? (const char*) (uintptr_t) actual : NULL;
+    const char* expected_s = strings ? (const char*) (uintptr_t) expected : NULL;
+
+    if (strings) {
+        record.actual_length = kritic_fork_length(actual_s);
+        record.expected_length = kritic_fork_length(expected_s);
+    }
+    kritic_fork_write(&record, sizeof(record));
+    kritic_fork_write_string(actual_s, record.actual_length);
+    kritic_fork_write_string(expected_s, record.expected_length);
+}
+
+static void kritic_fork_skip_printer(kritic_runtime_t* runtime, const kritic_context_t* ctx) {
+    const char* reason = runtime->test_state->skip_reason;
+    kritic_fork_record_t record = {
+        .type = KRITIC_FORK_SKIP, .line = ctx->line, .file = ctx->file,
+        .actual_length = kritic_fork_length(reason)
+    };
+    kritic_fork_write(&record, sizeof(record));
+    kritic_fork_write_string(reason, record.actual_length);
+}
+
+/* Run the test in the forked process and never return to the run loop */
+static void kritic_fork_child(kritic_runtime_t* runtime, size_t iterations, int fd) {
+    kritic_fork_fd = fd;
+    /* The buffer and its lock are the parent's, a reader thread may have held the lock when we forked */
+    runtime->output = NULL;
+    runtime->printers.assert_printer = &kritic_fork_assert_printer;
+    runtime->printers.skip_printer = &kritic_fork_skip_printer;
+
+    for (size_t i = 0; i < iterations; i++) {
+        runtime->test_state->test->fn();
+        ++runtime->test_state->iteration;
+    }
+
+    kritic_fork_record_t done = { .type = KRITIC_FORK_DONE };
+    kritic_fork_write(&done, sizeof(done));
+    fflush(NULL);
+    _exit(0);
+}
+
+static bool kritic_fork_read(int fd, void* data, size_t length) {
+    char* bytes = data;
+    while (length > 0) {
+        ssize_t got = read(fd, bytes, length);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        bytes += got;
+        length -= (size_t) got;
+    }
+    return true;
+}
+
+/* NULL for UINT32_MAX, otherwise the next length bytes of the pipe in a buffer that lives until the next call */
+static bool kritic_fork_read_string(int fd, uint32_t length, char** buffer, size_t* capacity, const char** string) {
+    *string = NULL;
+    if (length == UINT32_MAX) return true;
+
+    if ((size_t) length + 1 > *capacity) {
+        char* grown = realloc(*buffer, (size_t) length + 1);
+        if (grown == NULL) {
+            fprintf(stderr, "[      ] Error: realloc() failed in kritic_fixture_fork()\n");
+            exit(1);
+        }
+        *buffer = grown;
+        *capacity = (size_t) length + 1;
+    }
+    if (!kritic_fork_read(fd, *buffer, length)) return false;
+    (*buffer)[length] = '\0';
+    *string = *buffer;
+    return true;
+}
+
+/* Replay what the forked test reported through the runner's printers, as if the test ran in the runner */
+static bool kritic_fork_replay(kritic_runtime_t* runtime, int fd) {
+    kritic_test_state_t* state = runtime->test_state;
+    static char* strings[2];
+    static size_t capacities[2];
+    kritic_fork_record_t record;
+
+    while (kritic_fork_read(fd, &record, sizeof(record))) {
+        const kritic_context_t ctx = { record.file, state->test->suite, state->test->name, record.line };
+        const char* actual_s;
+        const char* expected_s;
+
+        switch (record.type) {
+            case KRITIC_FORK_ASSERT: {
+                bool strings_follow = record.assert_type == KRITIC_ASSERT_EQ_STR
+                    || record.assert_type == KRITIC_ASSERT_NE_STR;
+                if (strings_follow) {
+                    if (!kritic_fork_read_string(fd, record.actual_length, &strings[0], &capacities[0], &actual_s)
+                        || !kritic_fork_read_string(fd, record.expected_length, &strings[1], &capacities[1],
+                            &expected_s)) {
+                        return false;
+                    }
+                    record.actual = (long long) (uintptr_t) actual_s;
+                    record.expected = (long long) (uintptr_t) expected_s;
+                }
+
+                ++state->assert_count;
+                if (!record.passed) ++state->asserts_failed;
+                runtime->printers.assert_printer(&ctx, record.passed, record.actual, record.expected,
+                    record.actual_expr, record.expected_expr, (kritic_assert_type_t) record.assert_type);
+                break;
+            }
+            case KRITIC_FORK_SKIP:
+                if (!kritic_fork_read_string(fd, record.actual_length, &strings[0], &capacities[0], &actual_s)) {
+                    return false;
+                }
+                state->skipped = true;
+                state->skip_reason = actual_s != NULL ? actual_s : "";
+                runtime->printers.skip_printer(runtime, &ctx);
+                break;
+            case KRITIC_FORK_DONE:
+                return true;
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+#endif // POSIX
+
+/* Setup ran once in the runner, each test gets a copy-on-write snapshot of it and reports back over a pipe */
+void kritic_fixture_fork(kritic_runtime_t* runtime, size_t iterations) {
+#ifdef _WIN32
+    (void) runtime;
+    (void) iterations;
+#else // POSIX
+    kritic_test_state_t* state = runtime->test_state;
+    int fds[2];
+
+    if (pipe(fds) != 0) {
+        fprintf(stderr, "[      ] Error: pipe() failed in kritic_fixture_fork()\n");
+        exit(1);
+    }
+    /* Anything still buffered would be written twice */
+    fflush(NULL);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        fprintf(stderr, "[      ] Error: fork() failed in kritic_fixture_fork()\n");
+        exit(1);
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        kritic_fork_child(runtime, iterations, fds[1]);
+    }
+
+    close(fds[1]);
+    bool finished = kritic_fork_replay(runtime, fds[0]);
+    close(fds[0]);
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+    state->iteration = iterations;
+
+    if (finished && WIFEXITED(status) && WEXITSTATUS(status) == 0) return;
+
+    /* Reported as a failed assertion at the test, so the test fails like it would have in the runner and every
+     * printer records why */
+    const kritic_context_t ctx = { state->test->file, state->test->suite, state->test->name, state->test->line };
+    bool signaled = WIFSIGNALED(status);
+    long long code = signaled ? WTERMSIG(status) : WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+
+    ++state->assert_count;
+    ++state->asserts_failed;
+    runtime->printers.assert_printer(&ctx, false, code, 0, signaled ? "killed by signal" : "exited with status", NULL,
+        KRITIC_ASSERT_CRASH);
+#endif // POSIX
+}
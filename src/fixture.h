@@ -0,0 +1,123 @@
+#ifndef KRITIC_FIXTURE_H
+#define KRITIC_FIXTURE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "scheduler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct kritic_runtime_t;
+
+typedef void* (*kritic_suite_setup_fn)(void);
+typedef void (*kritic_suite_teardown_fn)(void);
+typedef void* (*kritic_resource_init_fn)(void);
+typedef void (*kritic_resource_fini_fn)(void* state);
+
+/* State shared by the tests of one suite, set up before its first queued test and torn down after its last */
+typedef struct kritic_fixture_t {
+    const char* suite;
+    const char* file;
+    int line;
+    kritic_suite_setup_fn setup;
+    kritic_suite_teardown_fn teardown;
+    /* What setup returned */
+    void* state;
+    /* Queued tests of the suite that did not finish yet */
+    uint32_t remaining;
+    bool active;
+    /* Every test runs in a forked copy of the process as it was right after setup */
+    bool snapshot;
+} kritic_fixture_t;
+
+typedef struct {
+    /* Sorted by suite once the queue is built, tests point into it from then on */
+    kritic_fixture_t* fixtures;
+    size_t count;
+    size_t capacity;
+} kritic_fixtures_t;
+
+/* State shared by the tests that declare KRITIC_USES() of it, whatever their suite */
+typedef struct kritic_resource_t {
+    const char* name;
+    const char* file;
+    int line;
+    kritic_resource_init_fn init;
+    kritic_resource_fini_fn fini;
+    /* What init returned */
+    void* state;
+    /* Queued tests using the resource that did not finish yet */
+    uint32_t remaining;
+    bool active;
+} kritic_resource_t;
+
+typedef struct {
+    /* Sorted by name once the queue is built */
+    kritic_resource_t* resources;
+    size_t count;
+    size_t capacity;
+} kritic_resources_t;
+
+void kritic_register_suite_setup(const kritic_context_t* ctx, kritic_suite_setup_fn setup);
+void kritic_register_suite_teardown(const kritic_context_t* ctx, kritic_suite_teardown_fn teardown);
+void kritic_fixture_init(struct kritic_runtime_t* runtime);
+void kritic_fixture_acquire(struct kritic_runtime_t* runtime, kritic_test_t* test);
+void kritic_fixture_release(struct kritic_runtime_t* runtime, kritic_test_t* test);
+void kritic_fixture_teardown(struct kritic_runtime_t* runtime);
+void kritic_register_suite_snapshot(const kritic_context_t* ctx);
+bool kritic_fixture_snapshot(const struct kritic_runtime_t* runtime, const kritic_test_t* test);
+void kritic_fixture_fork(struct kritic_runtime_t* runtime, size_t iterations);
+void* kritic_suite_state(void);
+void kritic_register_resource(const kritic_context_t* ctx, kritic_resource_init_fn init, kritic_resource_fini_fn fini);
+void* kritic_resource_state(const char* name);
+
+#define KRITIC_SUITE_SETUP_NAME(suite) kritic_suite_setup_##suite
+#define KRITIC_SUITE_TEARDOWN_NAME(suite) kritic_suite_teardown_##suite
+
+/* Runs once before the first test of the suite, the pointer it returns is what KRITIC_SUITE_STATE() gives */
+#define KRITIC_SUITE_SETUP(suite)                                                                             \
+    static void* KRITIC_SUITE_SETUP_NAME(suite)(void);                                                        \
+    __attribute__((constructor)) static void kritic_register_suite_setup_##suite(void) {                      \
+        static const kritic_context_t ctx = { __FILE__, #suite, "", __LINE__ };                               \
+        kritic_register_suite_setup(&ctx, KRITIC_SUITE_SETUP_NAME(suite));                                    \
+    }                                                                                                         \
+    static void* KRITIC_SUITE_SETUP_NAME(suite)(void)
+
+/* Runs once after the last test of the suite, or at the end of a run that stopped early */
+#define KRITIC_SUITE_TEARDOWN(suite)                                                                          \
+    static void KRITIC_SUITE_TEARDOWN_NAME(suite)(void);                                                      \
+    __attribute__((constructor)) static void kritic_register_suite_teardown_##suite(void) {                   \
+        static const kritic_context_t ctx = { __FILE__, #suite, "", __LINE__ };                               \
+        kritic_register_suite_teardown(&ctx, KRITIC_SUITE_TEARDOWN_NAME(suite));                              \
+    }                                                                                                         \
+    static void KRITIC_SUITE_TEARDOWN_NAME(suite)(void)
+
+/* Runs each test of the suite in a forked process, so tests may change the state setup built without affecting others */
+#define KRITIC_SUITE_SNAPSHOT(suite)                                                                          \
+    __attribute__((constructor)) static void kritic_register_suite_snapshot_##suite(void) {                   \
+        static const kritic_context_t ctx = { __FILE__, #suite, "", __LINE__ };                               \
+        kritic_register_suite_snapshot(&ctx);                                                                 \
+    }
+
+/* State of the running test's suite, or of the suite being torn down */
+#define KRITIC_SUITE_STATE(_type) ((_type*) kritic_suite_state())
+
+/* Resource created by init just before the first queued test that uses it and passed to fini right after the last */
+#define KRITIC_RESOURCE(_name, _init, _fini)                                                                  \
+    __attribute__((constructor)) static void kritic_register_resource_##_name(void) {                         \
+        static const kritic_context_t ctx = { __FILE__, "", #_name, __LINE__ };                               \
+        kritic_register_resource(&ctx, _init, _fini);                                                         \
+    }
+
+/* What init returned for a resource the running test declared with KRITIC_USES() */
+#define KRITIC_RESOURCE_GET(_type, _name) ((_type*) kritic_resource_state(#_name))
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // KRITIC_FIXTURE_H
@@ -0,0 +1,89 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../kritic.h"
+
+void kritic_histogram_reset(kritic_histogram_t* histogram) {
+    memset(histogram, 0, sizeof(kritic_histogram_t));
+    histogram->min_ns = UINT64_MAX;
+}
+
+static size_t kritic_histogram_index(uint64_t value) {
+    if (value < 2 * KRITIC_HISTOGRAM_HALF_COUNT) return (size_t) value;
+    if (value >> KRITIC_HISTOGRAM_MAX_BITS) return KRITIC_HISTOGRAM_BUCKETS - 1;
+
+    /* Keep the top SUB_BITS bits of the value, the shift selects the power of two range */
+    unsigned shift = (unsigned) (63 - __builtin_clzll(value)) - (KRITIC_HISTOGRAM_SUB_BITS - 1);
+    return (size_t) shift * KRITIC_HISTOGRAM_HALF_COUNT + (size_t) (value >> shift);
+}
+
+/* Largest value that falls into the same bucket as index */
+static uint64_t kritic_histogram_highest(size_t index) {
+    if (index < 2 * KRITIC_HISTOGRAM_HALF_COUNT) return index;
+
+    unsigned shift = (unsigned) (index / KRITIC_HISTOGRAM_HALF_COUNT) - 1;
+    uint64_t sub = (uint64_t) (index - (size_t) shift * KRITIC_HISTOGRAM_HALF_COUNT);
+    return (sub << shift) + ((uint64_t) 1 << shift) - 1;
+}
+
+void kritic_histogram_record(kritic_histogram_t* histogram, uint64_t value_ns) {
+    ++histogram->counts[kritic_histogram_index(value_ns)];
+    ++histogram->total;
+    histogram->sum_ns += value_ns;
+    if (value_ns < histogram->min_ns) histogram->min_ns = value_ns;
+    if (value_ns > histogram->max_ns) histogram->max_ns = value_ns;
+}
+
+/* Value at or below which the given percentage (0-100) of the recorded values fall */
+uint64_t kritic_histogram_percentile(const kritic_histogram_t* histogram, double percentile) {
+    if (histogram->total == 0) return 0;
+    if (percentile >= 100.0) return histogram->max_ns;
+
+    double exact = (percentile / 100.0) * (double) histogram->total;
+    uint64_t target = (uint64_t) exact;
+    if ((double) target < exact || target == 0) ++target;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < KRITIC_HISTOGRAM_BUCKETS; ++i) {
+        seen += histogram->counts[i];
+        if (seen < target) continue;
+
+        uint64_t value = kritic_histogram_highest(i);
+        return value < histogram->max_ns ? value : histogram->max_ns;
+    }
+
+    return histogram->max_ns;
+}
+
+/* Write the cumulative distribution in the HdrHistogram percentile format, ready for plotting */
+bool kritic_histogram_export(const kritic_histogram_t* histogram, const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) return false;
+
+    fprintf(file, "%12s %14s %10s %14s\n\n", "Value", "Percentile", "TotalCount", "1/(1-Percentile)");
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < KRITIC_HISTOGRAM_BUCKETS && seen < histogram->total; ++i) {
+        if (histogram->counts[i] == 0) continue;
+        seen += histogram->counts[i];
+
+        uint64_t value = kritic_histogram_highest(i);
+        if (value > histogram->max_ns) value = histogram->max_ns;
+
+        double fraction = (double) seen / (double) histogram->total;
+        if (seen < histogram->total) {
+            fprintf(file, "%12" PRIu64 " %14.12f %10" PRIu64 " %14.2f\n", value, fraction, seen, 1.0 / (1.0 - fraction));
+        } else {
+            fprintf(file, "%12" PRIu64 " %14.12f %10" PRIu64 "\n", value, fraction, seen);
+        }
+    }
+
+    uint64_t mean = histogram->total > 0 ? histogram->sum_ns / histogram->total : 0;
+    fprintf(file, "#[Mean    = %12" PRIu64 ", Unit           = %12s]\n", mean, "ns");
+    fprintf(file, "#[Max     = %12" PRIu64 ", Total count    = %12" PRIu64 "]\n", histogram->max_ns, histogram->total);
+    fprintf(file, "#[Buckets = %12u, SubBuckets     = %12u]\n",
+        KRITIC_HISTOGRAM_BUCKETS, 2 * KRITIC_HISTOGRAM_HALF_COUNT);
+
+    return fclose(file) == 0;
+}
@@ -0,0 +1,38 @@
+#ifndef KRITIC_HISTOGRAM_H
+#define KRITIC_HISTOGRAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Each power of two range is split into this many linear sub-buckets (< 1.6% relative error) */
+#define KRITIC_HISTOGRAM_SUB_BITS    7
+/* Values up to 2^40ns (~18 minutes) are tracked, larger ones are clamped into the last bucket */
+#define KRITIC_HISTOGRAM_MAX_BITS    40
+#define KRITIC_HISTOGRAM_HALF_COUNT  (1u << (KRITIC_HISTOGRAM_SUB_BITS - 1))
+#define KRITIC_HISTOGRAM_BUCKETS     ((KRITIC_HISTOGRAM_MAX_BITS - KRITIC_HISTOGRAM_SUB_BITS + 2) \
+                                      * KRITIC_HISTOGRAM_HALF_COUNT)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Log-linear (HDR style) latency histogram with fixed memory and O(1) insert */
+typedef struct {
+    uint64_t counts[KRITIC_HISTOGRAM_BUCKETS];
+    uint64_t total;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint64_t sum_ns;
+} kritic_histogram_t;
+
+void kritic_histogram_reset(kritic_histogram_t* histogram);
+void kritic_histogram_record(kritic_histogram_t* histogram, uint64_t value_ns);
+uint64_t kritic_histogram_percentile(const kritic_histogram_t* histogram, double percentile);
+bool kritic_histogram_export(const kritic_histogram_t* histogram, const char* path);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // KRITIC_HISTOGRAM_H
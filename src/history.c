@@ -0,0 +1,245 @@
+/* ftruncate(), pread() and mmap() are not ISO C */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../kritic.h"
+
+void kritic_history_enable(const char* path) {
+    kritic_get_runtime_state()->history_config.path = path;
+}
+
+static const char* kritic_history_path(kritic_runtime_t* runtime) {
+    const char* path_env = getenv("KRITIC_HISTORY");
+    if (path_env != NULL && path_env[0] != '\0') return path_env;
+    return runtime->history_config.path;
+}
+
+/* FNV-1a of "suite.name", never 0 so it cannot be mistaken for a free slot */
+static uint64_t kritic_history_hash(const kritic_test_t* test) {
+    const char* parts[3] = { test->suite, ".", test->name };
+    uint64_t hash = 14695981039346656037ull;
+
+    for (size_t p = 0; p < 3; ++p) {
+        for (const char* c = parts[p]; *c != '\0'; ++c) {
+            hash ^= (uint8_t) *c;
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash != 0 ? hash : 1;
+}
+
+static kritic_history_entry_t* kritic_history_slot(kritic_history_entry_t* entries, uint64_t capacity,
+                                                   uint64_t hash) {
+    uint64_t mask = capacity - 1;
+    uint64_t i = hash & mask;
+
+    while (entries[i].hash != 0 && entries[i].hash != hash) i = (i + 1) & mask;
+    return &entries[i];
+}
+
+/* Averaged duration of the test over the recorded runs, false if it never ran */
+bool kritic_history_duration(const kritic_history_t* history, const kritic_test_t* test, uint64_t* duration_ns) {
+    if (history == NULL) return false;
+
+    const kritic_history_entry_t* entry = kritic_history_slot(history->entries, history->header->capacity,
+        kritic_history_hash(test));
+    if (entry->hash == 0 || entry->runs == 0) return false;
+
+    *duration_ns = entry->duration_ns;
+    return true;
+}
+
+#ifdef _WIN32
+
+void kritic_history_init(kritic_runtime_t* runtime) {
+    if (kritic_history_path(runtime) == NULL) return;
+
+    fprintf(stderr, "[      ] Error: Duration histories are not supported on Windows\n");
+    exit(1);
+}
+
+bool kritic_history_suspect(const kritic_history_t* history, const kritic_test_t* test) {
+    (void) history;
+    (void) test;
+    return false;
+}
+
+void kritic_history_record(kritic_runtime_t* runtime, const kritic_test_t* test) {
+    (void) runtime;
+    (void) test;
+}
+
+void kritic_history_teardown(kritic_runtime_t* runtime) {
+    (void) runtime;
+}
+
+#else // POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static kritic_history_t kritic_history_storage;
+
+/* Tests of one file register next to each other, so remembering the last file saves most stat() calls */
+static int64_t kritic_history_mtime(const char* path) {
+    static const char* last_path = NULL;
+    static int64_t last_mtime = 0;
+    struct stat info;
+
+    if (path == last_path) return last_mtime;
+    last_path = path;
+    last_mtime = stat(path, &info) == 0 ? (int64_t) info.st_mtime : 0;
+    return last_mtime;
+}
+
+static void kritic_history_map(kritic_history_t* history, uint64_t capacity, bool resize) {
+    size_t size = sizeof(kritic_history_header_t) + (size_t) capacity * sizeof(kritic_history_entry_t);
+
+    if (resize && ftruncate(history->fd, (off_t) size) != 0) {
+        perror("ftruncate failed");
+        exit(1);
+    }
+
+    void* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, history->fd, 0);
+    if (map == MAP_FAILED) {
+        perror("mmap failed");
+        exit(1);
+    }
+
+    history->map = map;
+    history->size = size;
+    history->header = (kritic_history_header_t*) map;
+    history->entries = (kritic_history_entry_t*) (history->map + sizeof(kritic_history_header_t));
+}
+
+/* A history written by another version is dropped, it only ever makes the order better */
+static bool kritic_history_valid(int fd) {
+    struct stat info;
+    kritic_history_header_t header;
+
+    if (fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(header)) return false;
+    if (pread(fd, &header, sizeof(header), 0) != (ssize_t) sizeof(header)) return false;
+
+    return memcmp(header.magic, KRITIC_HISTORY_MAGIC, sizeof(header.magic)) == 0
+        && header.version == KRITIC_HISTORY_VERSION
+        && header.header_size == sizeof(kritic_history_header_t)
+        && header.capacity > 0 && (header.capacity & (header.capacity - 1)) == 0
+        && (uint64_t) info.st_size == sizeof(header) + header.capacity * sizeof(kritic_history_entry_t);
+}
+
+static void kritic_history_reset(kritic_history_t* history, uint64_t capacity) {
+    kritic_history_map(history, capacity, true);
+    memset(history->map, 0, history->size);
+    memcpy(history->header->magic, KRITIC_HISTORY_MAGIC, sizeof(history->header->magic));
+    history->header->version = KRITIC_HISTORY_VERSION;
+    history->header->header_size = sizeof(kritic_history_header_t);
+    history->header->capacity = capacity;
+}
+
+/* Double the table, the entries are rehashed through a copy since the mapping moves */
+static void kritic_history_grow(kritic_history_t* history) {
+    uint64_t capacity = history->header->capacity;
+    uint64_t count = history->header->count;
+    kritic_history_entry_t* entries = malloc((size_t) capacity * sizeof(kritic_history_entry_t));
+    if (entries == NULL) {
+        fprintf(stderr, "[      ] Error: malloc() failed in kritic_history_grow()\n");
+        exit(1);
+    }
+
+    memcpy(entries, history->entries, (size_t) capacity * sizeof(kritic_history_entry_t));
+    munmap(history->map, history->size);
+    kritic_history_reset(history, capacity * 2);
+
+    for (uint64_t i = 0; i < capacity; ++i) {
+        if (entries[i].hash == 0) continue;
+        *kritic_history_slot(history->entries, capacity * 2, entries[i].hash) = entries[i];
+    }
+    history->header->count = count;
+    free(entries);
+}
+
+void kritic_history_init(kritic_runtime_t* runtime) {
+    kritic_history_t* history = &kritic_history_storage;
+    const char* path = kritic_history_path(runtime);
+    if (path == NULL || runtime->history != NULL) return;
+
+    memset(history, 0, sizeof(kritic_history_t));
+    history->fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (history->fd == -1) {
+        fprintf(stderr, "[      ] Error: Could not open duration history \"%s\"\n", path);
+        exit(1);
+    }
+
+    if (kritic_history_valid(history->fd)) {
+        kritic_history_header_t header;
+        if (pread(history->fd, &header, sizeof(header), 0) != (ssize_t) sizeof(header)) {
+            fprintf(stderr, "[      ] Error: Could not read duration history \"%s\"\n", path);
+            exit(1);
+        }
+        kritic_history_map(history, header.capacity, false);
+    } else {
+        kritic_history_reset(history, KRITIC_HISTORY_CAPACITY);
+    }
+    runtime->history = history;
+}
+
+/* New tests, tests that failed last time and tests whose source file changed since they last ran */
+bool kritic_history_suspect(const kritic_history_t* history, const kritic_test_t* test) {
+    if (history == NULL || history->header->count == 0) return false;
+
+    const kritic_history_entry_t* entry = kritic_history_slot(history->entries, history->header->capacity,
+        kritic_history_hash(test));
+    if (entry->hash == 0 || entry->failures > 0) return true;
+
+    int64_t mtime = kritic_history_mtime(test->file);
+    return mtime != 0 && entry->source_mtime != 0 && mtime > entry->source_mtime;
+}
+
+/* Every test that got a result is remembered, only tests that ran to the end update the duration */
+void kritic_history_record(kritic_runtime_t* runtime, const kritic_test_t* test) {
+    kritic_history_t* history = runtime->history;
+    if (history == NULL) return;
+
+    uint64_t hash = kritic_history_hash(test);
+    uint64_t duration_ns = runtime->test_state->duration_ns;
+    kritic_history_entry_t* entry = kritic_history_slot(history->entries, history->header->capacity, hash);
+
+    if (entry->hash == 0) {
+        if (2 * (history->header->count + 1) > history->header->capacity) {
+            kritic_history_grow(history);
+            entry = kritic_history_slot(history->entries, history->header->capacity, hash);
+        }
+        *entry = (kritic_history_entry_t) { .hash = hash };
+        ++history->header->count;
+    }
+    entry->source_mtime = kritic_history_mtime(test->file);
+    if (test->status != KRITIC_PASSED && test->status != KRITIC_FAILED) return;
+
+    entry->failures = test->status == KRITIC_FAILED ? entry->failures + 1 : 0;
+    /* A pass replayed from the result cache or a disabled timer says nothing about how long the test takes */
+    if (runtime->test_state->cached || duration_ns == UINT64_MAX) return;
+
+    if (entry->runs > 0) {
+        entry->duration_ns = entry->duration_ns - entry->duration_ns / 4 + duration_ns / 4;
+    } else {
+        entry->duration_ns = duration_ns;
+    }
+    if (entry->runs < UINT32_MAX) ++entry->runs;
+}
+
+void kritic_history_teardown(kritic_runtime_t* runtime) {
+    kritic_history_t* history = runtime->history;
+    if (history == NULL) return;
+
+    munmap(history->map, history->size);
+    if (close(history->fd) != 0) {
+        fprintf(stderr, "[      ] Error: Could not write duration history\n");
+    }
+    runtime->history = NULL;
+}
+
+#endif // POSIX
@@ -0,0 +1,65 @@
+#ifndef KRITIC_HISTORY_H
+#define KRITIC_HISTORY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "scheduler.h"
+
+#define KRITIC_HISTORY_MAGIC    "KRITICHS"
+#define KRITIC_HISTORY_VERSION  2
+/* Slots of a new history file, the table doubles whenever it gets half full */
+#define KRITIC_HISTORY_CAPACITY 256
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct kritic_runtime_t;
+
+/* Start of the file, followed by capacity entries */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t capacity;
+    uint64_t count;
+} kritic_history_header_t;
+
+/* Open addressing slot keyed by the 64-bit FNV-1a hash of "suite.name", hash 0 marks a free slot */
+typedef struct {
+    uint64_t hash;
+    /* Moving average, every run moves it a quarter of the way towards the new duration */
+    uint64_t duration_ns;
+    /* Modification time of the test's source file when it last ran, 0 if it could not be read */
+    int64_t source_mtime;
+    uint32_t runs;
+    /* Runs in a row that failed, 0 after a pass */
+    uint32_t failures;
+} kritic_history_entry_t;
+
+typedef struct {
+    const char* path;
+} kritic_history_config_t;
+
+typedef struct {
+    int fd;
+    char* map;
+    size_t size;
+    kritic_history_header_t* header;
+    kritic_history_entry_t* entries;
+} kritic_history_t;
+
+void kritic_history_enable(const char* path);
+void kritic_history_init(struct kritic_runtime_t* runtime);
+bool kritic_history_duration(const kritic_history_t* history, const kritic_test_t* test, uint64_t* duration_ns);
+bool kritic_history_suspect(const kritic_history_t* history, const kritic_test_t* test);
+void kritic_history_record(struct kritic_runtime_t* runtime, const kritic_test_t* test);
+void kritic_history_teardown(struct kritic_runtime_t* runtime);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // KRITIC_HISTORY_H
@@ -0,0 +1,876 @@
+/* dl_iterate_phdr() is a GNU extension, getline(), mkstemp() and popen() are not ISO C */
+#define _GNU_SOURCE
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../kritic.h"
+
+static kritic_impact_t kritic_impact_storage;
+
+void kritic_impact_record(const char* path) {
+    kritic_get_runtime_state()->impact_config.record_path = path;
+}
+
+void kritic_impact_select(const char* index_path, const char* changed_path) {
+    kritic_impact_config_t* config = &kritic_get_runtime_state()->impact_config;
+    config->index_path = index_path;
+    config->changed_path = changed_path;
+}
+
+/* The API and command line win over the environment */
+static const char* kritic_impact_setting(const char* value, const char* name) {
+    if (value != NULL) return value;
+
+    const char* env = getenv(name);
+    return env != NULL && env[0] != '\0' ? env : NULL;
+}
+
+static char* kritic_impact_read(const char* path, const char* what) {
+    bool from_stdin = strcmp(path, "-") == 0;
+    FILE* file = from_stdin ? stdin : fopen(path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "[      ] Error: Could not open %s \"%s\"\n", what, path);
+        exit(1);
+    }
+
+    size_t length = 0, capacity = 4096;
+    char* data = malloc(capacity);
+    while (data != NULL) {
+        length += fread(data + length, 1, capacity - length - 1, file);
+        if (length < capacity - 1) break;
+
+        capacity *= 2;
+        char* grown = realloc(data, capacity);
+        if (grown == NULL) free(data);
+        data = grown;
+    }
+
+    if (data == NULL || ferror(file)) {
+        fprintf(stderr, "[      ] Error: Could not read %s \"%s\"\n", what, path);
+        exit(1);
+    }
+    data[length] = '\0';
+    if (!from_stdin) fclose(file);
+    return data;
+}
+
+/* Next line of the buffer, terminated in place without its line ending, NULL at the end */
+static char* kritic_impact_line(char** cursor) {
+    char* line = *cursor;
+    if (*line == '\0') return NULL;
+
+    char* end = line + strcspn(line, "\n");
+    *cursor = *end == '\n' ? end + 1 : end;
+    if (end > line && end[-1] == '\r') --end;
+    *end = '\0';
+    return line;
+}
+
+static const char* kritic_impact_strip_dot(const char* path) {
+    while (strncmp(path, "./", 2) == 0) path += 2;
+    return path;
+}
+
+/* Equal paths, or one of them with more leading directories, since the index has the paths the compiler saw */
+static bool kritic_impact_same_file(const char* indexed, const char* changed) {
+    indexed = kritic_impact_strip_dot(indexed);
+    size_t indexed_length = strlen(indexed);
+    size_t changed_length = strlen(changed);
+    if (indexed_length == changed_length) return strcmp(indexed, changed) == 0;
+
+    const char* longer = indexed_length > changed_length ? indexed : changed;
+    const char* shorter = indexed_length > changed_length ? changed : indexed;
+    size_t extra = indexed_length > changed_length ? indexed_length - changed_length : changed_length - indexed_length;
+    return longer[extra - 1] == '/' && strcmp(longer + extra, shorter) == 0;
+}
+
+/* Whether the space separated list has the function */
+static bool kritic_impact_has_function(const char* functions, const char* function) {
+    size_t length = strlen(function);
+
+    for (const char* f = functions + strspn(functions, " "); *f != '\0'; f += strspn(f, " ")) {
+        size_t token = strcspn(f, " ");
+        if (token == length && strncmp(f, function, length) == 0) return true;
+        f += token;
+    }
+    return false;
+}
+
+static void kritic_impact_add_change(kritic_impact_t* impact, size_t* capacity, const char* path,
+                                     const char* function) {
+    if (impact->change_count == *capacity) {
+        *capacity = *capacity == 0 ? 16 : *capacity * 2;
+        kritic_impact_change_t* grown = realloc(impact->changes, *capacity * sizeof(kritic_impact_change_t));
+        if (grown == NULL) {
+            fprintf(stderr, "[      ] Error: realloc() failed in kritic_impact_add_change()\n");
+            exit(1);
+        }
+        impact->changes = grown;
+    }
+    impact->changes[impact->change_count++] = (kritic_impact_change_t) {
+        .path = kritic_impact_strip_dot(path),
+        .function = function
+    };
+}
+
+/* "file:function" if what follows the last colon is a C identifier, the whole line is the file otherwise */
+static void kritic_impact_split_function(char* line, const char** function) {
+    char* colon = strrchr(line, ':');
+    *function = NULL;
+    if (colon == NULL || colon == line) return;
+
+    const char* name = colon + 1;
+    if (!(name[0] == '_' || (name[0] >= 'a' && name[0] <= 'z') || (name[0] >= 'A' && name[0] <= 'Z'))) return;
+    for (const char* c = name; *c != '\0'; ++c) {
+        if (!(*c == '_' || (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') || (*c >= '0' && *c <= '9'))) return;
+    }
+    *colon = '\0';
+    *function = name;
+}
+
+/* One changed file per line, or the output of diff -u or git diff */
+static void kritic_impact_load_changes(kritic_impact_t* impact, const char* path) {
+    char* data = kritic_impact_read(path, "list of changed files");
+    bool diff = strncmp(data, "diff ", 5) == 0 || strncmp(data, "--- ", 4) == 0 || strstr(data, "\n+++ ") != NULL;
+    size_t capacity = 0;
+    char* cursor = data;
+    char* line;
+
+    impact->changed_data = data;
+    while ((line = kritic_impact_line(&cursor)) != NULL) {
+        if (diff) {
+            char* file = NULL;
+            if (strncmp(line, "--- ", 4) == 0 || strncmp(line, "+++ ", 4) == 0) file = line + 4;
+            else if (strncmp(line, "rename from ", 12) == 0) file = line + 12;
+            else if (strncmp(line, "rename to ", 10) == 0) file = line + 10;
+            if (file == NULL) continue;
+
+            /* Plain diff -u puts a timestamp after a tab, git prefixes both sides with a/ and b/ */
+            file[strcspn(file, "\t")] = '\0';
+            if (strcmp(file, "/dev/null") == 0) continue;
+            if (line[0] != 'r' && (strncmp(file, "a/", 2) == 0 || strncmp(file, "b/", 2) == 0)) file += 2;
+            kritic_impact_add_change(impact, &capacity, file, NULL);
+            continue;
+        }
+
+        line += strspn(line, " \t");
+        line[strcspn(line, "\t")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') continue;
+
+        const char* function;
+        kritic_impact_split_function(line, &function);
+        kritic_impact_add_change(impact, &capacity, line, function);
+    }
+}
+
+static int kritic_impact_compare_entries(const void* a, const void* b) {
+    return strcmp(((const kritic_impact_entry_t*) a)->name, ((const kritic_impact_entry_t*) b)->name);
+}
+
+/* "suite.name" lines, each followed by tab-indented "file<TAB>function function ..." lines of the code it executed */
+static void kritic_impact_load_index(kritic_impact_t* impact, const char* path) {
+    size_t capacity = 0, line_number = 0;
+    char* line;
+
+    impact->index_data = kritic_impact_read(path, "impact index");
+    char* cursor = impact->index_data;
+    while ((line = kritic_impact_line(&cursor)) != NULL) {
+        ++line_number;
+        if (line[0] == '\0' || line[0] == '#') continue;
+
+        if (line[0] != '\t') {
+            if (impact->entry_count == capacity) {
+                capacity = capacity == 0 ? 64 : capacity * 2;
+                kritic_impact_entry_t* grown = realloc(impact->entries, capacity * sizeof(kritic_impact_entry_t));
+                if (grown == NULL) {
+                    fprintf(stderr, "[      ] Error: realloc() failed in kritic_impact_load_index()\n");
+                    exit(1);
+                }
+                impact->entries = grown;
+            }
+            impact->entries[impact->entry_count++] = (kritic_impact_entry_t) { .name = line, .affected = false };
+            continue;
+        }
+
+        if (impact->entry_count == 0) {
+            fprintf(stderr, "[      ] Error: Expected a test before line %zu of \"%s\"\n", line_number, path);
+            exit(1);
+        }
+
+        kritic_impact_entry_t* entry = &impact->entries[impact->entry_count - 1];
+        char* file = line + 1;
+        char* tab = strchr(file, '\t');
+        const char* functions = "";
+        if (tab != NULL) {
+            *tab = '\0';
+            functions = tab + 1;
+        }
+
+        for (size_t c = 0; c < impact->change_count && !entry->affected; ++c) {
+            const kritic_impact_change_t* change = &impact->changes[c];
+            entry->affected = kritic_impact_same_file(file, change->path)
+                && (change->function == NULL || kritic_impact_has_function(functions, change->function));
+        }
+    }
+
+    qsort(impact->entries, impact->entry_count, sizeof(kritic_impact_entry_t), kritic_impact_compare_entries);
+}
+
+/* strcmp() of a "suite.name" key against a test, without building the test's full name */
+static int kritic_impact_compare_name(const char* key, const kritic_test_t* test) {
+    const char* parts[3] = { test->suite, ".", test->name };
+
+    for (size_t p = 0; p < 3; ++p) {
+        for (const char* c = parts[p]; *c != '\0'; ++c, ++key) {
+            if (*key != *c) return (unsigned char) *key - (unsigned char) *c;
+        }
+    }
+    return *key != '\0';
+}
+
+/* Tests the index does not know, such as new ones, and tests whose own file changed always run */
+bool kritic_impact_affected(const kritic_impact_t* impact, const kritic_test_t* test) {
+    if (impact == NULL || impact->recording) return true;
+
+    for (size_t c = 0; c < impact->change_count; ++c) {
+        if (impact->changes[c].function == NULL && kritic_impact_same_file(test->file, impact->changes[c].path)) {
+            return true;
+        }
+    }
+
+    size_t low = 0, high = impact->entry_count;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (kritic_impact_compare_name(impact->entries[middle].name, test) < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low == impact->entry_count || kritic_impact_compare_name(impact->entries[low].name, test) != 0) return true;
+    return impact->entries[low].affected;
+}
+
+static void kritic_impact_record_init(kritic_impact_t* impact, const char* path);
+static void kritic_impact_record_teardown(void);
+
+void kritic_impact_init(kritic_runtime_t* runtime) {
+    const kritic_impact_config_t* config = &runtime->impact_config;
+    const char* record_path = kritic_impact_setting(config->record_path, "KRITIC_IMPACT_RECORD");
+    const char* index_path = kritic_impact_setting(config->index_path, "KRITIC_IMPACT_INDEX");
+    const char* changed_path = kritic_impact_setting(config->changed_path, "KRITIC_IMPACT_CHANGED");
+    kritic_impact_t* impact = &kritic_impact_storage;
+    if (runtime->impact != NULL) return;
+
+    if (record_path != NULL && index_path != NULL) {
+        fprintf(stderr, "[      ] Error: An impact index cannot be recorded and used in the same run\n");
+        exit(1);
+    }
+    if ((index_path == NULL) != (changed_path == NULL) && record_path == NULL) {
+        fprintf(stderr, "[      ] Error: Selecting tests by impact needs both an impact index and the changed files\n");
+        exit(1);
+    }
+    if (record_path == NULL && index_path == NULL) return;
+
+    memset(impact, 0, sizeof(kritic_impact_t));
+    if (record_path != NULL) {
+        kritic_impact_record_init(impact, record_path);
+    } else {
+        kritic_impact_load_changes(impact, changed_path);
+        kritic_impact_load_index(impact, index_path);
+    }
+    runtime->impact = impact;
+}
+
+void kritic_impact_teardown(kritic_runtime_t* runtime) {
+    kritic_impact_t* impact = runtime->impact;
+    if (impact == NULL) return;
+
+    if (impact->recording) kritic_impact_record_teardown();
+    free(impact->changes);
+    free(impact->changed_data);
+    free(impact->entries);
+    free(impact->index_data);
+    runtime->impact = NULL;
+}
+
+#if defined(__linux__)
+#include <link.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/* Program counters remembered per slot, repeats of a recent one are dropped before taking the lock */
+#define KRITIC_IMPACT_SEEN 4096
+
+/* Code one test executed, as ids into the run's table of unique program counters */
+typedef struct {
+    const char* suite;
+    const char* name;
+    uint32_t* pcs;
+    size_t count;
+} kritic_impact_test_t;
+
+/* Loaded object and the load bias that turns its program counters into addresses of the file */
+typedef struct {
+    uintptr_t pc;
+    uintptr_t bias;
+    uintptr_t start;
+    uintptr_t end;
+    const char* path;
+    bool found;
+} kritic_impact_object_t;
+
+typedef struct {
+    const char* path;
+    /* Program counters of the running test, sorted and deduplicated whenever the array fills up */
+    uintptr_t* pcs;
+    size_t pc_count;
+    size_t pc_capacity;
+    pthread_mutex_t lock;
+    /* Every program counter of the run by id, and a hash table of ids + 1 to find them */
+    uintptr_t* unique;
+    size_t unique_count;
+    size_t unique_capacity;
+    uint32_t* slots;
+    size_t slot_capacity;
+    kritic_impact_test_t* tests;
+    size_t test_count;
+    size_t test_capacity;
+} kritic_impact_recorder_t;
+
+/* Interned "file<TAB>function" strings, a table of ids + 1 finds them */
+typedef struct {
+    char** strings;
+    size_t count;
+    size_t capacity;
+    uint32_t* slots;
+    size_t slot_capacity;
+} kritic_impact_strings_t;
+
+static kritic_impact_recorder_t kritic_impact_recorder = { .lock = PTHREAD_MUTEX_INITIALIZER };
+static int kritic_impact_active;
+static uintptr_t kritic_impact_seen[KRITIC_IMPACT_SEEN];
+/* Strings compared by kritic_impact_compare_locations(), qsort() has no context argument */
+static char** kritic_impact_sort_strings;
+
+/* The hook and everything it calls stay uninstrumented, built with trace-pc they would call the hook again */
+#if defined(__has_attribute)
+#if __has_attribute(no_sanitize_coverage)
+#define KRITIC_IMPACT_NO_COVERAGE __attribute__((no_sanitize_coverage))
+#endif
+#endif
+#ifndef KRITIC_IMPACT_NO_COVERAGE
+#define KRITIC_IMPACT_NO_COVERAGE
+#endif
+
+void __sanitizer_cov_trace_pc(void);
+
+KRITIC_IMPACT_NO_COVERAGE static void* kritic_impact_grow(void* array, size_t* capacity, size_t element_size,
+    size_t initial) {
+    *capacity = *capacity == 0 ? initial : *capacity * 2;
+    void* grown = realloc(array, *capacity * element_size);
+    if (grown == NULL) {
+        fprintf(stderr, "[      ] Error: realloc() failed while recording the impact index\n");
+        exit(1);
+    }
+    return grown;
+}
+
+KRITIC_IMPACT_NO_COVERAGE static int kritic_impact_compare_pcs(const void* a, const void* b) {
+    uintptr_t left = *(const uintptr_t*) a;
+    uintptr_t right = *(const uintptr_t*) b;
+    return (left > right) - (left < right);
+}
+
+KRITIC_IMPACT_NO_COVERAGE static size_t kritic_impact_unique(uintptr_t* pcs, size_t count) {
+    size_t kept = 0;
+    if (count == 0) return 0;
+
+    qsort(pcs, count, sizeof(uintptr_t), kritic_impact_compare_pcs);
+    for (size_t i = 0; i < count; ++i) {
+        if (kept == 0 || pcs[kept - 1] != pcs[i]) pcs[kept++] = pcs[i];
+    }
+    return kept;
+}
+
+/* Called by code built with -fsanitize-coverage=trace-pc in every basic block, a sanitizer runtime overrides it */
+__attribute__((weak)) KRITIC_IMPACT_NO_COVERAGE void __sanitizer_cov_trace_pc(void) {
+    if (!__atomic_load_n(&kritic_impact_active, __ATOMIC_RELAXED)) return;
+
+    uintptr_t pc = (uintptr_t) __builtin_return_address(0);
+    size_t seen = (size_t) ((pc ^ (pc >> 12)) & (KRITIC_IMPACT_SEEN - 1));
+    if (__atomic_load_n(&kritic_impact_seen[seen], __ATOMIC_RELAXED) == pc) return;
+    __atomic_store_n(&kritic_impact_seen[seen], pc, __ATOMIC_RELAXED);
+
+    kritic_impact_recorder_t* recorder = &kritic_impact_recorder;
+    pthread_mutex_lock(&recorder->lock);
+    if (recorder->pc_count == recorder->pc_capacity) {
+        recorder->pc_count = kritic_impact_unique(recorder->pcs, recorder->pc_count);
+        if (2 * recorder->pc_count >= recorder->pc_capacity) {
+            recorder->pcs = kritic_impact_grow(recorder->pcs, &recorder->pc_capacity, sizeof(uintptr_t), 4096);
+        }
+    }
+    recorder->pcs[recorder->pc_count++] = pc;
+    pthread_mutex_unlock(&recorder->lock);
+}
+
+static size_t kritic_impact_hash_pc(uintptr_t pc) {
+    uint64_t hash = (uint64_t) pc * 11400714819323198485ull;
+    return (size_t) (hash ^ (hash >> 29));
+}
+
+static uint64_t kritic_impact_hash_string(const char* string) {
+    uint64_t hash = 14695981039346656037ull;
+    for (const char* c = string; *c != '\0'; ++c) {
+        hash ^= (uint8_t) *c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/* Id of a program counter in the run's table, added if the run never reached it before */
+static uint32_t kritic_impact_pc_id(kritic_impact_recorder_t* recorder, uintptr_t pc) {
+    if (2 * (recorder->unique_count + 1) > recorder->slot_capacity) {
+        size_t capacity = recorder->slot_capacity == 0 ? 4096 : recorder->slot_capacity * 2;
+        uint32_t* slots = calloc(capacity, sizeof(uint32_t));
+        if (slots == NULL) {
+            fprintf(stderr, "[      ] Error: calloc() failed while recording the impact index\n");
+            exit(1);
+        }
+        for (size_t id = 0; id < recorder->unique_count; ++id) {
+            size_t s = kritic_impact_hash_pc(recorder->unique[id]) & (capacity - 1);
+            while (slots[s] != 0) s = (s + 1) & (capacity - 1);
+            slots[s] = (uint32_t) id + 1;
+        }
+        free(recorder->slots);
+        recorder->slots = slots;
+        recorder->slot_capacity = capacity;
+    }
+
+    size_t mask = recorder->slot_capacity - 1;
+    size_t s = kritic_impact_hash_pc(pc) & mask;
+    while (recorder->slots[s] != 0 && recorder->unique[recorder->slots[s] - 1] != pc) s = (s + 1) & mask;
+
+    if (recorder->slots[s] == 0) {
+        if (recorder->unique_count == recorder->unique_capacity) {
+            recorder->unique = kritic_impact_grow(recorder->unique, &recorder->unique_capacity, sizeof(uintptr_t),
+                4096);
+        }
+        recorder->unique[recorder->unique_count++] = pc;
+        recorder->slots[s] = (uint32_t) recorder->unique_count;
+    }
+    return recorder->slots[s] - 1;
+}
+
+static uint32_t kritic_impact_intern(kritic_impact_strings_t* strings, const char* file, const char* function) {
+    size_t length = strlen(file) + strlen(function) + 2;
+    char* string = malloc(length);
+    if (string == NULL) {
+        fprintf(stderr, "[      ] Error: malloc() failed while recording the impact index\n");
+        exit(1);
+    }
+    snprintf(string, length, "%s\t%s", file, function);
+
+    if (2 * (strings->count + 1) > strings->slot_capacity) {
+        size_t capacity = strings->slot_capacity == 0 ? 1024 : strings->slot_capacity * 2;
+        uint32_t* slots = calloc(capacity, sizeof(uint32_t));
+        if (slots == NULL) {
+            fprintf(stderr, "[      ] Error: calloc() failed while recording the impact index\n");
+            exit(1);
+        }
+        for (size_t id = 0; id < strings->count; ++id) {
+            size_t s = (size_t) kritic_impact_hash_string(strings->strings[id]) & (capacity - 1);
+            while (slots[s] != 0) s = (s + 1) & (capacity - 1);
+            slots[s] = (uint32_t) id + 1;
+        }
+        free(strings->slots);
+        strings->slots = slots;
+        strings->slot_capacity = capacity;
+    }
+
+    size_t mask = strings->slot_capacity - 1;
+    size_t s = (size_t) kritic_impact_hash_string(string) & mask;
+    while (strings->slots[s] != 0 && strcmp(strings->strings[strings->slots[s] - 1], string) != 0) s = (s + 1) & mask;
+
+    if (strings->slots[s] != 0) {
+        free(string);
+        return strings->slots[s] - 1;
+    }
+    if (strings->count == strings->capacity) {
+        strings->strings = kritic_impact_grow(strings->strings, &strings->capacity, sizeof(char*), 1024);
+    }
+    strings->strings[strings->count++] = string;
+    strings->slots[s] = (uint32_t) strings->count;
+    return strings->slots[s] - 1;
+}
+
+static int kritic_impact_find_object(struct dl_phdr_info* info, size_t size, void* data) {
+    kritic_impact_object_t* object = data;
+    uintptr_t start = UINTPTR_MAX, end = 0;
+    (void) size;
+
+    for (ElfW(Half) p = 0; p < info->dlpi_phnum; ++p) {
+        const ElfW(Phdr)* phdr = &info->dlpi_phdr[p];
+        if (phdr->p_type != PT_LOAD) continue;
+
+        uintptr_t segment = info->dlpi_addr + phdr->p_vaddr;
+        if (segment < start) start = segment;
+        if (segment + phdr->p_memsz > end) end = segment + phdr->p_memsz;
+    }
+    if (object->pc < start || object->pc >= end) return 0;
+
+    /* The main program has no name, /proc has its path */
+    object->path = info->dlpi_name;
+    if (object->path == NULL || object->path[0] == '\0') {
+        static char program[4096];
+        ssize_t length = readlink("/proc/self/exe", program, sizeof(program) - 1);
+        program[length > 0 ? length : 0] = '\0';
+        object->path = program;
+    }
+    object->bias = info->dlpi_addr;
+    object->start = start;
+    object->end = end;
+    object->found = true;
+    return 1;
+}
+
+/* The command with the path in single quotes, quotes inside it closed, escaped and reopened */
+static char* kritic_impact_addr2line_command(const char* object_path, const char* address_path) {
+    size_t length = 64 + 4 * (strlen(object_path) + strlen(address_path));
+    char* command = malloc(length);
+    if (command == NULL) {
+        fprintf(stderr, "[      ] Error: malloc() failed while recording the impact index\n");
+        exit(1);
+    }
+
+    const char* paths[2] = { object_path, address_path };
+    char* out = command + sprintf(command, "addr2line -a -f -i -e ");
+    for (size_t p = 0; p < 2; ++p) {
+        *out++ = '\'';
+        for (const char* c = paths[p]; *c != '\0'; ++c) {
+            if (*c == '\'') {
+                memcpy(out, "'\\''", 4);
+                out += 4;
+            } else {
+                *out++ = *c;
+            }
+        }
+        *out++ = '\'';
+        if (p == 0) out += sprintf(out, " < ");
+    }
+    *out = '\0';
+    return command;
+}
+
+/* Source locations of the object's program counters through addr2line, inlined callers included */
+static void kritic_impact_symbolize_object(const kritic_impact_object_t* object, const uint32_t* pcs, size_t count,
+                                           kritic_impact_strings_t* strings, uint32_t** locations,
+                                           size_t* location_count, size_t* location_capacity) {
+    const kritic_impact_recorder_t* recorder = &kritic_impact_recorder;
+    const char* directory = getenv("TMPDIR");
+    char address_path[4096];
+    snprintf(address_path, sizeof(address_path), "%s/kritic-impact-XXXXXX",
+        directory != NULL && directory[0] != '\0' ? directory : "/tmp");
+
+    int fd = mkstemp(address_path);
+    FILE* addresses = fd != -1 ? fdopen(fd, "w") : NULL;
+    if (addresses == NULL) {
+        fprintf(stderr, "[      ] Error: Could not create a temporary file to record the impact index\n");
+        exit(1);
+    }
+    /* A return address points past the call, one byte back is still inside the block that made it */
+    for (size_t i = 0; i < count; ++i) {
+        fprintf(addresses, "0x%" PRIxPTR "\n", recorder->unique[pcs[i]] - 1 - object->bias);
+    }
+    fclose(addresses);
+
+    char* command = kritic_impact_addr2line_command(object->path, address_path);
+    FILE* output = popen(command, "r");
+    if (output == NULL) {
+        fprintf(stderr, "[      ] Error: Could not run addr2line, it is needed to record the impact index\n");
+        exit(1);
+    }
+
+    char* line = NULL;
+    char* function = NULL;
+    size_t line_capacity = 0;
+    size_t group = 0;
+    ssize_t length;
+    while ((length = getline(&line, &line_capacity, output)) > 0) {
+        if (line[length - 1] == '\n') line[length - 1] = '\0';
+
+        /* -a starts the locations of every address with the address itself */
+        if (strncmp(line, "0x", 2) == 0 && function == NULL) {
+            ++group;
+            continue;
+        }
+        if (function == NULL) {
+            function = strdup(line);
+            if (function == NULL) {
+                fprintf(stderr, "[      ] Error: strdup() failed while recording the impact index\n");
+                exit(1);
+            }
+            continue;
+        }
+
+        /* "file:line", possibly followed by " (discriminator N)" */
+        line[strcspn(line, " ")] = '\0';
+        char* colon = strrchr(line, ':');
+        if (colon != NULL) *colon = '\0';
+        if (group > 0 && group <= count && strcmp(line, "??") != 0) {
+            if (*location_count + 2 > *location_capacity) {
+                *locations = kritic_impact_grow(*locations, location_capacity, sizeof(uint32_t), 4096);
+            }
+            (*locations)[(*location_count)++] = pcs[group - 1];
+            (*locations)[(*location_count)++] = kritic_impact_intern(strings, line,
+                strcmp(function, "??") != 0 ? function : "");
+        }
+        free(function);
+        function = NULL;
+    }
+    free(function);
+    free(line);
+
+    int status = pclose(output);
+    unlink(address_path);
+    free(command);
+    if (status != 0 || group != count) {
+        fprintf(stderr, "[      ] Error: addr2line failed on \"%s\", it is needed to record the impact index\n",
+            object->path);
+        exit(1);
+    }
+}
+
+static int kritic_impact_compare_locations(const void* a, const void* b) {
+    return strcmp(kritic_impact_sort_strings[*(const uint32_t*) a], kritic_impact_sort_strings[*(const uint32_t*) b]);
+}
+
+static int kritic_impact_compare_ids(const void* a, const void* b) {
+    uint32_t left = *(const uint32_t*) a;
+    uint32_t right = *(const uint32_t*) b;
+    return (left > right) - (left < right);
+}
+
+/* Pairs of program counter id and location id, turned into the first location of every program counter */
+static void kritic_impact_group_locations(uint32_t* pairs, size_t pair_count, size_t unique_count, size_t* first,
+                                          uint32_t* location_ids) {
+    memset(first, 0, (unique_count + 1) * sizeof(size_t));
+    for (size_t i = 0; i < pair_count; i += 2) ++first[pairs[i] + 1];
+    for (size_t id = 0; id < unique_count; ++id) first[id + 1] += first[id];
+
+    size_t* next = malloc((unique_count + 1) * sizeof(size_t));
+    if (next == NULL) {
+        fprintf(stderr, "[      ] Error: malloc() failed while recording the impact index\n");
+        exit(1);
+    }
+    memcpy(next, first, (unique_count + 1) * sizeof(size_t));
+    for (size_t i = 0; i < pair_count; i += 2) location_ids[next[pairs[i]]++] = pairs[i + 1];
+    free(next);
+}
+
+static void kritic_impact_write(FILE* file, const kritic_impact_strings_t* strings, const size_t* first,
+                                const uint32_t* location_ids) {
+    const kritic_impact_recorder_t* recorder = &kritic_impact_recorder;
+    uint32_t* locations = NULL;
+    size_t capacity = 0;
+
+    fprintf(file, "# KritiC impact index: \"suite.name\" lines, each followed by tab-indented lines of\n"
+                  "# \"file<TAB>functions\" the test executed when the index was recorded\n");
+    kritic_impact_sort_strings = strings->strings;
+
+    for (size_t t = 0; t < recorder->test_count; ++t) {
+        const kritic_impact_test_t* test = &recorder->tests[t];
+        size_t count = 0;
+
+        for (size_t p = 0; p < test->count; ++p) {
+            size_t pc = test->pcs[p];
+            while (count + (first[pc + 1] - first[pc]) > capacity) {
+                locations = kritic_impact_grow(locations, &capacity, sizeof(uint32_t), 256);
+            }
+            memcpy(locations + count, location_ids + first[pc], (first[pc + 1] - first[pc]) * sizeof(uint32_t));
+            count += first[pc + 1] - first[pc];
+        }
+
+        /* Deduplicate by id, then sort by "file<TAB>function" so the functions of a file come together */
+        qsort(locations, count, sizeof(uint32_t), kritic_impact_compare_ids);
+        size_t kept = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (kept == 0 || locations[kept - 1] != locations[i]) locations[kept++] = locations[i];
+        }
+        qsort(locations, kept, sizeof(uint32_t), kritic_impact_compare_locations);
+
+        fprintf(file, "%s.%s\n", test->suite, test->name);
+        size_t file_length = 0;
+        bool listed = false;
+        for (size_t i = 0; i < kept; ++i) {
+            const char* location = strings->strings[locations[i]];
+            size_t length = strcspn(location, "\t");
+            const char* function = location + length + 1;
+
+            if (i == 0 || length != file_length || strncmp(location, strings->strings[locations[i - 1]], length) != 0) {
+                fprintf(file, "%s\t%.*s\t", i > 0 ? "\n" : "", (int) length, location);
+                file_length = length;
+                listed = false;
+            }
+            if (function[0] != '\0') {
+                fprintf(file, "%s%s", listed ? " " : "", function);
+                listed = true;
+            }
+        }
+        if (kept > 0) fputc('\n', file);
+    }
+    free(locations);
+}
+
+static void kritic_impact_record_init(kritic_impact_t* impact, const char* path) {
+    impact->recording = true;
+    kritic_impact_recorder.path = path;
+}
+
+/* Only the test body is recorded, not the bookkeeping around it */
+void kritic_impact_start(kritic_runtime_t* runtime) {
+    if (runtime->impact == NULL || !runtime->impact->recording) return;
+
+    memset(kritic_impact_seen, 0, sizeof(kritic_impact_seen));
+    __atomic_store_n(&kritic_impact_active, 1, __ATOMIC_RELAXED);
+}
+
+void kritic_impact_stop(kritic_runtime_t* runtime) {
+    kritic_impact_recorder_t* recorder = &kritic_impact_recorder;
+    if (runtime->impact == NULL || !runtime->impact->recording) return;
+
+    __atomic_store_n(&kritic_impact_active, 0, __ATOMIC_RELAXED);
+    pthread_mutex_lock(&recorder->lock);
+    size_t count = kritic_impact_unique(recorder->pcs, recorder->pc_count);
+    uint32_t* ids = malloc((count + 1) * sizeof(uint32_t));
+    if (ids == NULL) {
+        fprintf(stderr, "[      ] Error: malloc() failed while recording the impact index\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < count; ++i) ids[i] = kritic_impact_pc_id(recorder, recorder->pcs[i]);
+
+    if (recorder->test_count == recorder->test_capacity) {
+        recorder->tests = kritic_impact_grow(recorder->tests, &recorder->test_capacity, sizeof(kritic_impact_test_t),
+            64);
+    }
+    recorder->tests[recorder->test_count++] = (kritic_impact_test_t) {
+        .suite = runtime->test_state->test->suite,
+        .name  = runtime->test_state->test->name,
+        .pcs   = ids,
+        .count = count
+    };
+    recorder->pc_count = 0;
+    pthread_mutex_unlock(&recorder->lock);
+}
+
+/* Symbolize every program counter of the run once and write the index, a run that executed no test leaves it alone */
+static void kritic_impact_record_teardown(void) {
+    kritic_impact_recorder_t* recorder = &kritic_impact_recorder;
+    kritic_impact_strings_t strings = { 0 };
+    kritic_impact_object_t* objects = NULL;
+    size_t object_count = 0, object_capacity = 0;
+    uint32_t* pairs = NULL;
+    size_t pair_count = 0, pair_capacity = 0;
+
+    if (recorder->test_count > 0 && recorder->unique_count == 0) {
+        fprintf(stderr, "[      ] Error: No coverage was recorded for the impact index, build the code under test "
+            "with -fsanitize-coverage=trace-pc\n");
+        exit(1);
+    }
+
+    uint32_t* object_of = malloc((recorder->unique_count + 1) * sizeof(uint32_t));
+    uint32_t* pcs = malloc((recorder->unique_count + 1) * sizeof(uint32_t));
+    size_t* first = malloc((recorder->unique_count + 1) * sizeof(size_t));
+    if (object_of == NULL || pcs == NULL || first == NULL) {
+        fprintf(stderr, "[      ] Error: malloc() failed while recording the impact index\n");
+        exit(1);
+    }
+
+    for (size_t id = 0; id < recorder->unique_count; ++id) {
+        uintptr_t pc = recorder->unique[id];
+        size_t o = object_count > 0 && pc >= objects[object_count - 1].start && pc < objects[object_count - 1].end
+            ? object_count - 1 : 0;
+        while (o < object_count && !(pc >= objects[o].start && pc < objects[o].end)) ++o;
+
+        if (o == object_count) {
+            kritic_impact_object_t object = { .pc = pc };
+            dl_iterate_phdr(kritic_impact_find_object, &object);
+            if (!object.found) {
+                object_of[id] = UINT32_MAX;
+                continue;
+            }
+            if (object_count == object_capacity) {
+                objects = kritic_impact_grow(objects, &object_capacity, sizeof(kritic_impact_object_t), 8);
+            }
+            objects[object_count++] = object;
+        }
+        object_of[id] = (uint32_t) o;
+    }
+
+    for (size_t o = 0; o < object_count; ++o) {
+        size_t count = 0;
+        for (size_t id = 0; id < recorder->unique_count; ++id) {
+            if (object_of[id] == o) pcs[count++] = (uint32_t) id;
+        }
+        kritic_impact_symbolize_object(&objects[o], pcs, count, &strings, &pairs, &pair_count, &pair_capacity);
+    }
+
+    uint32_t* location_ids = malloc((pair_count / 2 + 1) * sizeof(uint32_t));
+    if (location_ids == NULL) {
+        fprintf(stderr, "[      ] Error: malloc() failed while recording the impact index\n");
+        exit(1);
+    }
+    kritic_impact_group_locations(pairs, pair_count, recorder->unique_count, first, location_ids);
+
+    if (recorder->test_count > 0) {
+        FILE* file = fopen(recorder->path, "w");
+        if (file == NULL) {
+            fprintf(stderr, "[      ] Error: Could not open impact index \"%s\"\n", recorder->path);
+            exit(1);
+        }
+        kritic_impact_write(file, &strings, first, location_ids);
+        if (fclose(file) != 0) {
+            fprintf(stderr, "[      ] Error: Could not write impact index \"%s\"\n", recorder->path);
+        }
+    }
+
+    for (size_t t = 0; t < recorder->test_count; ++t) free(recorder->tests[t].pcs);
+    for (size_t s = 0; s < strings.count; ++s) free(strings.strings[s]);
+    free(strings.strings);
+    free(strings.slots);
+    free(recorder->tests);
+    free(recorder->pcs);
+    free(recorder->unique);
+    free(recorder->slots);
+    free(objects);
+    free(object_of);
+    free(pcs);
+    free(first);
+    free(pairs);
+    free(location_ids);
+    kritic_impact_recorder = (kritic_impact_recorder_t) { .lock = PTHREAD_MUTEX_INITIALIZER };
+}
+
+#else // Unsupported platform
+
+static void kritic_impact_record_init(kritic_impact_t* impact, const char* path) {
+    (void) impact;
+    fprintf(stderr, "[      ] Error: Recording the impact index \"%s\" is only supported on Linux\n", path);
+    exit(1);
+}
+
+static void kritic_impact_record_teardown(void) {
+}
+
+void kritic_impact_start(kritic_runtime_t* runtime) {
+    (void) runtime;
+}
+
+void kritic_impact_stop(kritic_runtime_t* runtime) {
+    (void) runtime;
+}
+
+#endif // Unsupported platform
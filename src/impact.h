@@ -0,0 +1,57 @@
+#ifndef KRITIC_IMPACT_H
+#define KRITIC_IMPACT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct kritic_runtime_t;
+struct kritic_test_t;
+
+/* Record an index of the code every test executes, or select tests with it; NULL paths fall back to the environment */
+typedef struct {
+    const char* record_path;
+    const char* index_path;
+    /* List of changed files or a unified diff, "-" reads it from stdin */
+    const char* changed_path;
+} kritic_impact_config_t;
+
+/* A changed file, optionally narrowed down to one function with "file:function" */
+typedef struct {
+    const char* path;
+    const char* function;
+} kritic_impact_change_t;
+
+/* Test of the index, affected if it executed changed code when the index was recorded */
+typedef struct {
+    const char* name;
+    bool affected;
+} kritic_impact_entry_t;
+
+typedef struct {
+    bool recording;
+    char* changed_data;
+    kritic_impact_change_t* changes;
+    size_t change_count;
+    char* index_data;
+    /* Sorted by name */
+    kritic_impact_entry_t* entries;
+    size_t entry_count;
+} kritic_impact_t;
+
+void kritic_impact_record(const char* path);
+void kritic_impact_select(const char* index_path, const char* changed_path);
+void kritic_impact_init(struct kritic_runtime_t* runtime);
+bool kritic_impact_affected(const kritic_impact_t* impact, const struct kritic_test_t* test);
+void kritic_impact_start(struct kritic_runtime_t* runtime);
+void kritic_impact_stop(struct kritic_runtime_t* runtime);
+void kritic_impact_teardown(struct kritic_runtime_t* runtime);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // KRITIC_IMPACT_H
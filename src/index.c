@@ -0,0 +1,158 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../kritic.h"
+
+#define KRITIC_INDEX_INITIAL_CAPACITY 64
+
+/* FNV-1a, continued over the separator so "suite.name" hashes in one go from its parts */
+static uint32_t kritic_index_hash(uint32_t hash, const char* data, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= (uint8_t) data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t kritic_index_suite_hash(const char* suite, size_t suite_length) {
+    return kritic_index_hash(2166136261u, suite, suite_length);
+}
+
+static uint32_t kritic_index_test_hash(const char* suite, size_t suite_length, const char* name, size_t name_length) {
+    uint32_t hash = kritic_index_hash(kritic_index_suite_hash(suite, suite_length), ".", 1);
+    return kritic_index_hash(hash, name, name_length);
+}
+
+/* Compare a registered string with a key that is not necessarily terminated */
+static bool kritic_index_equals(const char* string, const char* key, size_t key_length) {
+    return strncmp(string, key, key_length) == 0 && string[key_length] == '\0';
+}
+
+static void* kritic_index_calloc(size_t count, size_t size) {
+    void* memory = calloc(count, size);
+    if (memory == NULL) {
+        fprintf(stderr, "[      ] Error: calloc() failed in the test index\n");
+        exit(1);
+    }
+    return memory;
+}
+
+static void kritic_index_insert_slot(kritic_index_slot_t* slots, size_t capacity, kritic_index_slot_t slot) {
+    size_t mask = capacity - 1;
+    size_t i = slot.hash & mask;
+
+    while (slots[i].test != NULL) i = (i + 1) & mask;
+    slots[i] = slot;
+}
+
+static kritic_index_suite_t* kritic_index_suite_slot(kritic_index_suite_t* suites, size_t capacity, const char* suite,
+                                                     size_t suite_length, uint32_t hash) {
+    size_t mask = capacity - 1;
+    size_t i = hash & mask;
+
+    while (suites[i].suite != NULL) {
+        if (suites[i].hash == hash && kritic_index_equals(suites[i].suite, suite, suite_length)) break;
+        i = (i + 1) & mask;
+    }
+    return &suites[i];
+}
+
+/* Both tables are kept at most half full */
+static void kritic_index_grow(kritic_index_t* index) {
+    if ((index->slot_count + 1) * 2 > index->slot_capacity) {
+        size_t capacity = index->slot_capacity == 0 ? KRITIC_INDEX_INITIAL_CAPACITY : index->slot_capacity * 2;
+        kritic_index_slot_t* slots = kritic_index_calloc(capacity, sizeof(kritic_index_slot_t));
+
+        for (size_t i = 0; i < index->slot_capacity; ++i) {
+            if (index->slots[i].test != NULL) kritic_index_insert_slot(slots, capacity, index->slots[i]);
+        }
+        free(index->slots);
+        index->slots = slots;
+        index->slot_capacity = capacity;
+    }
+
+    if ((index->suite_count + 1) * 2 > index->suite_capacity) {
+        size_t capacity = index->suite_capacity == 0 ? KRITIC_INDEX_INITIAL_CAPACITY : index->suite_capacity * 2;
+        kritic_index_suite_t* suites = kritic_index_calloc(capacity, sizeof(kritic_index_suite_t));
+
+        for (size_t i = 0; i < index->suite_capacity; ++i) {
+            kritic_index_suite_t* old = &index->suites[i];
+            if (old->suite == NULL) continue;
+            *kritic_index_suite_slot(suites, capacity, old->suite, strlen(old->suite), old->hash) = *old;
+        }
+        free(index->suites);
+        index->suites = suites;
+        index->suite_capacity = capacity;
+    }
+}
+
+void kritic_index_add(kritic_index_t* index, kritic_test_t* test) {
+    size_t suite_length = strlen(test->suite);
+    size_t name_length = strlen(test->name);
+
+    kritic_index_grow(index);
+
+    kritic_index_insert_slot(index->slots, index->slot_capacity, (kritic_index_slot_t) {
+        .test = test,
+        .hash = kritic_index_test_hash(test->suite, suite_length, test->name, name_length)
+    });
+    ++index->slot_count;
+
+    uint32_t suite_hash = kritic_index_suite_hash(test->suite, suite_length);
+    kritic_index_suite_t* suite = kritic_index_suite_slot(index->suites, index->suite_capacity, test->suite,
+        suite_length, suite_hash);
+    if (suite->suite == NULL) {
+        *suite = (kritic_index_suite_t) { .suite = test->suite, .hash = suite_hash };
+        ++index->suite_count;
+    }
+
+    if (suite->count == suite->capacity) {
+        suite->capacity = suite->capacity == 0 ? 8 : suite->capacity * 2;
+        kritic_test_t** tests = realloc(suite->tests, suite->capacity * sizeof(kritic_test_t*));
+        if (tests == NULL) {
+            fprintf(stderr, "[      ] Error: realloc() failed in the test index\n");
+            exit(1);
+        }
+        suite->tests = tests;
+    }
+    suite->tests[suite->count++] = test;
+}
+
+/* First test registered as suite.name, NULL if there is none */
+kritic_test_t* kritic_index_find(const kritic_index_t* index, const char* suite, size_t suite_length, const char* name,
+                                 size_t name_length) {
+    if (index->slot_capacity == 0) return NULL;
+
+    uint32_t hash = kritic_index_test_hash(suite, suite_length, name, name_length);
+    size_t mask = index->slot_capacity - 1;
+
+    for (size_t i = hash & mask; index->slots[i].test != NULL; i = (i + 1) & mask) {
+        const kritic_index_slot_t* slot = &index->slots[i];
+        if (slot->hash == hash && kritic_index_equals(slot->test->suite, suite, suite_length)
+            && kritic_index_equals(slot->test->name, name, name_length)) {
+            return slot->test;
+        }
+    }
+    return NULL;
+}
+
+const kritic_index_suite_t* kritic_index_find_suite(const kritic_index_t* index, const char* suite,
+                                                    size_t suite_length) {
+    if (index->suite_capacity == 0) return NULL;
+
+    const kritic_index_suite_t* found = kritic_index_suite_slot(index->suites, index->suite_capacity, suite,
+        suite_length, kritic_index_suite_hash(suite, suite_length));
+    return found->suite != NULL ? found : NULL;
+}
+
+/* The indexed tests are freed with the queue */
+void kritic_index_clear(kritic_index_t* index) {
+    for (size_t i = 0; i < index->suite_capacity; ++i) {
+        free(index->suites[i].tests);
+    }
+    free(index->suites);
+    free(index->slots);
+    memset(index, 0, sizeof(kritic_index_t));
+}
@@ -0,0 +1,49 @@
+#ifndef KRITIC_INDEX_H
+#define KRITIC_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "scheduler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Registered test, looked up by "suite.name" */
+typedef struct {
+    kritic_test_t* test;
+    uint32_t hash;
+} kritic_index_slot_t;
+
+/* Tests of one suite in registration order */
+typedef struct {
+    const char* suite;
+    uint32_t hash;
+    uint32_t count;
+    uint32_t capacity;
+    kritic_test_t** tests;
+} kritic_index_suite_t;
+
+/* Hash tables filled while tests register, so lookups never walk the whole registry */
+typedef struct {
+    kritic_index_slot_t* slots;
+    size_t slot_capacity;
+    size_t slot_count;
+    kritic_index_suite_t* suites;
+    size_t suite_capacity;
+    size_t suite_count;
+} kritic_index_t;
+
+void kritic_index_add(kritic_index_t* index, kritic_test_t* test);
+kritic_test_t* kritic_index_find(const kritic_index_t* index, const char* suite, size_t suite_length, const char* name,
+                                 size_t name_length);
+const kritic_index_suite_t* kritic_index_find_suite(const kritic_index_t* index, const char* suite,
+                                                    size_t suite_length);
+void kritic_index_clear(kritic_index_t* index);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // KRITIC_INDEX_H
@@ -0,0 +1,348 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../kritic.h"
+
+static kritic_junit_t kritic_junit_storage;
+
+void kritic_junit_enable(const char* path) {
+    kritic_get_runtime_state()->junit_config.path = path;
+}
+
+/* Escape text for XML, ANSI escape sequences and other control characters are not allowed in XML 1.0 */
+static void kritic_junit_escape(FILE* file, const char* string, size_t length, bool attribute) {
+    size_t start = 0;
+
+    for (size_t i = 0; i < length; ++i) {
+        unsigned char c = (unsigned char) string[i];
+        const char* entity = NULL;
+
+        switch (c) {
+            case '&': entity = "&amp;"; break;
+            case '<': entity = "&lt;"; break;
+            case '>': entity = "&gt;"; break;
+            case '"': entity = attribute ? "&quot;" : NULL; break;
+            case '\n': entity = attribute ? "&#10;" : NULL; break;
+            case '\t':
+            case '\r':
+                break;
+            default:
+                if (c >= 0x20) break;
+
+                fwrite(string + start, 1, i - start, file);
+                if (c == 0x1b && i + 1 < length && string[i + 1] == '[') {
+                    /* Skip the whole CSI sequence up to its final byte */
+                    for (i += 2; i < length && ((unsigned char) string[i] < 0x40 || (unsigned char) string[i] > 0x7e); ++i);
+                }
+                start = i + 1;
+                continue;
+        }
+
+        if (entity == NULL) continue;
+        fwrite(string + start, 1, i - start, file);
+        fputs(entity, file);
+        start = i + 1;
+    }
+
+    if (start < length) fwrite(string + start, 1, length - start, file);
+}
+
+static void kritic_junit_escape_string(FILE* file, const char* string, bool attribute) {
+    kritic_junit_escape(file, string, strlen(string), attribute);
+}
+
+static FILE* kritic_junit_section(kritic_junit_t* junit, kritic_junit_section_t section) {
+    junit->section_used[section] = true;
+    return junit->sections[section];
+}
+
+/* Copy a section into the report and rewind it for the next test */
+static void kritic_junit_copy_section(kritic_junit_t* junit, kritic_junit_section_t section) {
+    FILE* source = junit->sections[section];
+    char buffer[4096];
+    long remaining = ftell(source);
+
+    rewind(source);
+    while (remaining > 0) {
+        size_t chunk = remaining < (long) sizeof(buffer) ? (size_t) remaining : sizeof(buffer);
+        size_t bytes = fread(buffer, 1, chunk, source);
+        if (bytes == 0) break;
+        fwrite(buffer, 1, bytes, junit->file);
+        remaining -= (long) bytes;
+    }
+
+    rewind(source);
+    junit->section_used[section] = false;
+}
+
+static void kritic_junit_discard_sections(kritic_junit_t* junit) {
+    for (uint32_t s = 0; s < KRITIC_JUNIT_SECTION_COUNT; ++s) {
+        if (junit->section_used[s]) rewind(junit->sections[s]);
+        junit->section_used[s] = false;
+    }
+    junit->failure_message[0] = '\0';
+}
+
+static void kritic_junit_open_testcase(kritic_junit_t* junit, const kritic_test_t* test, uint64_t duration_ns) {
+    FILE* file = junit->file;
+
+    fputs("  <testcase classname=\"", file);
+    kritic_junit_escape_string(file, test->suite, true);
+    fputs("\" name=\"", file);
+    kritic_junit_escape_string(file, test->name, true);
+    fputs("\" file=\"", file);
+    kritic_junit_escape_string(file, test->file, true);
+    if (duration_ns == UINT64_MAX) duration_ns = 0;
+    fprintf(file, "\" line=\"%d\" time=\"%" PRIu64 ".%06" PRIu64 "\"", test->line,
+        duration_ns / 1000000000u, (duration_ns / 1000u) % 1000000u);
+}
+
+/* Describe a failed assertion in one line, without the colors of the console printer */
+static void kritic_junit_describe(char* buffer, size_t size, bool* truncated, long long actual, long long expected,
+                                  const char* actual_expr, const char* expected_expr,
+                                  kritic_assert_type_t assert_type) {
+    int length;
+
+    switch (assert_type) {
+        case KRITIC_ASSERT_EQ_INT:
+            length = kritic_snprintf(buffer, size, "%s == %s failed: %lld != %lld",
+                actual_expr, expected_expr, actual, expected);
+            break;
+        case KRITIC_ASSERT_NE_INT:
+            length = kritic_snprintf(buffer, size, "%s != %s failed: both %lld", actual_expr, expected_expr, actual);
+            break;
+        case KRITIC_ASSERT_EQ_FLOAT:
+        case KRITIC_ASSERT_NE_FLOAT:
+            length = kritic_snprintf(buffer, size, "%s %s %s failed", actual_expr,
+                assert_type == KRITIC_ASSERT_EQ_FLOAT ? "==" : "!=", expected_expr);
+            break;
+        case KRITIC_ASSERT_EQ_STR:
+        case KRITIC_ASSERT_NE_STR: {
+            const char* actual_s = (const char*)(uintptr_t)actual;
+            const char* expected_s = (const char*)(uintptr_t)expected;
+            length = kritic_snprintf(buffer, size, "%s %s %s failed: \"%s\", \"%s\"", actual_expr,
+                assert_type == KRITIC_ASSERT_EQ_STR ? "==" : "!=", expected_expr,
+                actual_s ? actual_s : "(null)", expected_s ? expected_s : "(null)");
+            break;
+        }
+        case KRITIC_ASSERT:
+            length = kritic_snprintf(buffer, size, "assertion failed: %s", actual_expr);
+            break;
+        case KRITIC_ASSERT_NOT:
+            length = kritic_snprintf(buffer, size, "assertion expected to fail: %s", actual_expr);
+            break;
+        case KRITIC_ASSERT_FAIL:
+            length = kritic_snprintf(buffer, size, "%s", "forced failure");
+            break;
+        case KRITIC_ASSERT_LATENCY:
+            length = kritic_snprintf(buffer, size, "%s latency budget exceeded: %lldns > %lldns",
+                actual_expr, actual, expected);
+            break;
+        case KRITIC_ASSERT_CRASH:
+            length = kritic_snprintf(buffer, size, "snapshot process %s %lld", actual_expr, actual);
+            break;
+        default:
+            length = kritic_snprintf(buffer, size, "%s", "unknown assertion type");
+            break;
+    }
+
+    *truncated = length < 0 || (size_t) length >= size;
+}
+
+static void kritic_junit_assert_printer(
+    const kritic_context_t* ctx,
+    bool passed,
+    long long actual,
+    long long expected,
+    const char* actual_expr,
+    const char* expected_expr,
+    kritic_assert_type_t assert_type
+) {
+    kritic_junit_t* junit = &kritic_junit_storage;
+
+    if (!passed) {
+        char message[sizeof(junit->failure_message)];
+        bool truncated;
+        kritic_junit_describe(message, sizeof(message), &truncated, actual, expected, actual_expr, expected_expr,
+            assert_type);
+
+        if (junit->failure_message[0] == '\0') memcpy(junit->failure_message, message, sizeof(message));
+
+        FILE* section = kritic_junit_section(junit, KRITIC_JUNIT_FAILURES);
+        kritic_junit_escape_string(section, message, false);
+        fprintf(section, "%s at ", truncated ? "..." : "");
+        kritic_junit_escape_string(section, ctx->file, false);
+        fprintf(section, ":%d\n", ctx->line);
+    }
+}
+
+/* Called from the redirect reader thread, which only ever touches the output sections */
+static void kritic_junit_stdout_printer(kritic_runtime_t* _, kritic_redirect_ctx_t* redir_ctx) {
+    (void) _;
+    kritic_junit_t* junit = &kritic_junit_storage;
+    kritic_junit_section_t section = redir_ctx->stream == KRITIC_STREAM_STDERR
+        ? KRITIC_JUNIT_SYSTEM_ERR
+        : KRITIC_JUNIT_SYSTEM_OUT;
+
+    kritic_junit_escape(kritic_junit_section(junit, section), redir_ctx->string, redir_ctx->length, false);
+}
+
+static void kritic_junit_pre_test_printer(kritic_runtime_t* state) {
+    (void) state;
+    kritic_junit_discard_sections(&kritic_junit_storage);
+}
+
+static void kritic_junit_post_test_printer(kritic_runtime_t* state) {
+    kritic_junit_t* junit = &kritic_junit_storage;
+    kritic_test_state_t* test_state = state->test_state;
+    const kritic_test_t* test = test_state->test;
+    FILE* file = junit->file;
+
+    ++junit->tests;
+    kritic_junit_open_testcase(junit, test, test_state->duration_ns);
+    if (test->status == KRITIC_PASSED && !junit->section_used[KRITIC_JUNIT_SYSTEM_OUT]
+        && !junit->section_used[KRITIC_JUNIT_SYSTEM_ERR]) {
+        fputs("/>\n", file);
+        kritic_junit_discard_sections(junit);
+        return;
+    }
+    fputs(">\n", file);
+
+    if (test->status == KRITIC_SKIPPED) {
+        ++junit->skipped;
+        fputs("    <skipped message=\"", file);
+        kritic_junit_escape_string(file, test_state->skip_reason, true);
+        fputs("\"/>\n", file);
+    } else if (test->status == KRITIC_FAILED) {
+        ++junit->failures;
+        fputs("    <failure type=\"assertion\" message=\"", file);
+        kritic_junit_escape_string(file, junit->failure_message, true);
+        fputs("\">", file);
+        if (junit->section_used[KRITIC_JUNIT_FAILURES]) kritic_junit_copy_section(junit, KRITIC_JUNIT_FAILURES);
+        fputs("</failure>\n", file);
+    }
+
+    if (junit->section_used[KRITIC_JUNIT_SYSTEM_OUT]) {
+        fputs("    <system-out>", file);
+        kritic_junit_copy_section(junit, KRITIC_JUNIT_SYSTEM_OUT);
+        fputs("</system-out>\n", file);
+    }
+    if (junit->section_used[KRITIC_JUNIT_SYSTEM_ERR]) {
+        fputs("    <system-err>", file);
+        kritic_junit_copy_section(junit, KRITIC_JUNIT_SYSTEM_ERR);
+        fputs("</system-err>\n", file);
+    }
+    fputs("  </testcase>\n", file);
+
+    kritic_junit_discard_sections(junit);
+}
+
+/* Tests skipped because of a failed dependency never run, so no other printer sees them */
+static void kritic_junit_dep_fail_printer(kritic_runtime_t* state, kritic_test_t* test, kritic_test_t* dep_test) {
+    (void) state;
+    kritic_junit_t* junit = &kritic_junit_storage;
+    FILE* file = junit->file;
+
+    ++junit->tests;
+    ++junit->skipped;
+    kritic_junit_open_testcase(junit, test, 0);
+    fputs(">\n    <skipped message=\"dependency ", file);
+    kritic_junit_escape_string(file, dep_test->suite, true);
+    fputc('.', file);
+    kritic_junit_escape_string(file, dep_test->name, true);
+    fputs(" failed\"/>\n  </testcase>\n", file);
+}
+
+/* Only the events the report needs, the others are never dispatched to it */
+static const kritic_printers_t kritic_junit_reporter = {
+    .assert_printer    = &kritic_junit_assert_printer,
+    .stdout_printer    = &kritic_junit_stdout_printer,
+    .pre_test_printer  = &kritic_junit_pre_test_printer,
+    .post_test_printer = &kritic_junit_post_test_printer,
+    .dep_fail_printer  = &kritic_junit_dep_fail_printer
+};
+
+void kritic_junit_init(kritic_runtime_t* runtime) {
+    kritic_junit_t* junit = &kritic_junit_storage;
+    const char* path = runtime->junit_config.path;
+
+    const char* path_env = getenv("KRITIC_JUNIT_OUTPUT");
+    if (path_env != NULL && path_env[0] != '\0') path = path_env;
+    if (path == NULL) return;
+
+    memset(junit, 0, sizeof(kritic_junit_t));
+    junit->file = fopen(path, "w");
+    if (junit->file == NULL) {
+        fprintf(stderr, "[      ] Error: Could not open JUnit report \"%s\"\n", path);
+        exit(1);
+    }
+
+    /* The totals are patched into the root tag at the end, which needs a file that can seek */
+    if (fseek(junit->file, 0, SEEK_SET) != 0) {
+        junit->output = junit->file;
+        junit->file = tmpfile();
+        if (junit->file == NULL) {
+            perror("tmpfile failed");
+            exit(1);
+        }
+    }
+
+    /* tmpfile() is already unlinked, children of the current test never pile up in memory */
+    for (uint32_t s = 0; s < KRITIC_JUNIT_SECTION_COUNT; ++s) {
+        junit->sections[s] = tmpfile();
+        if (junit->sections[s] == NULL) {
+            perror("tmpfile failed");
+            exit(1);
+        }
+    }
+
+    fputs("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuite name=\"KritiC\"", junit->file);
+    junit->totals_offset = ftell(junit->file);
+    fprintf(junit->file, "%*s>\n", KRITIC_JUNIT_TOTALS_SPACE, "");
+
+    kritic_add_reporter(&kritic_junit_reporter);
+    runtime->junit = junit;
+}
+
+void kritic_junit_teardown(kritic_runtime_t* runtime) {
+    kritic_junit_t* junit = runtime->junit;
+    if (junit == NULL) return;
+
+    fputs("</testsuite>\n", junit->file);
+
+    if (junit->totals_offset >= 0 && fseek(junit->file, junit->totals_offset, SEEK_SET) == 0) {
+        char totals[KRITIC_JUNIT_TOTALS_SPACE + 1];
+        uint64_t duration_ns = runtime->duration_ns == UINT64_MAX ? 0 : runtime->duration_ns;
+        int length = kritic_snprintf(totals, sizeof(totals),
+            " tests=\"%u\" failures=\"%u\" errors=\"0\" skipped=\"%u\" time=\"%" PRIu64 ".%06" PRIu64 "\"",
+            junit->tests, junit->failures, junit->skipped,
+            duration_ns / 1000000000u, (duration_ns / 1000u) % 1000000u);
+
+        if (length > 0 && length <= KRITIC_JUNIT_TOTALS_SPACE) fwrite(totals, 1, (size_t) length, junit->file);
+    }
+
+    bool failed = false;
+    if (junit->output != NULL) {
+        char buffer[8192];
+        size_t length;
+
+        rewind(junit->file);
+        while ((length = fread(buffer, 1, sizeof(buffer), junit->file)) > 0) {
+            if (fwrite(buffer, 1, length, junit->output) != length) failed = true;
+        }
+        if (ferror(junit->file)) failed = true;
+        if (fclose(junit->output) != 0) failed = true;
+        junit->output = NULL;
+    }
+    if (fclose(junit->file) != 0 || failed) {
+        fprintf(stderr, "[      ] Error: Could not write JUnit report\n");
+    }
+    for (uint32_t s = 0; s < KRITIC_JUNIT_SECTION_COUNT; ++s) {
+        fclose(junit->sections[s]);
+    }
+
+    kritic_remove_reporter(&kritic_junit_reporter);
+    runtime->junit = NULL;
+}
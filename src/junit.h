@@ -0,0 +1,53 @@
+#ifndef KRITIC_JUNIT_H
+#define KRITIC_JUNIT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* Room left in the root tag for the totals, which are only known at the end of the run */
+#define KRITIC_JUNIT_TOTALS_SPACE 128
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct kritic_runtime_t;
+
+typedef enum {
+    KRITIC_JUNIT_FAILURES = 0,
+    KRITIC_JUNIT_SYSTEM_OUT,
+    KRITIC_JUNIT_SYSTEM_ERR,
+    KRITIC_JUNIT_SECTION_COUNT
+} kritic_junit_section_t;
+
+typedef struct {
+    const char* path;
+} kritic_junit_config_t;
+
+/* Report being written, only the current test is kept around */
+typedef struct {
+    FILE* file;
+    /* Report path when it cannot seek (a pipe), file is then a temporary copied to it at the end */
+    FILE* output;
+    /* Offset of the padding reserved for the totals in the root tag */
+    long totals_offset;
+    /* Children of the current <testcase>, rewound after every test */
+    FILE* sections[KRITIC_JUNIT_SECTION_COUNT];
+    bool section_used[KRITIC_JUNIT_SECTION_COUNT];
+    /* Message attribute of the <failure> element, taken from the first failed assertion */
+    char failure_message[512];
+    uint32_t tests;
+    uint32_t failures;
+    uint32_t skipped;
+} kritic_junit_t;
+
+void kritic_junit_enable(const char* path);
+void kritic_junit_init(struct kritic_runtime_t* runtime);
+void kritic_junit_teardown(struct kritic_runtime_t* runtime);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // KRITIC_JUNIT_H
@@ -9,14 +9,42 @@
 
 static kritic_runtime_t* kritic_runtime_state = &(kritic_runtime_t) {
     .test_state     = NULL,
+    .results        = NULL,
     .redirect       = NULL,
+    .redirect_config = { .failure_only = false },
+    .output         = NULL,
+    .console_config = { .mode = KRITIC_CONSOLE_VERBOSE, .color = KRITIC_COLOR_AUTO },
+    .console        = NULL,
     .first_node     = NULL,
     .last_node      = NULL,
+    .index          = { .slots = NULL, .suites = NULL },
+    .fixtures       = { .fixtures = NULL, .count = 0, .capacity = 0 },
+    .fixture        = NULL,
+    .resources      = { .resources = NULL, .count = 0, .capacity = 0 },
+    .filter_config  = { .include_count = 0, .regex_count = 0, .exclude_count = 0 },
+    .impact_config  = { .record_path = NULL, .index_path = NULL, .changed_path = NULL },
+    .impact         = NULL,
+    .shard_config   = { .index = 0, .count = 0, .timing_path = NULL },
+    .budget_config  = { .max_failures = 0, .time_budget_ns = 0 },
     .queue          = NULL,
     .timer          = { 0 },
     .fail_count     = 0,
+    .not_run_count  = 0,
+    .cached_count   = 0,
     .test_count     = 0,
-    .printers       = { 0 }
+    .printers       = { 0 },
+    .reporters      = NULL,
+    .bench_config   = { .low_noise = false, .cpu = -1, .raise_priority = false, .histogram_dir = NULL },
+    .bench_env      = { 0 },
+    .profiler_config = { .directory = NULL, .frequency_hz = 0 },
+    .junit_config   = { .path = NULL },
+    .junit          = NULL,
+    .binlog_config  = { .path = NULL },
+    .binlog         = NULL,
+    .history_config = { .path = NULL },
+    .history        = NULL,
+    .cache_config   = { .path = NULL },
+    .cache          = NULL
 };
 
 /* Getter for kritic_runtime_state() */
@@ -36,6 +64,8 @@ void kritic_override_printers(const kritic_printers_t* overrides) {
     if (overrides->init_printer)      state->printers.init_printer      = overrides->init_printer;
     if (overrides->stdout_printer)    state->printers.stdout_printer    = overrides->stdout_printer;
     if (overrides->skip_printer)      state->printers.skip_printer      = overrides->skip_printer;
+    if (overrides->dep_fail_printer)  state->printers.dep_fail_printer  = overrides->dep_fail_printer;
+    if (overrides->bench_printer)     state->printers.bench_printer     = overrides->bench_printer;
 }
 
 void kritic_set_default_printers(void) {
@@ -48,7 +78,8 @@ void kritic_set_default_printers(void) {
         .init_printer      = &kritic_default_init_printer,
         .stdout_printer    = &kritic_default_stdout_printer,
         .skip_printer      = &kritic_default_skip_printer,
-        .dep_fail_printer  = &kritic_default_dep_fail_printer
+        .dep_fail_printer  = &kritic_default_dep_fail_printer,
+        .bench_printer     = &kritic_default_bench_printer
     };
 }
 
@@ -71,31 +102,71 @@ void kritic_enable_ansi_(void) {
 }
 #endif
 
+/* Release everything a run set up, whether it finished or stopped on an error */
+static void kritic_run_teardown(kritic_runtime_t* runtime) {
+    kritic_fixture_teardown(runtime);
+    kritic_reporters_teardown(runtime);
+    kritic_junit_teardown(runtime);
+    kritic_binlog_teardown(runtime);
+    kritic_console_teardown(runtime);
+    kritic_history_teardown(runtime);
+    kritic_cache_teardown(runtime);
+    kritic_impact_teardown(runtime);
+
+    kritic_redirect_teardown(runtime);
+    runtime->redirect = NULL;
+    kritic_bench_teardown(runtime);
+    kritic_profiler_teardown(runtime);
+    kritic_output_teardown(runtime);
+    kritic_free_queue(runtime);
+}
+
 /* Run all of the test suites and tests */
 int kritic_run_all(void) {
     kritic_runtime_t* kritic_state = kritic_get_runtime_state();
 
     kritic_timer_start(&kritic_state->timer);
 
+    kritic_history_init(kritic_state);
+    kritic_budget_init(kritic_state);
+    kritic_impact_init(kritic_state);
     kritic_construct_queue(kritic_state);
+    kritic_cache_init(kritic_state);
+    kritic_fixture_init(kritic_state);
+    kritic_results_init(kritic_state);
 
     kritic_redirect_t* redir = &(kritic_redirect_t) { 0 };
     kritic_state->redirect = redir;
 
+    kritic_output_init(kritic_state);
+    kritic_console_init(kritic_state);
+    kritic_binlog_init(kritic_state);
+    kritic_junit_init(kritic_state);
+    kritic_reporters_init(kritic_state);
     kritic_state->printers.init_printer(kritic_state);
     kritic_redirect_init(kritic_state);
+    kritic_profiler_init(kritic_state);
 
     for (kritic_test_t** t = kritic_state->queue; *t != NULL; ++t) {
+        if (kritic_budget_exhausted(kritic_state)) {
+            uint32_t started = (uint32_t) (t - kritic_state->queue);
+            kritic_budget_stop(kritic_state, kritic_state->test_count - started);
+            break;
+        }
+
         kritic_state->test_state = &(kritic_test_state_t) {
             .test           = *t,
             .assert_count   = 0,
             .asserts_failed = 0,
             .skipped        = false,
+            .cached         = false,
+            .asserts_muted  = false,
             .skip_reason    = "",
             .duration_ns    = 0,
             .timer          = { 0 },
         };
 
+        kritic_results_start(kritic_state);
         kritic_state->printers.pre_test_printer(kritic_state);
         if ((*t)->status != KRITIC_QUEUED) {
             kritic_error_printer("[      ] Error: Test found in queue that has not yet been queued!\n");
@@ -115,6 +186,7 @@ int kritic_run_all(void) {
                 case KRITIC_RUNNING:
                     kritic_error_printerf("[      ] Error: Dependency \"%s.%s\" for test \"%s.%s\" did not run yet!\n",
                         (*ptr)->suite, (*ptr)->name, (*t)->suite, (*t)->name);
+                    kritic_run_teardown(kritic_state);
                     return 2;
                 case KRITIC_FAILED:
                 case KRITIC_DEP_FAILED:
@@ -127,19 +199,46 @@ int kritic_run_all(void) {
                 default:
                     kritic_error_printerf("[      ] Error: Test with unknown state found: \"%s.%s\"\n",
                         (*t)->suite, (*t)->name);
+                    kritic_run_teardown(kritic_state);
                     return 3;
             }
         }
 
+        /* Same code, parameters and dependencies as a recorded pass, so the pass is replayed */
+        if (kritic_cache_hit(kritic_state, (size_t) (t - kritic_state->queue))) {
+            ++kritic_state->cached_count;
+            (*t)->status = KRITIC_PASSED;
+            kritic_state->printers.post_test_printer(kritic_state);
+            kritic_results_record(kritic_state, *t);
+            kritic_history_record(kritic_state, *t);
+            kritic_fixture_release(kritic_state, *t);
+            continue;
+        }
+
+        /* Suite setup is not part of the test's duration */
+        kritic_fixture_acquire(kritic_state, *t);
         (*t)->status = KRITIC_RUNNING;
+        /* Everything printed so far has to come out before the test itself writes anything */
+        kritic_output_flush(kritic_state);
         kritic_redirect_start(kritic_state);
+        kritic_profiler_start(kritic_state);
+        kritic_impact_start(kritic_state);
         kritic_timer_start(&kritic_state->test_state->timer);
-        for (size_t i = 0; i < iterations; i++) {
-            (*t)->fn();
-            ++kritic_state->test_state->iteration;
+        if ((*t)->benchmark != NULL) {
+            kritic_bench_run(kritic_state, iterations);
+        } else if (kritic_fixture_snapshot(kritic_state, *t)) {
+            kritic_fixture_fork(kritic_state, iterations);
+        } else {
+            for (size_t i = 0; i < iterations; i++) {
+                (*t)->fn();
+                ++kritic_state->test_state->iteration;
+            }
         }
         kritic_state->test_state->duration_ns = kritic_timer_elapsed(&kritic_state->test_state->timer);
+        kritic_impact_stop(kritic_state);
+        kritic_profiler_stop(kritic_state);
         kritic_redirect_stop(kritic_state);
+        kritic_profiler_flush(kritic_state);
 
         if (kritic_state->test_state->skipped) {
             ++kritic_state->skip_count;
@@ -150,23 +249,30 @@ int kritic_run_all(void) {
         } else {
             (*t)->status = KRITIC_PASSED;
         }
+        /* Held back output is only worth reading for tests that did not pass */
+        kritic_redirect_replay(kritic_state, (*t)->status != KRITIC_PASSED);
 
+        if ((*t)->benchmark != NULL) {
+            kritic_state->printers.bench_printer(kritic_state);
+        }
         kritic_state->printers.post_test_printer(kritic_state);
 
         // Label for test skip
         skip_test:
-            continue;
+            kritic_results_record(kritic_state, *t);
+            kritic_history_record(kritic_state, *t);
+            kritic_cache_record(kritic_state, (size_t) (t - kritic_state->queue));
+            kritic_fixture_release(kritic_state, *t);
     }
+    /* Suites still set up after a stopped run are torn down before the summary */
+    kritic_fixture_teardown(kritic_state);
 
     fflush(stdout);
     kritic_state->duration_ns = kritic_timer_elapsed(&kritic_state->timer);
     kritic_state->printers.summary_printer(kritic_state);
+    kritic_run_teardown(kritic_state);
 
-    kritic_redirect_teardown(kritic_state);
-    kritic_state->redirect = NULL;
-    kritic_free_queue(kritic_state);
-
-    return kritic_state->fail_count > 0;
+    return kritic_state->fail_count > 0 || kritic_state->filter_config.unmatched_count > 0;
 }
 
 void kritic_assert_eq(
@@ -192,6 +298,7 @@ void kritic_assert_eq(
             passed = actual;
             break;
         case KRITIC_ASSERT_FAIL:
+        case KRITIC_ASSERT_CRASH:
             break;
         case KRITIC_ASSERT_EQ_INT:
             passed = (actual == expected);
@@ -228,12 +335,19 @@ void kritic_assert_eq(
         case KRITIC_ASSERT_NOT:
             passed = !actual;
             break;
+        case KRITIC_ASSERT_LATENCY:
+            passed = (actual <= expected);
+            break;
         case KRITIC_ASSERT_UNKNOWN:
         default:
             break;
     }
 
     kritic_runtime_t* kritic_state = kritic_get_runtime_state();
+    if (kritic_state->test_state->asserts_muted) {
+        if (passed) return;
+        kritic_state->test_state->asserts_muted = false;
+    }
     ++kritic_state->test_state->assert_count;
     if (!passed) ++kritic_state->test_state->asserts_failed;
     kritic_state->printers.assert_printer(ctx, passed, actual, expected, actual_expr, expected_expr, assert_type);
@@ -248,9 +362,9 @@ void kritic_skip_test(const kritic_context_t* ctx, const char* reason) {
     kritic_state->printers.skip_printer(kritic_state, ctx);
 }
 
-/* Default KritiC main(void) code used to initialize the framework */
-int __attribute__((weak)) main(void) {
+/* Default KritiC main() code used to initialize the framework */
+int __attribute__((weak)) main(int argc, char** argv) {
     kritic_enable_ansi();
     kritic_set_default_printers();
-    return kritic_run_all();
+    return kritic_run_with_args(argc, argv);
 }
@@ -0,0 +1,125 @@
+#include <stdio.h>
+
+#include "../kritic.h"
+
+/* Escaped characters of a JSON string, without the quotes */
+static void kritic_list_json_chars(FILE* file, const char* string) {
+    for (const unsigned char* c = (const unsigned char*) string; *c != '\0'; ++c) {
+        switch (*c) {
+            case '"':  fputs("\\\"", file); break;
+            case '\\': fputs("\\\\", file); break;
+            case '\n': fputs("\\n", file); break;
+            case '\r': fputs("\\r", file); break;
+            case '\t': fputs("\\t", file); break;
+            default:
+                if (*c < 0x20) fprintf(file, "\\u%04x", *c);
+                else fputc(*c, file);
+                break;
+        }
+    }
+}
+
+static void kritic_list_json_string(FILE* file, const char* string) {
+    fputc('"', file);
+    kritic_list_json_chars(file, string);
+    fputc('"', file);
+}
+
+/* Attributes that change how a test runs, listed as tags */
+static uint32_t kritic_list_tags(const kritic_test_t* test, const char** tags) {
+    uint32_t count = 0;
+
+    if (test->parameterized[0] != NULL) tags[count++] = "parameterized";
+    if (test->benchmark != NULL) tags[count++] = "benchmark";
+    if (test->latency_budgets[0] != NULL) tags[count++] = "latency_budget";
+    if (test->cold_cache != NULL) tags[count++] = "cold_cache";
+    if (test->variants[0] != NULL) tags[count++] = "variant";
+    if (test->no_cache) tags[count++] = "no_cache";
+    return count;
+}
+
+/* suite.name, a tab, file:line and the attributes that are set */
+static void kritic_list_plain(FILE* file, const kritic_test_t* test) {
+    const char* tags[8];
+    uint32_t tag_count = kritic_list_tags(test, tags);
+
+    fprintf(file, "%s.%s\t%s:%d", test->suite, test->name, test->file, test->line);
+
+    for (size_t d = 0; test->dependencies[d] != NULL; ++d) {
+        fprintf(file, "%s%s.%s", d == 0 ? " depends_on=" : ",", test->dependencies[d]->suite,
+            test->dependencies[d]->name);
+    }
+    for (size_t r = 0; r < KRITIC_MAX_RESOURCES && test->uses[r] != NULL; ++r) {
+        fprintf(file, "%s%s", r == 0 ? " uses=" : ",", test->uses[r]);
+    }
+    for (size_t p = 0; p < KRITIC_MAX_PARAMETERIZED && test->parameterized[p] != NULL; ++p) {
+        fprintf(file, "%s%s:%zu", p == 0 ? " params=" : ",", test->parameterized[p]->varname,
+            test->parameterized[p]->size);
+    }
+    for (uint32_t t = 0; t < tag_count; ++t) {
+        fprintf(file, "%s%s", t == 0 ? " tags=" : ",", tags[t]);
+    }
+    fputc('\n', file);
+}
+
+static void kritic_list_json(FILE* file, const kritic_test_t* test, bool first) {
+    const char* tags[8];
+    uint32_t tag_count = kritic_list_tags(test, tags);
+
+    fputs(first ? "\n    {\"suite\":" : ",\n    {\"suite\":", file);
+    kritic_list_json_string(file, test->suite);
+    fputs(",\"name\":", file);
+    kritic_list_json_string(file, test->name);
+    fputs(",\"file\":", file);
+    kritic_list_json_string(file, test->file);
+    fprintf(file, ",\"line\":%d,\"dependencies\":[", test->line);
+
+    for (size_t d = 0; test->dependencies[d] != NULL; ++d) {
+        if (d > 0) fputc(',', file);
+        fputc('"', file);
+        kritic_list_json_chars(file, test->dependencies[d]->suite);
+        fputc('.', file);
+        kritic_list_json_chars(file, test->dependencies[d]->name);
+        fputc('"', file);
+    }
+    fputs("],\"uses\":[", file);
+    for (size_t r = 0; r < KRITIC_MAX_RESOURCES && test->uses[r] != NULL; ++r) {
+        if (r > 0) fputc(',', file);
+        kritic_list_json_string(file, test->uses[r]);
+    }
+    fputs("],\"parameters\":[", file);
+    for (size_t p = 0; p < KRITIC_MAX_PARAMETERIZED && test->parameterized[p] != NULL; ++p) {
+        fputs(p > 0 ? ",{\"name\":" : "{\"name\":", file);
+        kritic_list_json_string(file, test->parameterized[p]->varname);
+        fprintf(file, ",\"count\":%zu}", test->parameterized[p]->size);
+    }
+    fputs("],\"tags\":[", file);
+    for (uint32_t t = 0; t < tag_count; ++t) {
+        fprintf(file, t > 0 ? ",\"%s\"" : "\"%s\"", tags[t]);
+    }
+    fputs("]}", file);
+}
+
+/* Print the tests that would run, in the order they would run in, without starting the run */
+int kritic_list_tests(kritic_runtime_t* runtime, kritic_list_format_t format) {
+    FILE* file = stdout;
+    kritic_history_init(runtime);
+    kritic_impact_init(runtime);
+    size_t count = kritic_construct_queue(runtime);
+
+    if (format == KRITIC_LIST_JSON) fprintf(file, "{\"count\":%zu,\"tests\":[", count);
+    for (kritic_test_t** t = runtime->queue; *t != NULL; ++t) {
+        if (format == KRITIC_LIST_JSON) {
+            kritic_list_json(file, *t, t == runtime->queue);
+        } else {
+            kritic_list_plain(file, *t);
+        }
+    }
+    if (format == KRITIC_LIST_JSON) fputs(count > 0 ? "\n]}\n" : "]}\n", file);
+    fflush(file);
+
+    kritic_free_queue(runtime);
+    kritic_history_teardown(runtime);
+    kritic_impact_teardown(runtime);
+    return runtime->filter_config.unmatched_count > 0;
+}
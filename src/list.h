@@ -0,0 +1,22 @@
+#ifndef KRITIC_LIST_H
+#define KRITIC_LIST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct kritic_runtime_t;
+
+typedef enum {
+    /* One line per test: suite.name, a tab, file:line and the attributes that are set */
+    KRITIC_LIST_PLAIN = 0,
+    KRITIC_LIST_JSON
+} kritic_list_format_t;
+
+int kritic_list_tests(struct kritic_runtime_t* runtime, kritic_list_format_t format);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // KRITIC_LIST_H
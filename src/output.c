@@ -0,0 +1,339 @@
+/* fileno() is not ISO C */
+#define _POSIX_C_SOURCE 200112L
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "../kritic.h"
+
+#ifdef _WIN32
+#include <io.h>
+
+typedef struct {
+    void* iov_base;
+    size_t iov_len;
+} kritic_iovec_t;
+
+#define kritic_output_dup(fd)     _dup(fd)
+#define kritic_output_close(fd)   _close(fd)
+#define kritic_output_fileno(f)   _fileno(f)
+#define kritic_output_lock(o)     EnterCriticalSection(&(o)->lock)
+#define kritic_output_unlock(o)   LeaveCriticalSection(&(o)->lock)
+
+#else // POSIX
+#include <sys/uio.h>
+#include <unistd.h>
+
+typedef struct iovec kritic_iovec_t;
+
+#define kritic_output_dup(fd)     dup(fd)
+#define kritic_output_close(fd)   close(fd)
+#define kritic_output_fileno(f)   fileno(f)
+#define kritic_output_lock(o)     pthread_mutex_lock(&(o)->lock)
+#define kritic_output_unlock(o)   pthread_mutex_unlock(&(o)->lock)
+
+#endif // POSIX
+
+static kritic_output_t kritic_output_storage;
+
+#ifndef _WIN32
+/* Process that set up the output, a forked child exiting must not flush the parent's buffer */
+static pid_t kritic_output_owner = 0;
+#endif
+
+/* Write all of iov, retrying partial writes */
+static void kritic_output_writev(int fd, kritic_iovec_t* iov, int count) {
+#ifdef _WIN32
+    for (int i = 0; i < count; ++i) {
+        const char* data = iov[i].iov_base;
+        size_t left = iov[i].iov_len;
+        while (left > 0) {
+            int written = _write(fd, data, (unsigned int) left);
+            if (written <= 0) return;
+            data += written;
+            left -= (size_t) written;
+        }
+    }
+#else // POSIX
+    while (count > 0) {
+        ssize_t written = writev(fd, iov, count);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+
+        size_t left = (size_t) written;
+        while (count > 0 && left >= iov->iov_len) {
+            left -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = (char*) iov->iov_base + left;
+            iov->iov_len -= left;
+        }
+    }
+#endif // POSIX
+}
+
+/* Write out the buffered segments followed by data, batching everything headed for the same fd */
+static void kritic_output_flush_locked(kritic_output_t* output, kritic_stream_t stream, const char* data,
+                                       size_t length) {
+    kritic_iovec_t iov[KRITIC_OUTPUT_MAX_SEGMENTS + 1];
+    int count = 0;
+    int fd = -1;
+
+    for (uint32_t i = 0; i < output->segment_count; ++i) {
+        const kritic_output_segment_t* segment = &output->segments[i];
+        int segment_fd = output->fds[segment->stream];
+
+        if (count > 0 && segment_fd != fd) {
+            kritic_output_writev(fd, iov, count);
+            count = 0;
+        }
+        fd = segment_fd;
+        iov[count++] = (kritic_iovec_t) { output->buffer + segment->offset, segment->length };
+    }
+
+    if (data != NULL) {
+        int data_fd = output->fds[stream];
+        if (count > 0 && data_fd != fd) {
+            kritic_output_writev(fd, iov, count);
+            count = 0;
+        }
+        fd = data_fd;
+        iov[count++] = (kritic_iovec_t) { (void*) (uintptr_t) data, length };
+    }
+
+    if (count > 0) kritic_output_writev(fd, iov, count);
+
+    output->length = 0;
+    output->segment_count = 0;
+}
+
+static void kritic_output_append_locked(kritic_output_t* output, kritic_stream_t stream, const char* data,
+                                        size_t length) {
+    kritic_output_segment_t* last = output->segment_count > 0 ? &output->segments[output->segment_count - 1] : NULL;
+    bool new_segment = last == NULL || last->stream != stream;
+
+    if (output->length + length > KRITIC_OUTPUT_BUFFER_SIZE
+        || (new_segment && output->segment_count == KRITIC_OUTPUT_MAX_SEGMENTS)) {
+        kritic_output_flush_locked(output, stream, NULL, 0);
+        last = NULL;
+        new_segment = true;
+    }
+
+    if (new_segment) {
+        output->segments[output->segment_count++] = (kritic_output_segment_t) {
+            .stream = stream,
+            .offset = output->length,
+            .length = (uint32_t) length
+        };
+    } else {
+        last->length += (uint32_t) length;
+    }
+
+    memcpy(output->buffer + output->length, data, length);
+    output->length += (uint32_t) length;
+}
+
+/* Drop ANSI escape sequences, returns the remaining length */
+static size_t kritic_output_strip_color(char* destination, const char* data, size_t length) {
+    size_t kept = 0;
+
+    for (size_t i = 0; i < length; ++i) {
+        if (data[i] == '\033' && i + 1 < length && data[i + 1] == '[') {
+            /* Parameters and intermediates up to the final byte */
+            for (i += 2; i < length && (data[i] < 0x40 || data[i] > 0x7E); ++i);
+            continue;
+        }
+        destination[kept++] = data[i];
+    }
+    return kept;
+}
+
+/* Queue data behind the buffered output, large writes go out right away */
+static void kritic_output_put_locked(kritic_output_t* output, kritic_stream_t stream, const char* data,
+                                     size_t length) {
+    char local[1024];
+    char* stripped = NULL;
+
+    if (output->strip_color[stream] && memchr(data, '\033', length) != NULL) {
+        stripped = length <= sizeof(local) ? local : malloc(length);
+        if (stripped == NULL) {
+            fprintf(stderr, "[      ] Error: malloc() failed in kritic_output_put_locked()\n");
+            exit(1);
+        }
+        length = kritic_output_strip_color(stripped, data, length);
+        data = stripped;
+    }
+
+    if (length > KRITIC_OUTPUT_DIRECT_LIMIT) {
+        kritic_output_flush_locked(output, stream, data, length);
+    } else {
+        kritic_output_append_locked(output, stream, data, length);
+    }
+
+    if (stripped != local) free(stripped);
+}
+
+/* Both streams lead to the same terminal or pipe, so they can share writes */
+static bool kritic_output_same_target(int out_fd, int err_fd) {
+#ifdef _WIN32
+    /* Windows does not report inode numbers */
+    (void) out_fd;
+    (void) err_fd;
+    return false;
+#else // POSIX
+    struct stat out_stat, err_stat;
+    if (fstat(out_fd, &out_stat) != 0 || fstat(err_fd, &err_stat) != 0) return false;
+
+    /* Separately opened regular files keep separate offsets */
+    if (S_ISREG(out_stat.st_mode)) return false;
+    return out_stat.st_dev == err_stat.st_dev && out_stat.st_ino == err_stat.st_ino;
+#endif // POSIX
+}
+
+/* exit() from anywhere must not lose what was printed so far */
+static void kritic_output_atexit(void) {
+#ifndef _WIN32
+    if (kritic_output_owner != getpid()) return;
+#endif
+    kritic_output_flush(kritic_get_runtime_state());
+}
+
+void kritic_output_init(kritic_runtime_t* runtime) {
+    static bool atexit_registered = false;
+    kritic_output_t* output = &kritic_output_storage;
+
+    fflush(stdout);
+    fflush(stderr);
+
+    output->length = 0;
+    output->segment_count = 0;
+    output->strip_color[KRITIC_STREAM_STDOUT] = false;
+    output->strip_color[KRITIC_STREAM_STDERR] = false;
+    output->fds[KRITIC_STREAM_STDOUT] = kritic_output_dup(kritic_output_fileno(stdout));
+    output->fds[KRITIC_STREAM_STDERR] = kritic_output_dup(kritic_output_fileno(stderr));
+    if (output->fds[KRITIC_STREAM_STDOUT] == -1 || output->fds[KRITIC_STREAM_STDERR] == -1) {
+        perror("dup failed");
+        exit(1);
+    }
+
+    if (kritic_output_same_target(output->fds[KRITIC_STREAM_STDOUT], output->fds[KRITIC_STREAM_STDERR])) {
+        kritic_output_close(output->fds[KRITIC_STREAM_STDERR]);
+        output->fds[KRITIC_STREAM_STDERR] = output->fds[KRITIC_STREAM_STDOUT];
+    }
+
+    const char* unbuffered = getenv("KRITIC_OUTPUT_UNBUFFERED");
+    output->unbuffered = unbuffered != NULL && strcmp(unbuffered, "1") == 0;
+
+#ifdef _WIN32
+    InitializeCriticalSection(&output->lock);
+#else
+    pthread_mutex_init(&output->lock, NULL);
+#endif
+
+#ifndef _WIN32
+    kritic_output_owner = getpid();
+#endif
+
+    if (!atexit_registered) {
+        atexit(kritic_output_atexit);
+        atexit_registered = true;
+    }
+
+    runtime->output = output;
+}
+
+void kritic_output_teardown(kritic_runtime_t* runtime) {
+    kritic_output_t* output = runtime->output;
+    if (output == NULL) return;
+
+    kritic_output_flush(runtime);
+    runtime->output = NULL;
+
+    if (output->fds[KRITIC_STREAM_STDERR] != output->fds[KRITIC_STREAM_STDOUT]) {
+        kritic_output_close(output->fds[KRITIC_STREAM_STDERR]);
+    }
+    kritic_output_close(output->fds[KRITIC_STREAM_STDOUT]);
+
+#ifdef _WIN32
+    DeleteCriticalSection(&output->lock);
+#else
+    pthread_mutex_destroy(&output->lock);
+#endif
+}
+
+void kritic_output_flush(kritic_runtime_t* runtime) {
+    kritic_output_t* output = runtime->output;
+    if (output == NULL) return;
+
+    kritic_output_lock(output);
+    kritic_output_flush_locked(output, KRITIC_STREAM_STDOUT, NULL, 0);
+    kritic_output_unlock(output);
+}
+
+void kritic_output_write(kritic_stream_t stream, const char* data, size_t length) {
+    kritic_output_t* output = kritic_get_runtime_state()->output;
+
+    /* Not running, keep the order of whatever else went through stdio */
+    if (output == NULL) {
+        fwrite(data, 1, length, stream == KRITIC_STREAM_STDERR ? stderr : stdout);
+        return;
+    }
+
+    kritic_output_lock(output);
+    kritic_output_put_locked(output, stream, data, length);
+    if (output->unbuffered) kritic_output_flush_locked(output, stream, NULL, 0);
+    kritic_output_unlock(output);
+}
+
+/* Like kritic_output_write() for each slice, under a single lock */
+void kritic_output_write_slices(kritic_stream_t stream, const kritic_output_slice_t* slices, uint32_t count) {
+    kritic_output_t* output = kritic_get_runtime_state()->output;
+
+    if (output == NULL) {
+        for (uint32_t i = 0; i < count; ++i) kritic_output_write(stream, slices[i].data, slices[i].length);
+        return;
+    }
+
+    kritic_output_lock(output);
+    for (uint32_t i = 0; i < count; ++i) {
+        kritic_output_put_locked(output, stream, slices[i].data, slices[i].length);
+    }
+    if (output->unbuffered) kritic_output_flush_locked(output, stream, NULL, 0);
+    kritic_output_unlock(output);
+}
+
+void kritic_output_printf(kritic_stream_t stream, const char* format, ...) {
+    char local[1024];
+    va_list args;
+
+    va_start(args, format);
+    int length = vsnprintf(local, sizeof(local), format, args);
+    va_end(args);
+    if (length < 0) return;
+
+    if ((size_t) length < sizeof(local)) {
+        kritic_output_write(stream, local, (size_t) length);
+        return;
+    }
+
+    char* formatted = malloc((size_t) length + 1);
+    if (formatted == NULL) {
+        fprintf(stderr, "[      ] Error: malloc() failed in kritic_output_printf()\n");
+        exit(1);
+    }
+
+    va_start(args, format);
+    vsnprintf(formatted, (size_t) length + 1, format, args);
+    va_end(args);
+
+    kritic_output_write(stream, formatted, (size_t) length);
+    free(formatted);
+}
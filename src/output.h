@@ -0,0 +1,74 @@
+#ifndef KRITIC_OUTPUT_H
+#define KRITIC_OUTPUT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define KRITIC_OUTPUT_BUFFER_SIZE  65536
+#define KRITIC_OUTPUT_MAX_SEGMENTS 64
+/* Writes larger than this skip the buffer and go out in the same writev() as the buffered tail */
+#define KRITIC_OUTPUT_DIRECT_LIMIT (KRITIC_OUTPUT_BUFFER_SIZE / 4)
+
+#ifdef _WIN32
+#include <windows.h>
+#else // POSIX
+#include <pthread.h>
+#endif // POSIX
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct kritic_runtime_t;
+
+typedef enum {
+    KRITIC_STREAM_STDOUT = 0,
+    KRITIC_STREAM_STDERR,
+    KRITIC_STREAM_COUNT
+} kritic_stream_t;
+
+/* A run of buffered bytes headed for the same stream */
+typedef struct {
+    kritic_stream_t stream;
+    uint32_t offset;
+    uint32_t length;
+} kritic_output_segment_t;
+
+/* Caller owned bytes passed to kritic_output_write_slices() */
+typedef struct {
+    const char* data;
+    size_t length;
+} kritic_output_slice_t;
+
+/* Output of all printers, written out in order once per test or when full */
+typedef struct {
+    char buffer[KRITIC_OUTPUT_BUFFER_SIZE];
+    uint32_t length;
+    kritic_output_segment_t segments[KRITIC_OUTPUT_MAX_SEGMENTS];
+    uint32_t segment_count;
+    /* Copies of the real stdout and stderr, unaffected by redirection */
+    int fds[KRITIC_STREAM_COUNT];
+    /* Flush after every write, so nothing is lost if a test crashes */
+    bool unbuffered;
+    /* Drop color codes, set by the console for streams that are not a terminal */
+    bool strip_color[KRITIC_STREAM_COUNT];
+#ifdef _WIN32
+    CRITICAL_SECTION lock;
+#else
+    pthread_mutex_t lock;
+#endif
+} kritic_output_t;
+
+void kritic_output_init(struct kritic_runtime_t* runtime);
+void kritic_output_teardown(struct kritic_runtime_t* runtime);
+void kritic_output_flush(struct kritic_runtime_t* runtime);
+void kritic_output_write(kritic_stream_t stream, const char* data, size_t length);
+void kritic_output_write_slices(kritic_stream_t stream, const kritic_output_slice_t* slices, uint32_t count);
+void kritic_output_printf(kritic_stream_t stream, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // KRITIC_OUTPUT_H
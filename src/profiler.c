@@ -0,0 +1,330 @@
+/* REG_RIP, dladdr() and pthread_getattr_np() are GNU extensions */
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../kritic.h"
+
+/* Profile every test and write folded stacks into directory */
+void kritic_profiler_enable(const char* directory, uint32_t frequency_hz) {
+    kritic_runtime_t* runtime = kritic_get_runtime_state();
+    runtime->profiler_config = (kritic_profiler_config_t) {
+        .directory    = directory,
+        .frequency_hz = frequency_hz > 0 ? frequency_hz : KRITIC_PROFILER_DEFAULT_HZ
+    };
+}
+
+/* Allow enabling the profiler without a custom main() */
+static bool kritic_profiler_configured(kritic_runtime_t* runtime) {
+    kritic_profiler_config_t* config = &runtime->profiler_config;
+    if (config->directory != NULL) return true;
+
+    const char* directory = getenv("KRITIC_PROFILE_DIR");
+    if (directory == NULL || *directory == '\0') return false;
+
+    const char* hz = getenv("KRITIC_PROFILE_HZ");
+    uint32_t frequency_hz = 0;
+    if (hz != NULL && hz[0] != '\0') {
+        char* end;
+        unsigned long parsed = strtoul(hz, &end, 10);
+        /* The interval timer cannot fire more often than once per microsecond */
+        if (hz[0] == '-' || *end != '\0' || parsed == 0 || parsed > 1000000) {
+            fprintf(stderr, "[      ] Error: KRITIC_PROFILE_HZ=\"%s\" is not a frequency between 1 and 1000000\n", hz);
+            exit(1);
+        }
+        frequency_hz = (uint32_t) parsed;
+    }
+    kritic_profiler_enable(directory, frequency_hz);
+    return true;
+}
+
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+
+#include <dlfcn.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <ucontext.h>
+
+typedef struct {
+    kritic_profiler_sample_t* ring;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t dropped;
+    bool active;
+    uintptr_t stack_high;
+    struct sigaction previous;
+} kritic_profiler_state_t;
+
+/* Shared with the signal handler, which must not allocate or lock */
+static kritic_profiler_state_t kritic_profiler = { 0 };
+
+static void kritic_profiler_handler(int signo, siginfo_t* info, void* context) {
+    (void) signo;
+    (void) info;
+    if (!__atomic_load_n(&kritic_profiler.active, __ATOMIC_ACQUIRE)) return;
+
+    /* Single producer: only the consumer moves tail */
+    uint32_t head = kritic_profiler.head;
+    uint32_t tail = __atomic_load_n(&kritic_profiler.tail, __ATOMIC_ACQUIRE);
+    if (head - tail >= KRITIC_PROFILER_RING_SIZE) {
+        ++kritic_profiler.dropped;
+        return;
+    }
+
+    const ucontext_t* uc = (const ucontext_t*) context;
+#if defined(__x86_64__)
+    uintptr_t pc = (uintptr_t) uc->uc_mcontext.gregs[REG_RIP];
+    uintptr_t fp = (uintptr_t) uc->uc_mcontext.gregs[REG_RBP];
+    uintptr_t sp = (uintptr_t) uc->uc_mcontext.gregs[REG_RSP];
+#else // __aarch64__
+    uintptr_t pc = (uintptr_t) uc->uc_mcontext.pc;
+    uintptr_t fp = (uintptr_t) uc->uc_mcontext.regs[29];
+    uintptr_t sp = (uintptr_t) uc->uc_mcontext.sp;
+#endif
+
+    kritic_profiler_sample_t* sample = &kritic_profiler.ring[head & (KRITIC_PROFILER_RING_SIZE - 1)];
+    sample->frames[0] = pc;
+    uint32_t depth = 1;
+
+    /* Walk the frame pointer chain without leaving the runner's stack */
+    while (depth < KRITIC_PROFILER_MAX_DEPTH
+        && fp >= sp
+        && fp + 2 * sizeof(uintptr_t) <= kritic_profiler.stack_high
+        && fp % sizeof(uintptr_t) == 0) {
+        const uintptr_t* frame = (const uintptr_t*) fp;
+        if (frame[1] == 0) break;
+
+        sample->frames[depth++] = frame[1];
+        if (frame[0] <= fp) break;
+        fp = frame[0];
+    }
+
+    sample->depth = depth;
+    __atomic_store_n(&kritic_profiler.head, head + 1, __ATOMIC_RELEASE);
+}
+
+static void kritic_profiler_set_timer(uint32_t frequency_hz) {
+    struct itimerval timer = { 0 };
+    if (frequency_hz > 0) {
+        timer.it_interval.tv_sec = 0;
+        timer.it_interval.tv_usec = (suseconds_t) (frequency_hz > 1000000 ? 1 : 1000000 / frequency_hz);
+        timer.it_value = timer.it_interval;
+    }
+    setitimer(ITIMER_PROF, &timer, NULL);
+}
+
+void kritic_profiler_init(kritic_runtime_t* runtime) {
+    if (!kritic_profiler_configured(runtime)) return;
+
+    kritic_profiler.ring = malloc(KRITIC_PROFILER_RING_SIZE * sizeof(kritic_profiler_sample_t));
+    if (kritic_profiler.ring == NULL) {
+        fprintf(stderr, "[      ] Error: malloc() failed in kritic_profiler_init()\n");
+        exit(1);
+    }
+
+    /* Frames above the top of the stack are never dereferenced */
+    pthread_attr_t attr;
+    void* stack_addr;
+    size_t stack_size;
+    if (pthread_getattr_np(pthread_self(), &attr) != 0
+        || pthread_attr_getstack(&attr, &stack_addr, &stack_size) != 0) {
+        kritic_error_printer("[      ] Warning: Could not determine stack bounds, profiling leaf frames only\n");
+        kritic_profiler.stack_high = 0;
+    } else {
+        kritic_profiler.stack_high = (uintptr_t) stack_addr + stack_size;
+        pthread_attr_destroy(&attr);
+    }
+
+    const char* directory = runtime->profiler_config.directory;
+    if (mkdir(directory, 0755) != 0 && errno != EEXIST) {
+        fprintf(stderr, "[      ] Error: Could not create the profile directory \"%s\": %s\n", directory, strerror(errno));
+        exit(1);
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = kritic_profiler_handler;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGPROF, &action, &kritic_profiler.previous);
+}
+
+void kritic_profiler_teardown(kritic_runtime_t* runtime) {
+    (void) runtime;
+    if (kritic_profiler.ring == NULL) return;
+
+    kritic_profiler_set_timer(0);
+    sigaction(SIGPROF, &kritic_profiler.previous, NULL);
+    free(kritic_profiler.ring);
+    kritic_profiler.ring = NULL;
+}
+
+void kritic_profiler_start(kritic_runtime_t* runtime) {
+    if (kritic_profiler.ring == NULL) return;
+
+    kritic_profiler.head = 0;
+    kritic_profiler.tail = 0;
+    kritic_profiler.dropped = 0;
+    __atomic_store_n(&kritic_profiler.active, true, __ATOMIC_RELEASE);
+    kritic_profiler_set_timer(runtime->profiler_config.frequency_hz);
+}
+
+static int kritic_profiler_compare(const void* a, const void* b) {
+    const kritic_profiler_sample_t* x = *(const kritic_profiler_sample_t* const*) a;
+    const kritic_profiler_sample_t* y = *(const kritic_profiler_sample_t* const*) b;
+
+    if (x->depth != y->depth) return x->depth < y->depth ? -1 : 1;
+    return memcmp(x->frames, y->frames, x->depth * sizeof(uintptr_t));
+}
+
+typedef struct {
+    char* stack;
+    uint32_t count;
+} kritic_profiler_folded_t;
+
+static int kritic_profiler_compare_folded(const void* a, const void* b) {
+    return strcmp(((const kritic_profiler_folded_t*) a)->stack, ((const kritic_profiler_folded_t*) b)->stack);
+}
+
+static size_t kritic_profiler_format_frame(char* buffer, size_t size, uintptr_t address) {
+    Dl_info info;
+    int len;
+
+    if (dladdr((void*) address, &info) == 0) {
+        len = snprintf(buffer, size, ";0x%" PRIxPTR, address);
+    } else if (info.dli_sname != NULL) {
+        len = snprintf(buffer, size, ";%s", info.dli_sname);
+    } else {
+        /* Static functions are not in the dynamic symbol table */
+        const char* module = strrchr(info.dli_fname, '/');
+        len = snprintf(buffer, size, ";%s+0x%" PRIxPTR, module ? module + 1 : info.dli_fname,
+            address - (uintptr_t) info.dli_fbase);
+    }
+
+    if (len < 0) return 0;
+    return (size_t) len < size ? (size_t) len : size - 1;
+}
+
+/* Render a stack root first, in the format flamegraph.pl expects */
+static char* kritic_profiler_format_stack(const kritic_test_t* test, const kritic_profiler_sample_t* sample) {
+    char buffer[8192];
+    int prefix = snprintf(buffer, sizeof(buffer), "%s.%s", test->suite, test->name);
+    size_t len = prefix > 0 && (size_t) prefix < sizeof(buffer) ? (size_t) prefix : 0;
+
+    for (uint32_t d = sample->depth; d > 0 && len < sizeof(buffer) - 1; --d) {
+        /* Return addresses point past the call instruction */
+        uintptr_t address = sample->frames[d - 1];
+        len += kritic_profiler_format_frame(buffer + len, sizeof(buffer) - len, d > 1 ? address - 1 : address);
+    }
+
+    char* stack = malloc(len + 1);
+    if (stack == NULL) {
+        fprintf(stderr, "[      ] Error: malloc() failed in kritic_profiler_format_stack()\n");
+        exit(1);
+    }
+    memcpy(stack, buffer, len);
+    stack[len] = '\0';
+    return stack;
+}
+
+/* Fold identical address stacks first, then stacks that symbolize identically */
+static void kritic_profiler_write_folded(FILE* file, const kritic_test_t* test, kritic_profiler_sample_t** samples,
+    uint32_t count) {
+    kritic_profiler_folded_t* folded = malloc(count * sizeof(kritic_profiler_folded_t));
+    if (folded == NULL) {
+        fprintf(stderr, "[      ] Error: malloc() failed in kritic_profiler_write_folded()\n");
+        exit(1);
+    }
+
+    qsort(samples, count, sizeof(kritic_profiler_sample_t*), kritic_profiler_compare);
+
+    uint32_t unique = 0;
+    for (uint32_t i = 0; i < count;) {
+        uint32_t run = 1;
+        while (i + run < count && kritic_profiler_compare(&samples[i], &samples[i + run]) == 0) ++run;
+
+        folded[unique++] = (kritic_profiler_folded_t) {
+            .stack = kritic_profiler_format_stack(test, samples[i]),
+            .count = run
+        };
+        i += run;
+    }
+
+    qsort(folded, unique, sizeof(kritic_profiler_folded_t), kritic_profiler_compare_folded);
+
+    for (uint32_t i = 0; i < unique;) {
+        uint32_t total = folded[i].count;
+        uint32_t j = i + 1;
+        while (j < unique && strcmp(folded[i].stack, folded[j].stack) == 0) total += folded[j++].count;
+
+        fprintf(file, "%s %" PRIu32 "\n", folded[i].stack, total);
+        i = j;
+    }
+
+    for (uint32_t i = 0; i < unique; ++i) free(folded[i].stack);
+    free(folded);
+}
+
+void kritic_profiler_stop(kritic_runtime_t* runtime) {
+    (void) runtime;
+    if (kritic_profiler.ring == NULL) return;
+
+    kritic_profiler_set_timer(0);
+    __atomic_store_n(&kritic_profiler.active, false, __ATOMIC_RELEASE);
+}
+
+/* Write the samples of the current test, called once stdout is restored */
+void kritic_profiler_flush(kritic_runtime_t* runtime) {
+    if (kritic_profiler.ring == NULL) return;
+
+    uint32_t head = __atomic_load_n(&kritic_profiler.head, __ATOMIC_ACQUIRE);
+    uint32_t count = head - kritic_profiler.tail;
+    if (count == 0) return;
+
+    kritic_profiler_sample_t** samples = malloc(count * sizeof(kritic_profiler_sample_t*));
+    if (samples == NULL) {
+        fprintf(stderr, "[      ] Error: malloc() failed in kritic_profiler_flush()\n");
+        exit(1);
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        samples[i] = &kritic_profiler.ring[(kritic_profiler.tail + i) & (KRITIC_PROFILER_RING_SIZE - 1)];
+    }
+
+    const kritic_test_t* test = runtime->test_state->test;
+    char path[4096];
+    kritic_snprintf(path, sizeof(path), "%s/%s.%s.folded", runtime->profiler_config.directory, test->suite,
+        test->name);
+
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        kritic_error_printerf("[      ] Warning: Could not write profile to %s\n", path);
+    } else {
+        kritic_profiler_write_folded(file, test, samples, count);
+        fclose(file);
+        kritic_printerf("[ \033[1;33mPROF\033[0m ] %s.%s: %" PRIu32 " samples (%" PRIu32 " dropped) written to %s\n",
+            test->suite, test->name, count, kritic_profiler.dropped, path);
+    }
+
+    free(samples);
+    __atomic_store_n(&kritic_profiler.tail, head, __ATOMIC_RELEASE);
+}
+
+#else // Unsupported platform
+
+void kritic_profiler_init(kritic_runtime_t* runtime) {
+    if (!kritic_profiler_configured(runtime)) return;
+    kritic_error_printer("[      ] Warning: The sampling profiler is not supported on this platform\n");
+}
+
+void kritic_profiler_teardown(kritic_runtime_t* runtime) { (void) runtime; }
+void kritic_profiler_start(kritic_runtime_t* runtime) { (void) runtime; }
+void kritic_profiler_stop(kritic_runtime_t* runtime) { (void) runtime; }
+void kritic_profiler_flush(kritic_runtime_t* runtime) { (void) runtime; }
+
+#endif // Unsupported platform
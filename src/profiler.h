@@ -0,0 +1,41 @@
+#ifndef KRITIC_PROFILER_H
+#define KRITIC_PROFILER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define KRITIC_PROFILER_DEFAULT_HZ 997
+#define KRITIC_PROFILER_MAX_DEPTH  64
+/* Number of stack samples buffered per test, must be a power of two */
+#define KRITIC_PROFILER_RING_SIZE  8192
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct kritic_runtime_t;
+
+/* Sampling profiler settings, profiling is disabled while directory is NULL */
+typedef struct {
+    const char* directory;
+    uint32_t frequency_hz;
+} kritic_profiler_config_t;
+
+typedef struct {
+    uint32_t depth;
+    uintptr_t frames[KRITIC_PROFILER_MAX_DEPTH];
+} kritic_profiler_sample_t;
+
+void kritic_profiler_enable(const char* directory, uint32_t frequency_hz);
+void kritic_profiler_init(struct kritic_runtime_t* runtime);
+void kritic_profiler_teardown(struct kritic_runtime_t* runtime);
+void kritic_profiler_start(struct kritic_runtime_t* runtime);
+void kritic_profiler_stop(struct kritic_runtime_t* runtime);
+void kritic_profiler_flush(struct kritic_runtime_t* runtime);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // KRITIC_PROFILER_H
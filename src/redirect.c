@@ -9,6 +9,11 @@ void kritic_redirect_init(kritic_runtime_t* runtime) { (void) runtime; }
 void kritic_redirect_teardown(kritic_runtime_t* runtime) { (void) runtime; }
 void kritic_redirect_start(kritic_runtime_t* runtime) { (void) runtime; }
 void kritic_redirect_stop(kritic_runtime_t* runtime) { (void) runtime; }
+void kritic_redirect_replay(kritic_runtime_t* runtime, bool show) { (void) runtime; (void) show; }
+
+void kritic_redirect_set_failure_only(bool enabled) {
+    kritic_get_runtime_state()->redirect_config.failure_only = enabled;
+}
 
 #else // KRITIC_DISABLE_REDIRECT
 
@@ -19,102 +24,279 @@ void kritic_redirect_stop(kritic_runtime_t* runtime) { (void) runtime; }
 #ifdef _WIN32
     #define READ_RET_T int
 #else
+    #include <errno.h>
+    #include <poll.h>
+    #include <signal.h>
+    #include <sys/ioctl.h>
+    #include <time.h>
     #include <unistd.h>
     #define READ_RET_T ssize_t
 #endif
 
 #include "../kritic.h"
 
-static void kritic_read_pipe_lines(kritic_runtime_t* runtime, char* buffer, char* line_buffer) {
-    kritic_redirect_t* state = runtime->redirect;
-    uint32_t line_len = 0;
-    READ_RET_T read_return;
+void kritic_redirect_set_failure_only(bool enabled) {
+    kritic_get_runtime_state()->redirect_config.failure_only = enabled;
+}
 
-    uint32_t bytes_read;
-    bool is_part_of_split = false;
-
-    while ((read_return = _read(state->read_fd, buffer, KRITIC_REDIRECT_BUFFER_SIZE - 1)) > 0) {
-        bytes_read = (uint32_t) read_return;
-        char* nl;
-        for (uint32_t i = 0; i < bytes_read;) {
-            nl = memchr(buffer + i, '\n', bytes_read - i);
-            uint32_t chunk_len = nl ? (uint32_t) (nl - (buffer + i) + 1) : (bytes_read - i);
-
-            if (line_len + chunk_len > KRITIC_REDIRECT_BUFFER_SIZE - 1) {
-                line_buffer[line_len] = '\0';
-                runtime->printers.stdout_printer(runtime, &(kritic_redirect_ctx_t) {
-                    .stdout_copy      = state->stdout_copy,
-                    .string           = line_buffer,
-                    .length           = line_len,
-                    .is_part_of_split = is_part_of_split
-                });
-                is_part_of_split = true;
-                line_len = 0;
-            }
+static void kritic_redirect_print(kritic_runtime_t* runtime, kritic_stream_t stream, char* string, uint32_t length,
+                                  bool is_part_of_split, uint64_t timestamp_ns) {
+    runtime->printers.stdout_printer(runtime, &(kritic_redirect_ctx_t) {
+        .stdout_copy      = runtime->redirect->stdout_copy,
+        .string           = string,
+        .length           = length,
+        .is_part_of_split = is_part_of_split,
+        .stream           = stream,
+        .timestamp_ns     = timestamp_ns
+    });
+}
+
+/* Move the held back records to the spill file, so the buffer never grows */
+static void kritic_redirect_spill(kritic_redirect_capture_t* capture) {
+    if (fwrite(capture->buffer, 1, capture->length, capture->spill) != capture->length) {
+        fprintf(stderr, "[      ] Error: Could not spill captured output to disk\n");
+        exit(1);
+    }
+    capture->spilled += capture->length;
+    capture->length = 0;
+}
+
+static void kritic_redirect_hold(kritic_redirect_capture_t* capture, kritic_stream_t stream, const char* string,
+                                 uint32_t length, bool is_part_of_split, uint64_t timestamp_ns) {
+    kritic_redirect_record_t record = {
+        .timestamp_ns     = timestamp_ns,
+        .length           = length,
+        .stream           = (uint8_t) stream,
+        .is_part_of_split = is_part_of_split
+    };
+    /* The terminator is kept, so replayed lines can be printed in place */
+    uint32_t size = (uint32_t) sizeof(record) + length + 1;
+
+    if (capture->length + size > KRITIC_REDIRECT_CAPTURE_SIZE) kritic_redirect_spill(capture);
+
+    memcpy(capture->buffer + capture->length, &record, sizeof(record));
+    memcpy(capture->buffer + capture->length + sizeof(record), string, length);
+    capture->buffer[capture->length + sizeof(record) + length] = '\0';
+    capture->length += size;
+}
+
+/* Hand one (part of a) line to the stdout printer, or hold it back until the test result is known */
+static void kritic_redirect_emit(kritic_runtime_t* runtime, kritic_stream_t stream, char* string, uint32_t length,
+                                 bool is_part_of_split, uint64_t timestamp_ns) {
+    kritic_redirect_capture_t* capture = &runtime->redirect->capture;
+
+    if (capture->buffer != NULL) {
+        kritic_redirect_hold(capture, stream, string, length, is_part_of_split, timestamp_ns);
+    } else {
+        kritic_redirect_print(runtime, stream, string, length, is_part_of_split, timestamp_ns);
+    }
+}
+
+static void kritic_redirect_capture_init(kritic_runtime_t* runtime) {
+    kritic_redirect_capture_t* capture = &runtime->redirect->capture;
+
+    const char* failure_only = getenv("KRITIC_OUTPUT_ON_FAILURE");
+    if (failure_only != NULL && strcmp(failure_only, "1") == 0) runtime->redirect_config.failure_only = true;
+
+    /* Nothing is held back and nobody else looks at the lines, so they can skip the line buffer */
+    runtime->redirect->forward = !runtime->redirect_config.failure_only
+        && runtime->printers.stdout_printer == kritic_default_stdout_printer;
+    if (!runtime->redirect_config.failure_only) return;
+
+    capture->buffer = malloc(KRITIC_REDIRECT_CAPTURE_SIZE);
+    if (capture->buffer == NULL) {
+        fprintf(stderr, "[      ] Error: malloc() failed in kritic_redirect_capture_init()\n");
+        exit(1);
+    }
+
+    /* tmpfile() is already unlinked, nothing is left behind even if the run crashes */
+    capture->spill = tmpfile();
+    if (capture->spill == NULL) {
+        perror("tmpfile failed");
+        exit(1);
+    }
+    capture->length = 0;
+    capture->spilled = 0;
+}
+
+static void kritic_redirect_capture_teardown(kritic_runtime_t* runtime) {
+    kritic_redirect_capture_t* capture = &runtime->redirect->capture;
+
+    if (capture->buffer == NULL) return;
+    fclose(capture->spill);
+    free(capture->buffer);
+    capture->buffer = NULL;
+    capture->spill = NULL;
+}
+
+/* Print the output held back for the current test if show is set, drop it otherwise */
+void kritic_redirect_replay(kritic_runtime_t* runtime, bool show) {
+    kritic_redirect_capture_t* capture = &runtime->redirect->capture;
+    kritic_redirect_record_t record;
 
-            memcpy(line_buffer + line_len, buffer + i, chunk_len);
-            line_len += chunk_len;
-            i += chunk_len;
-
-            if (nl) {
-                line_buffer[line_len] = '\0';
-                runtime->printers.stdout_printer(runtime, &(kritic_redirect_ctx_t) {
-                    .stdout_copy      = state->stdout_copy,
-                    .string           = line_buffer,
-                    .length           = line_len,
-                    .is_part_of_split = is_part_of_split
-                });
-                is_part_of_split = false;
-                line_len = 0;
+    if (capture->buffer == NULL) return;
+
+    if (show && capture->spilled > 0) {
+        char line[KRITIC_REDIRECT_BUFFER_SIZE + 1];
+
+        rewind(capture->spill);
+        for (uint64_t offset = 0; offset < capture->spilled;) {
+            if (fread(&record, sizeof(record), 1, capture->spill) != 1
+                || fread(line, 1, record.length + 1, capture->spill) != record.length + 1) {
+                fprintf(stderr, "[      ] Error: Could not read back spilled output\n");
+                break;
             }
+            kritic_redirect_print(runtime, (kritic_stream_t) record.stream, line, record.length,
+                record.is_part_of_split, record.timestamp_ns);
+            offset += sizeof(record) + record.length + 1;
+        }
+    }
+
+    if (show) {
+        for (uint32_t offset = 0; offset < capture->length;) {
+            memcpy(&record, capture->buffer + offset, sizeof(record));
+            kritic_redirect_print(runtime, (kritic_stream_t) record.stream, capture->buffer + offset + sizeof(record),
+                record.length, record.is_part_of_split, record.timestamp_ns);
+            offset += (uint32_t) sizeof(record) + record.length + 1;
+        }
+    }
+
+    /* The spill file is overwritten by the next test instead of truncated */
+    if (capture->spilled > 0) rewind(capture->spill);
+    capture->length = 0;
+    capture->spilled = 0;
+}
+
+/* Prefix every line and write it out right from the read buffer, only newlines are looked for */
+static void kritic_redirect_forward(kritic_runtime_t* runtime, kritic_stream_t stream, const char* buffer,
+                                    uint32_t bytes_read) {
+    kritic_redirect_line_t* line = &runtime->redirect->lines[stream];
+    kritic_output_slice_t slices[KRITIC_REDIRECT_MAX_SLICES];
+    uint32_t count = 0;
+
+    kritic_output_slice_t label = stream == KRITIC_STREAM_STDERR
+        ? (kritic_output_slice_t) { KRITIC_STDERR_LABEL, sizeof(KRITIC_STDERR_LABEL) - 1 }
+        : (kritic_output_slice_t) { KRITIC_STDOUT_LABEL, sizeof(KRITIC_STDOUT_LABEL) - 1 };
+
+    for (uint32_t i = 0; i < bytes_read;) {
+        const char* nl = memchr(buffer + i, '\n', bytes_read - i);
+        uint32_t chunk_len = nl ? (uint32_t) (nl - (buffer + i) + 1) : (bytes_read - i);
+
+        if (count + 2 > KRITIC_REDIRECT_MAX_SLICES) {
+            kritic_output_write_slices(stream, slices, count);
+            count = 0;
+        }
+
+        /* Same as the default printer, continuations of a line are not prefixed */
+        if (!line->is_part_of_split) slices[count++] = label;
+        slices[count++] = (kritic_output_slice_t) { buffer + i, chunk_len };
+        line->is_part_of_split = nl == NULL;
+        i += chunk_len;
+    }
+
+    if (count > 0) kritic_output_write_slices(stream, slices, count);
+}
+
+/* Split captured bytes into lines, an unfinished line is kept for the next call */
+static void kritic_redirect_process(kritic_runtime_t* runtime, kritic_stream_t stream, const char* buffer,
+                                    uint32_t bytes_read, uint64_t timestamp_ns) {
+    kritic_redirect_line_t* line = &runtime->redirect->lines[stream];
+    const char* nl;
+
+    if (runtime->redirect->forward) {
+        kritic_redirect_forward(runtime, stream, buffer, bytes_read);
+        return;
+    }
+
+    for (uint32_t i = 0; i < bytes_read;) {
+        nl = memchr(buffer + i, '\n', bytes_read - i);
+        uint32_t chunk_len = nl ? (uint32_t) (nl - (buffer + i) + 1) : (bytes_read - i);
+
+        /* Reads are larger than the line buffer */
+        if (chunk_len > KRITIC_REDIRECT_BUFFER_SIZE - 1) {
+            chunk_len = KRITIC_REDIRECT_BUFFER_SIZE - 1;
+            nl = NULL;
+        }
+
+        if (line->length + chunk_len > KRITIC_REDIRECT_BUFFER_SIZE - 1) {
+            line->buffer[line->length] = '\0';
+            kritic_redirect_emit(runtime, stream, line->buffer, line->length, line->is_part_of_split,
+                line->timestamp_ns);
+            line->is_part_of_split = true;
+            line->length = 0;
+        }
+
+        /* A line is stamped with the time its first bytes came in */
+        if (line->length == 0) line->timestamp_ns = timestamp_ns;
+
+        memcpy(line->buffer + line->length, buffer + i, chunk_len);
+        line->length += chunk_len;
+        i += chunk_len;
+
+        if (nl) {
+            line->buffer[line->length] = '\0';
+            kritic_redirect_emit(runtime, stream, line->buffer, line->length, line->is_part_of_split,
+                line->timestamp_ns);
+            line->is_part_of_split = false;
+            line->length = 0;
         }
     }
+}
+
+/* Terminate an unfinished line at the end of a test */
+static void kritic_redirect_finish_line(kritic_runtime_t* runtime, kritic_stream_t stream) {
+    kritic_redirect_line_t* line = &runtime->redirect->lines[stream];
+    uint32_t line_len = line->length;
+
+    if (runtime->redirect->forward) {
+        if (line->is_part_of_split) kritic_output_write(stream, "\n", 1);
+        line->is_part_of_split = false;
+        return;
+    }
+    bool is_part_of_split = line->is_part_of_split;
+
+    line->length = 0;
+    line->is_part_of_split = false;
 
     if (line_len == 0) return;
     if (line_len >= (KRITIC_REDIRECT_BUFFER_SIZE - 1)) {
         /* Send end fragment separately */
-        line_buffer[line_len] = '\0';
-        runtime->printers.stdout_printer(runtime, &(kritic_redirect_ctx_t) {
-            .stdout_copy      = state->stdout_copy,
-            .string           = line_buffer,
-            .length           = line_len,
-            .is_part_of_split = is_part_of_split
-        });
+        line->buffer[line_len] = '\0';
+        kritic_redirect_emit(runtime, stream, line->buffer, line_len, is_part_of_split, line->timestamp_ns);
 
         char end[] = {'\n', '\0'};
-        runtime->printers.stdout_printer(runtime, &(kritic_redirect_ctx_t) {
-            .stdout_copy      = state->stdout_copy,
-            .string           = end,
-            .length           = 1,
-            .is_part_of_split = true
-        });
+        kritic_redirect_emit(runtime, stream, end, 1, true, line->timestamp_ns);
     } else {
-        line_buffer[line_len++] = '\n';
-        line_buffer[line_len] = '\0';
-
-        runtime->printers.stdout_printer(runtime, &(kritic_redirect_ctx_t) {
-            .stdout_copy      = state->stdout_copy,
-            .string           = line_buffer,
-            .length           = line_len,
-            .is_part_of_split = is_part_of_split
-        });
+        line->buffer[line_len++] = '\n';
+        line->buffer[line_len] = '\0';
+        kritic_redirect_emit(runtime, stream, line->buffer, line_len, is_part_of_split, line->timestamp_ns);
     }
 }
 
 #ifdef _WIN32
 
+static void kritic_read_pipe_lines(kritic_runtime_t* runtime, char* buffer) {
+    kritic_redirect_t* state = runtime->redirect;
+    READ_RET_T read_return;
+
+    while ((read_return = _read(state->read_fd, buffer, KRITIC_REDIRECT_READ_SIZE)) > 0) {
+        kritic_redirect_process(runtime, KRITIC_STREAM_STDOUT, buffer, (uint32_t) read_return,
+            kritic_timer_elapsed(&state->timer));
+    }
+    kritic_redirect_finish_line(runtime, KRITIC_STREAM_STDOUT);
+}
+
 static DWORD WINAPI kritic_pipe_reader_thread(LPVOID arg) {
     kritic_runtime_t* runtime = (kritic_runtime_t*)arg;
     kritic_redirect_t* state = runtime->redirect;
 
-    char buffer[KRITIC_REDIRECT_BUFFER_SIZE];
-    char line_buffer[KRITIC_REDIRECT_BUFFER_SIZE];
+    char buffer[KRITIC_REDIRECT_READ_SIZE];
 
     for (;;) {
         WaitForSingleObject(state->event_start, INFINITE);
 
         if (!state->running) break;
-        kritic_read_pipe_lines(runtime, buffer, line_buffer);
+        kritic_read_pipe_lines(runtime, buffer);
 
         SetEvent(state->event_done);
     }
@@ -128,6 +310,7 @@ static DWORD WINAPI kritic_pipe_reader_thread(LPVOID arg) {
 void kritic_redirect_init(kritic_runtime_t* runtime) {
     kritic_redirect_t* state = runtime->redirect;
 
+    kritic_redirect_capture_init(runtime);
     state->event_start = CreateEvent(NULL, FALSE, FALSE, NULL);
     state->event_done = CreateEvent(NULL, FALSE, FALSE, NULL);
     state->thread = CreateThread(NULL, 0, kritic_pipe_reader_thread, runtime, 0, NULL);
@@ -135,6 +318,9 @@ void kritic_redirect_init(kritic_runtime_t* runtime) {
         perror("CreateThread() failed");
         exit(1);
     }
+
+    /* Test output reaches the pipe line by line, set once for the whole run */
+    setvbuf(stdout, NULL, _IOLBF, KRITIC_REDIRECT_BUFFER_SIZE);
 }
 
 void kritic_redirect_teardown(kritic_runtime_t* runtime) {
@@ -148,135 +334,297 @@ void kritic_redirect_teardown(kritic_runtime_t* runtime) {
     CloseHandle(state->thread);
     CloseHandle(state->event_start);
     CloseHandle(state->event_done);
+    kritic_redirect_capture_teardown(runtime);
 }
 
-static void kritic_redirect_start_reader_thread(kritic_redirect_t* state) {
+/* Windows pipes cannot be polled, so every test gets a fresh pipe that is read until EOF (stdout only) */
+void kritic_redirect_start(kritic_runtime_t* runtime) {
+    kritic_redirect_t* state = runtime->redirect;
+    int pipefd[2];
+
+    fflush(stdout);
+    if (kritic_open_pipe(pipefd) == -1) {
+        perror("pipe failed");
+        exit(1);
+    }
+
+    int stdout_copy = _dup(_fileno(stdout));
+    if (stdout_copy == -1) {
+        perror("dup failed");
+        exit(1);
+    }
+
+    state->read_fd        = pipefd[0];
+    state->pipe_write_end = pipefd[1];
+    state->stdout_copy    = stdout_copy;
+    state->running        = 1;
+
+    kritic_timer_start(&state->timer);
+    _dup2(pipefd[1], _fileno(stdout));
+
     ResetEvent(state->event_done);
     SetEvent(state->event_start);
 }
 
-static void kritic_redirect_wait_reader_thread(kritic_redirect_t* state) {
+void kritic_redirect_stop(kritic_runtime_t* runtime) {
+    kritic_redirect_t* state = runtime->redirect;
+
+    fflush(stdout);
+    _close(state->pipe_write_end);
+    _close(_fileno(stdout));
+
     WaitForSingleObject(state->event_done, KRITIC_REDIRECT_TIMEOUT_MS);
+
+    _dup2(state->stdout_copy, _fileno(stdout));
+    _close(state->stdout_copy);
 }
 
 #else // POSIX
 
+/* Drains the run-long capture pipes whenever a test writes to them */
 static void* kritic_pipe_reader_thread(void* arg) {
     kritic_runtime_t* runtime = (kritic_runtime_t*)arg;
     kritic_redirect_t* state = runtime->redirect;
 
-    char buffer[KRITIC_REDIRECT_BUFFER_SIZE];
-    char line_buffer[KRITIC_REDIRECT_BUFFER_SIZE];
+    /* Profiler samples belong to the thread running the tests */
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGPROF);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
 
-    for (;;) {
-        pthread_mutex_lock(&state->lock);
-        while (!state->running && !state->shutting_down)
-            pthread_cond_wait(&state->cond_start, &state->lock);
+    char buffer[KRITIC_REDIRECT_READ_SIZE];
+    struct pollfd pfds[KRITIC_STREAM_COUNT];
+    uint32_t open_streams = KRITIC_STREAM_COUNT;
+
+    for (uint32_t s = 0; s < KRITIC_STREAM_COUNT; ++s) {
+        pfds[s] = (struct pollfd) { .fd = state->read_fds[s], .events = POLLIN, .revents = 0 };
+    }
 
-        if (state->shutting_down) {
-            pthread_mutex_unlock(&state->lock);
+    while (open_streams > 0) {
+        if (poll(pfds, KRITIC_STREAM_COUNT, -1) < 0) {
+            if (errno == EINTR) continue;
             break;
         }
 
+        /* Bytes are either still in a pipe or owned by a busy reader, never neither */
+        pthread_mutex_lock(&state->lock);
+        state->busy = true;
         pthread_mutex_unlock(&state->lock);
 
-        kritic_read_pipe_lines(runtime, buffer, line_buffer);
+        /* Take turns a chunk at a time, so the streams are merged in the order they arrive */
+        bool progress = true;
+        while (progress) {
+            progress = false;
+            for (uint32_t s = 0; s < KRITIC_STREAM_COUNT; ++s) {
+                if (pfds[s].fd < 0) continue;
+
+                ssize_t read_return = _read(pfds[s].fd, buffer, KRITIC_REDIRECT_READ_SIZE);
+                if (read_return > 0) {
+                    kritic_redirect_process(runtime, (kritic_stream_t) s, buffer, (uint32_t) read_return,
+                        kritic_timer_elapsed(&state->timer));
+                    progress = true;
+                } else if (read_return < 0 && errno == EINTR) {
+                    progress = true;
+                } else if (read_return == 0 || errno != EAGAIN) {
+                    /* EOF only happens once the write end is closed at teardown, poll() skips negative fds */
+                    pfds[s].fd = -1;
+                    --open_streams;
+                }
+            }
+        }
 
         pthread_mutex_lock(&state->lock);
-        state->running = false;
-        pthread_cond_signal(&state->cond_done);
+        state->busy = false;
+        pthread_cond_broadcast(&state->cond_idle);
         pthread_mutex_unlock(&state->lock);
     }
 
-    close(state->read_fd);
-    state->read_fd = -1;
-
     return NULL;
 }
 
-void kritic_redirect_init(kritic_runtime_t* runtime) {
-    kritic_redirect_t* state = runtime->redirect;
+static bool kritic_redirect_pending(const kritic_redirect_t* state) {
+    for (uint32_t s = 0; s < KRITIC_STREAM_COUNT; ++s) {
+        int pending = 0;
+        if (ioctl(state->read_fds[s], FIONREAD, &pending) == 0 && pending > 0) return true;
+    }
+    return false;
+}
 
-    pthread_mutex_init(&state->lock, NULL);
-    pthread_cond_init(&state->cond_start, NULL);
-    pthread_cond_init(&state->cond_done, NULL);
+/* Signals that end the process with the test's last words still in the pipes */
+static const int kritic_redirect_fatal_signals[] = { SIGABRT, SIGSEGV, SIGBUS, SIGFPE, SIGILL };
+#define KRITIC_REDIRECT_FATAL_COUNT (sizeof(kritic_redirect_fatal_signals) / sizeof(int))
+static struct sigaction kritic_redirect_previous[KRITIC_REDIRECT_FATAL_COUNT];
 
-    pthread_create(&state->thread, NULL, kritic_pipe_reader_thread, runtime);
-}
+/* Reports of sanitizers that stop the process without a signal */
+void __sanitizer_set_death_callback(void (*callback)(void)) __attribute__((weak));
 
-void kritic_redirect_teardown(kritic_runtime_t* runtime) {
+/* Put stdout and stderr back and print what the test wrote before the process dies, as far as that is still possible */
+static void kritic_redirect_rescue(void) {
+    static volatile sig_atomic_t rescued = 0;
+    kritic_runtime_t* runtime = kritic_get_runtime_state();
     kritic_redirect_t* state = runtime->redirect;
 
-    if (!state) return;
-    pthread_mutex_lock(&state->lock);
-    state->shutting_down = true;
-    pthread_cond_signal(&state->cond_start);
-    pthread_mutex_unlock(&state->lock);
+    if (state == NULL || !state->active || state->pid != getpid() || rescued) return;
+    rescued = 1;
+    state->active = 0;
 
-    pthread_join(state->thread, NULL);
+    _dup2(state->stdout_copy, _fileno(stdout));
+    _dup2(state->stderr_copy, _fileno(stderr));
 
-    pthread_mutex_destroy(&state->lock);
-    pthread_cond_destroy(&state->cond_start);
-    pthread_cond_destroy(&state->cond_done);
-}
+    /* The reader thread keeps running, give it a moment to take the rest out of the pipes */
+    for (int tries = 0; tries < 200; ++tries) {
+        if (!__atomic_load_n(&state->busy, __ATOMIC_ACQUIRE) && !kritic_redirect_pending(state)) break;
+        nanosleep(&(struct timespec) { .tv_sec = 0, .tv_nsec = 1000000 }, NULL);
+    }
 
-static void kritic_redirect_start_reader_thread(kritic_redirect_t* state) {
-    pthread_mutex_lock(&state->lock);
-    state->running = true;
-    pthread_cond_signal(&state->cond_start);
-    pthread_mutex_unlock(&state->lock);
+    for (uint32_t s = 0; s < KRITIC_STREAM_COUNT; ++s) {
+        kritic_redirect_finish_line(runtime, (kritic_stream_t) s);
+    }
+    kritic_redirect_replay(runtime, true);
+    kritic_output_flush(runtime);
 }
 
-static void kritic_redirect_wait_reader_thread(kritic_redirect_t* state) {
-    pthread_mutex_lock(&state->lock);
-    while (state->running)
-        pthread_cond_wait(&state->cond_done, &state->lock);
-    pthread_mutex_unlock(&state->lock);
+/* exit() in the middle of a test, stdio still holds what was not flushed and is only flushed after this */
+static void kritic_redirect_atexit(void) {
+    fflush(stdout);
+    fflush(stderr);
+    kritic_redirect_rescue();
 }
 
-#endif // POSIX
+/* Rescue the output, then let the handler that was installed before deal with the signal */
+static void kritic_redirect_fatal(int signal_number) {
+    kritic_redirect_rescue();
 
-void kritic_redirect_start(kritic_runtime_t* runtime) {
+    for (size_t i = 0; i < KRITIC_REDIRECT_FATAL_COUNT; ++i) {
+        if (kritic_redirect_fatal_signals[i] == signal_number) {
+            sigaction(signal_number, &kritic_redirect_previous[i], NULL);
+        }
+    }
+    /* Blocked until the handler returns, a fault that re-executes is handled the same way */
+    raise(signal_number);
+}
+
+void kritic_redirect_init(kritic_runtime_t* runtime) {
+    static bool atexit_registered = false;
     kritic_redirect_t* state = runtime->redirect;
-    int pipefd[2];
+    FILE* streams[KRITIC_STREAM_COUNT] = { stdout, stderr };
+    int copies[KRITIC_STREAM_COUNT];
 
     fflush(stdout);
-    if (kritic_open_pipe(pipefd) == -1) {
-        perror("pipe failed");
-        exit(1);
+    fflush(stderr);
+    for (uint32_t s = 0; s < KRITIC_STREAM_COUNT; ++s) {
+        int pipefd[2];
+        if (kritic_open_pipe(pipefd) == -1) {
+            perror("pipe failed");
+            exit(1);
+        }
+
+        copies[s] = _dup(_fileno(streams[s]));
+        if (copies[s] == -1) {
+            perror("dup failed");
+            exit(1);
+        }
+
+        /* Tests that exec() must not inherit the capture channel */
+        fcntl(pipefd[0], F_SETFD, FD_CLOEXEC);
+        fcntl(pipefd[1], F_SETFD, FD_CLOEXEC);
+        fcntl(copies[s], F_SETFD, FD_CLOEXEC);
+        fcntl(pipefd[0], F_SETFL, fcntl(pipefd[0], F_GETFL) | O_NONBLOCK);
+
+        state->read_fds[s]        = pipefd[0];
+        state->pipe_write_ends[s] = pipefd[1];
+        state->lines[s].length    = 0;
     }
 
-    int stdout_copy = _dup(_fileno(stdout));
-    if (stdout_copy == -1) {
-        perror("dup failed");
-        exit(1);
+    state->stdout_copy = copies[KRITIC_STREAM_STDOUT];
+    state->stderr_copy = copies[KRITIC_STREAM_STDERR];
+    state->busy        = false;
+
+    kritic_redirect_capture_init(runtime);
+    pthread_mutex_init(&state->lock, NULL);
+    pthread_cond_init(&state->cond_idle, NULL);
+
+    pthread_create(&state->thread, NULL, kritic_pipe_reader_thread, runtime);
+
+    state->active = 0;
+    state->pid = getpid();
+    struct sigaction fatal = { .sa_handler = kritic_redirect_fatal };
+    sigemptyset(&fatal.sa_mask);
+    for (size_t i = 0; i < KRITIC_REDIRECT_FATAL_COUNT; ++i) {
+        sigaction(kritic_redirect_fatal_signals[i], &fatal, &kritic_redirect_previous[i]);
+    }
+    if (__sanitizer_set_death_callback != NULL) __sanitizer_set_death_callback(kritic_redirect_rescue);
+    if (!atexit_registered) {
+        atexit(kritic_redirect_atexit);
+        atexit_registered = true;
     }
 
-    state->read_fd        = pipefd[0];
-    state->pipe_write_end = pipefd[1];
-    state->stdout_copy    = stdout_copy;
-    state->running        = 1;
+    /* Test output reaches the pipe line by line, set once for the whole run */
+    setvbuf(stdout, NULL, _IOLBF, KRITIC_REDIRECT_BUFFER_SIZE);
+}
 
-    _dup2(pipefd[1], _fileno(stdout));
-    setvbuf(stdout, NULL, _IONBF, 0);
+void kritic_redirect_teardown(kritic_runtime_t* runtime) {
+    kritic_redirect_t* state = runtime->redirect;
+
+    if (!state) return;
+
+    if (__sanitizer_set_death_callback != NULL) __sanitizer_set_death_callback(NULL);
+    for (size_t i = 0; i < KRITIC_REDIRECT_FATAL_COUNT; ++i) {
+        sigaction(kritic_redirect_fatal_signals[i], &kritic_redirect_previous[i], NULL);
+    }
 
-    kritic_redirect_start_reader_thread(state);
+    /* The reader thread exits on EOF */
+    for (uint32_t s = 0; s < KRITIC_STREAM_COUNT; ++s) {
+        _close(state->pipe_write_ends[s]);
+    }
+    pthread_join(state->thread, NULL);
+
+    for (uint32_t s = 0; s < KRITIC_STREAM_COUNT; ++s) {
+        _close(state->read_fds[s]);
+        state->read_fds[s] = -1;
+    }
+    _close(state->stdout_copy);
+    _close(state->stderr_copy);
+
+    pthread_mutex_destroy(&state->lock);
+    pthread_cond_destroy(&state->cond_idle);
+    kritic_redirect_capture_teardown(runtime);
 }
 
-void kritic_redirect_stop(kritic_runtime_t* runtime) {
+/* Only stdout and stderr are switched over, the pipes and the reader thread live for the whole run */
+void kritic_redirect_start(kritic_runtime_t* runtime) {
     kritic_redirect_t* state = runtime->redirect;
 
     fflush(stdout);
-    _close(state->pipe_write_end);
-    _close(_fileno(stdout));
+    fflush(stderr);
+    kritic_timer_start(&state->timer);
+    _dup2(state->pipe_write_ends[KRITIC_STREAM_STDOUT], _fileno(stdout));
+    _dup2(state->pipe_write_ends[KRITIC_STREAM_STDERR], _fileno(stderr));
+    state->active = 1;
+}
 
-    kritic_redirect_wait_reader_thread(state);
+void kritic_redirect_stop(kritic_runtime_t* runtime) {
+    kritic_redirect_t* state = runtime->redirect;
 
-    _dup2(state->stdout_copy, _fileno(stdout));
-    setvbuf(stdout, NULL, _IOLBF, 1024);
     fflush(stdout);
+    fflush(stderr);
+    state->active = 0;
+    _dup2(state->stdout_copy, _fileno(stdout));
+    _dup2(state->stderr_copy, _fileno(stderr));
 
-    _close(state->stdout_copy);
+    /* Wait until everything the test wrote went through the printer, free if it wrote nothing */
+    pthread_mutex_lock(&state->lock);
+    while (state->busy || kritic_redirect_pending(state)) {
+        pthread_cond_wait(&state->cond_idle, &state->lock);
+    }
+
+    /* The reader is idle and no new bytes can arrive, so its line buffers are ours */
+    for (uint32_t s = 0; s < KRITIC_STREAM_COUNT; ++s) {
+        kritic_redirect_finish_line(runtime, (kritic_stream_t) s);
+    }
+    pthread_mutex_unlock(&state->lock);
 }
 
+#endif // POSIX
+
 #endif // !KRITIC_DISABLE_REDIRECT
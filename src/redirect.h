@@ -3,9 +3,19 @@
 
 #define KRITIC_REDIRECT_TIMEOUT_MS 1000
 #define KRITIC_REDIRECT_BUFFER_SIZE 4096
+/* Bytes taken out of a capture pipe at once */
+#define KRITIC_REDIRECT_READ_SIZE 65536
+/* Prefixes and line slices handed to the output buffer at once by the forwarding fast path */
+#define KRITIC_REDIRECT_MAX_SLICES 256
+/* Output held back in failure-only mode beyond this spills to a temporary file */
+#define KRITIC_REDIRECT_CAPTURE_SIZE 65536
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
+
+#include "output.h"
+#include "timer.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -18,8 +28,17 @@ typedef struct {
     char* string;
     uint32_t length;
     bool is_part_of_split;
+    /* Stream the test wrote the line to */
+    kritic_stream_t stream;
+    /* Time since the start of the test when the line arrived */
+    uint64_t timestamp_ns;
 } kritic_redirect_ctx_t;
 
+typedef struct {
+    /* Only print the output of tests that failed or were skipped */
+    bool failure_only;
+} kritic_redirect_config_t;
+
 #ifdef KRITIC_DISABLE_REDIRECT
 
 typedef struct {
@@ -31,6 +50,31 @@ typedef struct {
 
 #else // !KRITIC_DISABLE_REDIRECT
 
+/* Unfinished line of one captured stream */
+typedef struct {
+    char buffer[KRITIC_REDIRECT_BUFFER_SIZE];
+    uint32_t length;
+    uint64_t timestamp_ns;
+    bool is_part_of_split;
+} kritic_redirect_line_t;
+
+/* Header of a held back line, followed by the line and its terminator */
+typedef struct {
+    uint64_t timestamp_ns;
+    uint32_t length;
+    uint8_t stream;
+    bool is_part_of_split;
+} kritic_redirect_record_t;
+
+/* Output of the current test held back until its result is known */
+typedef struct {
+    char* buffer;
+    uint32_t length;
+    /* Unlinked temporary file taking whatever does not fit into the buffer */
+    FILE* spill;
+    uint64_t spilled;
+} kritic_redirect_capture_t;
+
 #ifdef _WIN32
 #include <io.h>
 #include <windows.h>
@@ -45,10 +89,18 @@ typedef struct {
     int read_fd;
     int stdout_copy;
     int pipe_write_end;
+    /* Start of the current test, for line timestamps */
+    kritic_timer_t timer;
+    /* Unfinished line of the current test, only stdout is captured */
+    kritic_redirect_line_t lines[KRITIC_STREAM_COUNT];
+    kritic_redirect_capture_t capture;
+    /* The default stdout printer is used, lines go straight from the read buffer to the output */
+    bool forward;
 } kritic_redirect_t;
 
 #else // POSIX
 #include <pthread.h>
+#include <signal.h>
 #include <unistd.h>
 
 #define kritic_open_pipe(pipefd) pipe(pipefd)
@@ -63,13 +115,25 @@ typedef struct {
 typedef struct {
     pthread_t thread;
     pthread_mutex_t lock;
-    pthread_cond_t cond_start;
-    pthread_cond_t cond_done;
-    int read_fd;
-    int pipe_write_end;
+    pthread_cond_t cond_idle;
+    /* One pipe per captured stream */
+    int read_fds[KRITIC_STREAM_COUNT];
+    int pipe_write_ends[KRITIC_STREAM_COUNT];
     int stdout_copy;
-    bool running;
-    bool shutting_down;
+    int stderr_copy;
+    /* The reader thread is processing bytes it took out of the pipes */
+    bool busy;
+    /* Start of the current test, for line timestamps */
+    kritic_timer_t timer;
+    /* Unfinished line of the current test, per stream */
+    kritic_redirect_line_t lines[KRITIC_STREAM_COUNT];
+    kritic_redirect_capture_t capture;
+    /* The default stdout printer is used, lines go straight from the read buffer to the output */
+    bool forward;
+    /* stdout and stderr point into the pipes, so a crash has to hand back what the test wrote */
+    volatile sig_atomic_t active;
+    /* Process that owns the reader thread, forked tests leave the rescue to it */
+    pid_t pid;
 } kritic_redirect_t;
 
 #endif // POSIX
@@ -80,6 +144,8 @@ void kritic_redirect_init(struct kritic_runtime_t* runtime);
 void kritic_redirect_teardown(struct kritic_runtime_t* runtime);
 void kritic_redirect_start(struct kritic_runtime_t* runtime);
 void kritic_redirect_stop(struct kritic_runtime_t* runtime);
+void kritic_redirect_replay(struct kritic_runtime_t* runtime, bool show);
+void kritic_redirect_set_failure_only(bool enabled);
 
 #ifdef __cplusplus
 } // extern "C"
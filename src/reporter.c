@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../kritic.h"
+
+static kritic_reporters_t kritic_reporters_storage;
+
+/* Register printers that get every event next to the active ones, NULL fields opt out of an event */
+void kritic_add_reporter(const kritic_printers_t* reporter) {
+    kritic_reporters_t* reporters = &kritic_reporters_storage;
+    if (reporter == NULL) return;
+
+    if (reporters->registered_count == KRITIC_MAX_REPORTERS) {
+        fprintf(stderr, "[      ] Error: Too many reporters, at most %d can be registered\n", KRITIC_MAX_REPORTERS);
+        exit(1);
+    }
+    reporters->registered[reporters->registered_count++] = reporter;
+}
+
+void kritic_remove_reporter(const kritic_printers_t* reporter) {
+    kritic_reporters_t* reporters = &kritic_reporters_storage;
+
+    for (uint32_t r = 0; r < reporters->registered_count; ++r) {
+        if (reporters->registered[r] != reporter) continue;
+
+        for (uint32_t i = r + 1; i < reporters->registered_count; ++i) {
+            reporters->registered[i - 1] = reporters->registered[i];
+        }
+        --reporters->registered_count;
+        return;
+    }
+}
+
+static void kritic_reporters_assert(
+    const kritic_context_t* ctx,
+    bool passed,
+    long long actual,
+    long long expected,
+    const char* actual_expr,
+    const char* expected_expr,
+    kritic_assert_type_t assert_type
+) {
+    for (kritic_assert_printer_fn* fn = kritic_reporters_storage.assert_printers; *fn != NULL; ++fn) {
+        (*fn)(ctx, passed, actual, expected, actual_expr, expected_expr, assert_type);
+    }
+}
+
+static void kritic_reporters_pre_test(kritic_runtime_t* state) {
+    for (kritic_pre_test_printer_fn* fn = kritic_reporters_storage.pre_test_printers; *fn != NULL; ++fn) {
+        (*fn)(state);
+    }
+}
+
+static void kritic_reporters_post_test(kritic_runtime_t* state) {
+    for (kritic_post_test_printer_fn* fn = kritic_reporters_storage.post_test_printers; *fn != NULL; ++fn) {
+        (*fn)(state);
+    }
+}
+
+static void kritic_reporters_summary(kritic_runtime_t* state) {
+    for (kritic_summary_printer_fn* fn = kritic_reporters_storage.summary_printers; *fn != NULL; ++fn) {
+        (*fn)(state);
+    }
+}
+
+static void kritic_reporters_init_event(kritic_runtime_t* state) {
+    for (kritic_init_printer_fn* fn = kritic_reporters_storage.init_printers; *fn != NULL; ++fn) {
+        (*fn)(state);
+    }
+}
+
+/* Called from the redirect reader thread, the arrays do not change while tests run */
+static void kritic_reporters_stdout(kritic_runtime_t* state, kritic_redirect_ctx_t* redir_ctx) {
+    for (kritic_stdout_printer_fn* fn = kritic_reporters_storage.stdout_printers; *fn != NULL; ++fn) {
+        (*fn)(state, redir_ctx);
+    }
+}
+
+static void kritic_reporters_skip(kritic_runtime_t* state, const kritic_context_t* ctx) {
+    for (kritic_skip_printer_fn* fn = kritic_reporters_storage.skip_printers; *fn != NULL; ++fn) {
+        (*fn)(state, ctx);
+    }
+}
+
+static void kritic_reporters_dep_fail(kritic_runtime_t* state, kritic_test_t* test, kritic_test_t* dep_test) {
+    for (kritic_dep_fail_printer_fn* fn = kritic_reporters_storage.dep_fail_printers; *fn != NULL; ++fn) {
+        (*fn)(state, test, dep_test);
+    }
+}
+
+static void kritic_reporters_bench(kritic_runtime_t* state) {
+    for (kritic_bench_printer_fn* fn = kritic_reporters_storage.bench_printers; *fn != NULL; ++fn) {
+        (*fn)(state);
+    }
+}
+
+/* Collect the reporters handling an event, a single one is called directly instead of through the loop */
+#define KRITIC_REPORTERS_COLLECT(event, dispatcher, fn_type) do {                                   \
+    reporters->event##_count = 0;                                                                   \
+    for (uint32_t r = 0; r < source_count; ++r) {                                                   \
+        fn_type fn = sources[r]->event##_printer;                                                   \
+        if (fn == NULL || fn == KRITIC_NOOP(fn_type)) continue;                                     \
+        reporters->event##_printers[reporters->event##_count++] = fn;                               \
+    }                                                                                               \
+    reporters->event##_printers[reporters->event##_count] = NULL;                                   \
+    if (reporters->event##_count == 0) {                                                            \
+        runtime->printers.event##_printer = KRITIC_NOOP(fn_type);                                   \
+    } else if (reporters->event##_count == 1) {                                                     \
+        runtime->printers.event##_printer = reporters->event##_printers[0];                         \
+    } else {                                                                                        \
+        runtime->printers.event##_printer = &dispatcher;                                            \
+    }                                                                                               \
+} while (0)
+
+void kritic_reporters_init(kritic_runtime_t* runtime) {
+    kritic_reporters_t* reporters = &kritic_reporters_storage;
+    if (reporters->registered_count == 0) return;
+
+    reporters->primary = runtime->printers;
+
+    const kritic_printers_t* sources[KRITIC_MAX_REPORTERS + 1];
+    uint32_t source_count = 0;
+    sources[source_count++] = &reporters->primary;
+    for (uint32_t r = 0; r < reporters->registered_count; ++r) {
+        sources[source_count++] = reporters->registered[r];
+    }
+
+    KRITIC_REPORTERS_COLLECT(assert, kritic_reporters_assert, kritic_assert_printer_fn);
+    KRITIC_REPORTERS_COLLECT(pre_test, kritic_reporters_pre_test, kritic_pre_test_printer_fn);
+    KRITIC_REPORTERS_COLLECT(post_test, kritic_reporters_post_test, kritic_post_test_printer_fn);
+    KRITIC_REPORTERS_COLLECT(summary, kritic_reporters_summary, kritic_summary_printer_fn);
+    KRITIC_REPORTERS_COLLECT(init, kritic_reporters_init_event, kritic_init_printer_fn);
+    KRITIC_REPORTERS_COLLECT(stdout, kritic_reporters_stdout, kritic_stdout_printer_fn);
+    KRITIC_REPORTERS_COLLECT(skip, kritic_reporters_skip, kritic_skip_printer_fn);
+    KRITIC_REPORTERS_COLLECT(dep_fail, kritic_reporters_dep_fail, kritic_dep_fail_printer_fn);
+    KRITIC_REPORTERS_COLLECT(bench, kritic_reporters_bench, kritic_bench_printer_fn);
+
+    runtime->reporters = reporters;
+}
+
+void kritic_reporters_teardown(kritic_runtime_t* runtime) {
+    kritic_reporters_t* reporters = runtime->reporters;
+    if (reporters == NULL) return;
+
+    runtime->printers = reporters->primary;
+    runtime->reporters = NULL;
+}
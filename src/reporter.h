@@ -0,0 +1,56 @@
+#ifndef KRITIC_REPORTER_H
+#define KRITIC_REPORTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "defaults.h"
+
+/* Reporters registered on top of the printers, which always count as the first one */
+#define KRITIC_MAX_REPORTERS 8
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct kritic_runtime_t;
+
+/* One array per event with only the reporters that handle it, so skipped reporters cost nothing */
+typedef struct {
+    const kritic_printers_t* registered[KRITIC_MAX_REPORTERS];
+    uint32_t registered_count;
+
+    kritic_assert_printer_fn assert_printers[KRITIC_MAX_REPORTERS + 1];
+    kritic_pre_test_printer_fn pre_test_printers[KRITIC_MAX_REPORTERS + 1];
+    kritic_post_test_printer_fn post_test_printers[KRITIC_MAX_REPORTERS + 1];
+    kritic_summary_printer_fn summary_printers[KRITIC_MAX_REPORTERS + 1];
+    kritic_init_printer_fn init_printers[KRITIC_MAX_REPORTERS + 1];
+    kritic_stdout_printer_fn stdout_printers[KRITIC_MAX_REPORTERS + 1];
+    kritic_skip_printer_fn skip_printers[KRITIC_MAX_REPORTERS + 1];
+    kritic_dep_fail_printer_fn dep_fail_printers[KRITIC_MAX_REPORTERS + 1];
+    kritic_bench_printer_fn bench_printers[KRITIC_MAX_REPORTERS + 1];
+
+    uint32_t assert_count;
+    uint32_t pre_test_count;
+    uint32_t post_test_count;
+    uint32_t summary_count;
+    uint32_t init_count;
+    uint32_t stdout_count;
+    uint32_t skip_count;
+    uint32_t dep_fail_count;
+    uint32_t bench_count;
+
+    /* Printers replaced by the dispatchers, restored on teardown */
+    kritic_printers_t primary;
+} kritic_reporters_t;
+
+void kritic_add_reporter(const kritic_printers_t* reporter);
+void kritic_remove_reporter(const kritic_printers_t* reporter);
+void kritic_reporters_init(struct kritic_runtime_t* runtime);
+void kritic_reporters_teardown(struct kritic_runtime_t* runtime);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // KRITIC_REPORTER_H
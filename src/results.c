@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../kritic.h"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+static kritic_results_t kritic_results_storage;
+
+/* Process wide counters, Windows only gets durations */
+static void kritic_results_counters(uint64_t* cpu_ns, uint64_t* minor_faults, uint64_t* major_faults) {
+#ifdef _WIN32
+    *cpu_ns = 0;
+    *minor_faults = 0;
+    *major_faults = 0;
+#else // POSIX
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        *cpu_ns = 0;
+        *minor_faults = 0;
+        *major_faults = 0;
+        return;
+    }
+
+    *cpu_ns = (uint64_t) usage.ru_utime.tv_sec * 1000000000u + (uint64_t) usage.ru_utime.tv_usec * 1000u
+        + (uint64_t) usage.ru_stime.tv_sec * 1000000000u + (uint64_t) usage.ru_stime.tv_usec * 1000u;
+    *minor_faults = (uint64_t) usage.ru_minflt;
+    *major_faults = (uint64_t) usage.ru_majflt;
+#endif // POSIX
+}
+
+static uint64_t kritic_results_log_offset(kritic_runtime_t* runtime) {
+    return runtime->binlog != NULL ? runtime->binlog->header->length : 0;
+}
+
+/* Results of the last run, valid until the next one starts */
+const kritic_result_t* kritic_get_results(size_t* count) {
+    kritic_results_t* results = kritic_get_runtime_state()->results;
+
+    if (results == NULL) {
+        if (count != NULL) *count = 0;
+        return NULL;
+    }
+    if (count != NULL) *count = results->count;
+    return results->entries;
+}
+
+const kritic_result_t* kritic_find_result(const char* suite, const char* name) {
+    size_t count;
+    const kritic_result_t* entries = kritic_get_results(&count);
+
+    for (size_t i = 0; i < count; ++i) {
+        if (strcmp(entries[i].name, name) == 0 && strcmp(entries[i].suite, suite) == 0) return &entries[i];
+    }
+    return NULL;
+}
+
+void kritic_result_stats(kritic_result_stats_t* stats) {
+    size_t count;
+    const kritic_result_t* entries = kritic_get_results(&count);
+
+    memset(stats, 0, sizeof(kritic_result_stats_t));
+    for (size_t i = 0; i < count; ++i) {
+        const kritic_result_t* result = &entries[i];
+
+        ++stats->total;
+        switch (result->status) {
+            case KRITIC_PASSED:     ++stats->passed;     break;
+            case KRITIC_FAILED:     ++stats->failed;     break;
+            case KRITIC_SKIPPED:    ++stats->skipped;    break;
+            case KRITIC_DEP_FAILED: ++stats->dep_failed; break;
+            default: break;
+        }
+        stats->assert_count += (uint64_t) result->assert_count;
+        stats->asserts_failed += (uint64_t) result->asserts_failed;
+        if (result->duration_ns != UINT64_MAX) stats->duration_ns += result->duration_ns;
+        stats->cpu_ns += result->cpu_ns;
+    }
+}
+
+/* Fill slowest with up to n results, longest first, returns how many were written */
+size_t kritic_slowest_results(const kritic_result_t** slowest, size_t n) {
+    size_t count;
+    const kritic_result_t* entries = kritic_get_results(&count);
+    size_t filled = 0;
+
+    if (n == 0) return 0;
+    for (size_t i = 0; i < count; ++i) {
+        const kritic_result_t* result = &entries[i];
+        if (result->cached || result->duration_ns == UINT64_MAX) continue;
+        if (filled == n && result->duration_ns <= slowest[n - 1]->duration_ns) continue;
+
+        /* Insertion into the short sorted list, n is expected to be small */
+        size_t position = filled < n ? filled++ : n - 1;
+        while (position > 0 && slowest[position - 1]->duration_ns < result->duration_ns) {
+            slowest[position] = slowest[position - 1];
+            --position;
+        }
+        slowest[position] = result;
+    }
+    return filled;
+}
+
+void kritic_results_init(kritic_runtime_t* runtime) {
+    kritic_results_t* results = &kritic_results_storage;
+    size_t needed = runtime->test_count;
+
+    results->count = 0;
+    if (needed > results->capacity) {
+        kritic_result_t* entries = realloc(results->entries, needed * sizeof(kritic_result_t));
+        if (entries == NULL) {
+            fprintf(stderr, "[      ] Error: realloc() failed in kritic_results_init()\n");
+            exit(1);
+        }
+        results->entries = entries;
+        results->capacity = needed;
+    }
+
+    runtime->results = results;
+}
+
+void kritic_results_start(kritic_runtime_t* runtime) {
+    kritic_results_t* results = runtime->results;
+
+    kritic_results_counters(&results->start_cpu_ns, &results->start_minor_faults, &results->start_major_faults);
+    results->start_log_offset = kritic_results_log_offset(runtime);
+}
+
+void kritic_results_record(kritic_runtime_t* runtime, const kritic_test_t* test) {
+    kritic_results_t* results = runtime->results;
+    const kritic_test_state_t* test_state = runtime->test_state;
+    if (results->count == results->capacity) return;
+
+    uint64_t cpu_ns, minor_faults, major_faults;
+    kritic_results_counters(&cpu_ns, &minor_faults, &major_faults);
+    uint64_t log_offset = kritic_results_log_offset(runtime);
+
+    results->entries[results->count++] = (kritic_result_t) {
+        .suite          = test->suite,
+        .name           = test->name,
+        .file           = test->file,
+        .line           = (uint32_t) test->line,
+        .status         = test->status,
+        .assert_count   = test_state->assert_count,
+        .asserts_failed = test_state->asserts_failed,
+        .duration_ns    = test_state->duration_ns,
+        .cached         = test_state->cached,
+        .cpu_ns         = cpu_ns - results->start_cpu_ns,
+        .minor_faults   = (uint32_t) (minor_faults - results->start_minor_faults),
+        .major_faults   = (uint32_t) (major_faults - results->start_major_faults),
+        .log_offset     = results->start_log_offset,
+        .log_length     = log_offset - results->start_log_offset
+    };
+}
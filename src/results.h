@@ -0,0 +1,75 @@
+#ifndef KRITIC_RESULTS_H
+#define KRITIC_RESULTS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "scheduler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct kritic_runtime_t;
+
+/* Outcome of one test, kept in queue order after the run */
+typedef struct {
+    /* Registration strings are literals, so they outlive the freed tests */
+    const char* suite;
+    const char* name;
+    const char* file;
+    uint32_t line;
+    kritic_test_status_t status;
+    int32_t assert_count;
+    int32_t asserts_failed;
+    uint64_t duration_ns;
+    /* Replayed from the result cache, the test did not run and its duration is 0 */
+    bool cached;
+    /* User and system time of the whole process while the test ran */
+    uint64_t cpu_ns;
+    uint32_t minor_faults;
+    uint32_t major_faults;
+    /* Records of the test in the binary result log, 0 if there is no log */
+    uint64_t log_offset;
+    uint64_t log_length;
+} kritic_result_t;
+
+/* Totals over all results, computed in one pass */
+typedef struct {
+    uint32_t total;
+    uint32_t passed;
+    uint32_t failed;
+    uint32_t skipped;
+    uint32_t dep_failed;
+    uint64_t assert_count;
+    uint64_t asserts_failed;
+    uint64_t duration_ns;
+    uint64_t cpu_ns;
+} kritic_result_stats_t;
+
+typedef struct {
+    kritic_result_t* entries;
+    size_t count;
+    size_t capacity;
+    /* Counters at the start of the current test */
+    uint64_t start_cpu_ns;
+    uint64_t start_minor_faults;
+    uint64_t start_major_faults;
+    uint64_t start_log_offset;
+} kritic_results_t;
+
+const kritic_result_t* kritic_get_results(size_t* count);
+const kritic_result_t* kritic_find_result(const char* suite, const char* name);
+void kritic_result_stats(kritic_result_stats_t* stats);
+size_t kritic_slowest_results(const kritic_result_t** slowest, size_t n);
+
+void kritic_results_init(struct kritic_runtime_t* runtime);
+void kritic_results_start(struct kritic_runtime_t* runtime);
+void kritic_results_record(struct kritic_runtime_t* runtime, const kritic_test_t* test);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // KRITIC_RESULTS_H
@@ -26,10 +26,19 @@ void kritic_register(const kritic_context_t* ctx, kritic_test_fn fn, size_t attr
         .line         = ctx->line,
         .fn           = fn,
         .dependencies = { 0 },
+        .benchmark    = NULL,
+        .latency_budgets = { 0 },
+        .cold_cache   = NULL,
+        .variants     = { 0 },
+        .no_cache     = false,
+        .fixture      = NULL,
+        .uses         = { 0 },
+        .resources    = { 0 },
         .status       = KRITIC_REGISTERED
     };
 
     kritic_parse_attr_data(test_metadata, attr_count, attrs);
+    kritic_index_add(&kritic_state->index, test_metadata);
     *test_node = (kritic_node_t) { .node = NULL, .data = test_metadata };
 
     if (kritic_state->first_node == NULL) {
@@ -41,39 +50,170 @@ void kritic_register(const kritic_context_t* ctx, kritic_test_fn fn, size_t attr
     kritic_state->test_count++;
 }
 
-static inline size_t find_dep_index(const kritic_test_index_t* map, size_t count, kritic_test_index_t* dep, bool* invalid) {
-    (*invalid) = false;
+/* Queue position of a test, sorted by address so dependencies resolve with a binary search */
+typedef struct {
+    const kritic_test_t* test;
+    size_t index;
+} kritic_queue_position_t;
+
+static int kritic_compare_positions(const void* a, const void* b) {
+    uintptr_t left = (uintptr_t) ((const kritic_queue_position_t*) a)->test;
+    uintptr_t right = (uintptr_t) ((const kritic_queue_position_t*) b)->test;
+    return (left > right) - (left < right);
+}
+
+static bool kritic_find_position(const kritic_queue_position_t* positions, size_t count, const kritic_test_t* test,
+                                 size_t* index) {
+    size_t low = 0, high = count;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if ((uintptr_t) positions[middle].test < (uintptr_t) test) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    if (low == count || positions[low].test != test) return false;
+    *index = positions[low].index;
+    return true;
+}
+
+/* Ready tests by priority and level */
+typedef struct {
+    size_t* heap;
+    size_t size;
+    /* Own duration plus the longest chain of tests waiting on the test */
+    uint64_t* levels;
+    /* The test or one waiting on it is new, failed last time or has a changed source file */
+    bool* urgent;
+} kritic_ready_t;
+
+/* Urgent tests first, then the highest level */
+static bool kritic_level_before(const kritic_ready_t* ready, size_t a, size_t b) {
+    if (ready->urgent[a] != ready->urgent[b]) return ready->urgent[a];
+    return ready->levels[a] != ready->levels[b] ? ready->levels[a] > ready->levels[b] : a < b;
+}
+
+static void kritic_level_push(kritic_ready_t* ready, size_t test) {
+    size_t* heap = ready->heap;
+    size_t i = ready->size++;
+    while (i > 0 && kritic_level_before(ready, test, heap[(i - 1) / 2])) {
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i] = test;
+}
+
+static size_t kritic_level_pop(kritic_ready_t* ready) {
+    size_t* heap = ready->heap;
+    size_t top = heap[0];
+    size_t last = heap[--ready->size];
+    size_t i = 0;
+
+    for (size_t child = 1; child < ready->size; child = 2 * i + 1) {
+        if (child + 1 < ready->size && kritic_level_before(ready, heap[child + 1], heap[child])) ++child;
+        if (!kritic_level_before(ready, heap[child], last)) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = last;
+    return top;
+}
+
+/* Reorder a topological order so likely failures go first, then the longest critical path by recorded durations */
+static void kritic_order_by_critical_path(kritic_runtime_t* runtime, const size_t* first, const size_t* dependents,
+                                          size_t* order) {
+    size_t count = runtime->test_count;
+    size_t* waiting = calloc(count + 1, sizeof(size_t));
+    kritic_ready_t ready = {
+        .heap   = malloc((count + 1) * sizeof(size_t)),
+        .size   = 0,
+        .levels = malloc((count + 1) * sizeof(uint64_t)),
+        .urgent = malloc((count + 1) * sizeof(bool))
+    };
+    uint64_t* levels = ready.levels;
+
+    if (!waiting || !ready.heap || !levels || !ready.urgent) {
+        fprintf(stderr, "[      ] Error: Memory allocation failed during queue sorting\n");
+        exit(1);
+    }
+
+    /* Tests without a recorded duration count as the mean of the ones that have one */
+    uint64_t known_total = 0;
+    size_t known_count = 0;
     for (size_t i = 0; i < count; ++i) {
-        if (strcmp(map[i].suite, dep->suite) == 0
-            && strcmp(map[i].name, dep->name) == 0) return map[i].index;
+        if (kritic_history_duration(runtime->history, runtime->queue[i], &levels[i])) {
+            known_total += levels[i];
+            ++known_count;
+        } else {
+            levels[i] = UINT64_MAX;
+        }
+        ready.urgent[i] = kritic_history_suspect(runtime->history, runtime->queue[i]);
     }
+    uint64_t mean = known_count > 0 ? known_total / known_count : 1;
 
-    (*invalid) = true;
-    return 0;
+    /* Backwards through the topological order, every dependent has its level before its dependencies */
+    for (size_t k = count; k-- > 0;) {
+        size_t i = order[k];
+        uint64_t longest = 0;
+
+        if (levels[i] == UINT64_MAX) levels[i] = mean;
+        for (size_t j = first[i]; j < first[i + 1]; ++j) {
+            if (levels[dependents[j]] > longest) longest = levels[dependents[j]];
+            ready.urgent[i] = ready.urgent[i] || ready.urgent[dependents[j]];
+        }
+        levels[i] += longest;
+    }
+
+    for (size_t j = 0; j < first[count]; ++j) {
+        ++waiting[dependents[j]];
+    }
+
+    size_t sorted_index = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (waiting[i] == 0) kritic_level_push(&ready, i);
+    }
+    while (ready.size > 0) {
+        size_t i = kritic_level_pop(&ready);
+        order[sorted_index++] = i;
+
+        for (size_t j = first[i]; j < first[i + 1]; ++j) {
+            if (--waiting[dependents[j]] == 0) kritic_level_push(&ready, dependents[j]);
+        }
+    }
+
+    free(waiting);
+    free(ready.heap);
+    free(ready.levels);
+    free(ready.urgent);
 }
 
+/* Order the queue so that dependencies run first, O(n log n) in the number of tests */
 static void kritic_sort_queue(kritic_runtime_t* runtime) {
     size_t count = runtime->test_count;
 
-    bool invalid;
-    int* indegree            = malloc(count * sizeof(int));
-    size_t* queue            = malloc(count * sizeof(size_t));
-    kritic_test_index_t* map = malloc(count * sizeof(kritic_test_index_t));
-    kritic_test_t** sorted   = malloc((count + 1) * sizeof(kritic_test_t*));
+    int* indegree                      = malloc(count * sizeof(int));
+    size_t* queue                      = malloc(count * sizeof(size_t));
+    kritic_queue_position_t* positions = malloc(count * sizeof(kritic_queue_position_t));
+    /* Dependents of every test, dependents[first[i]..first[i + 1]) wait for test i */
+    size_t* first                      = calloc(count + 1, sizeof(size_t));
+    size_t* dependents                 = malloc((count * KRITIC_MAX_DEPENDENCIES + 1) * sizeof(size_t));
+    size_t* dep_indices                = malloc((count * KRITIC_MAX_DEPENDENCIES + 1) * sizeof(size_t));
+    kritic_test_t** sorted             = malloc((count + 1) * sizeof(kritic_test_t*));
 
-    if (!indegree || !queue || !sorted || !map) {
+    if (!indegree || !queue || !positions || !first || !dependents || !dep_indices || !sorted) {
         fprintf(stderr, "[      ] Error: Memory allocation failed during queue sorting\n");
         exit(1);
     }
 
     for (size_t i = 0; i < count; ++i) {
-        map[i].suite = runtime->queue[i]->suite;
-        map[i].name = runtime->queue[i]->name;
-        map[i].index = i;
+        positions[i] = (kritic_queue_position_t) { .test = runtime->queue[i], .index = i };
         indegree[i] = 0;
     }
+    qsort(positions, count, sizeof(kritic_queue_position_t), kritic_compare_positions);
 
-    /* Perform basic checks */
+    /* Perform basic checks and resolve dependencies through the index */
     for (size_t i = 0; i < count; ++i) {
         for (size_t d = 0; runtime->queue[i]->dependencies[d]; ++d) {
             kritic_test_index_t* dep = runtime->queue[i]->dependencies[d];
@@ -84,20 +224,37 @@ static void kritic_sort_queue(kritic_runtime_t* runtime) {
                 exit(1);
             }
 
-            size_t dep_index = find_dep_index(map, count, dep, &invalid);
-            if (invalid == true) {
+            kritic_test_t* dep_test = kritic_index_find(&runtime->index, dep->suite, strlen(dep->suite), dep->name,
+                strlen(dep->name));
+            size_t dep_index;
+            if (dep_test == NULL || !kritic_find_position(positions, count, dep_test, &dep_index)) {
                 fprintf(stderr, "[      ] Error: Test \"%s.%s\" depends on unknown \"%s.%s\"\n",
                     runtime->queue[i]->suite, runtime->queue[i]->name, dep->suite, dep->name);
                 exit(1);
             }
 
             /* Set test_ptr of kritic_test_index_t */
-            dep->test_ptr = runtime->queue[dep_index];
+            dep->test_ptr = dep_test;
 
+            dep_indices[i * KRITIC_MAX_DEPENDENCIES + d] = dep_index;
+            ++first[dep_index + 1];
             indegree[i]++;
         }
     }
 
+    /* Dependents are filled in queue order, so ties keep the registration order */
+    for (size_t i = 0; i < count; ++i) {
+        first[i + 1] += first[i];
+    }
+    /* The queue is not used yet, it holds the next free slot of every dependents list meanwhile */
+    size_t* fill = queue;
+    memcpy(fill, first, count * sizeof(size_t));
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t d = 0; runtime->queue[i]->dependencies[d] != NULL; ++d) {
+            dependents[fill[dep_indices[i * KRITIC_MAX_DEPENDENCIES + d]]++] = i;
+        }
+    }
+
     /* Queue tests with no dependencies */
     size_t front = 0, back = 0;
     for (size_t i = 0; i < count; ++i) {
@@ -112,15 +269,9 @@ static void kritic_sort_queue(kritic_runtime_t* runtime) {
         size_t idx = queue[front++];
         sorted[sorted_index++] = runtime->queue[idx];
 
-        for (size_t j = 0; j < count; ++j) {
-            for (size_t d = 0; runtime->queue[j]->dependencies[d] != NULL; ++d) {
-                if (strcmp(runtime->queue[j]->dependencies[d]->suite, runtime->queue[idx]->suite) == 0
-                    && strcmp(runtime->queue[j]->dependencies[d]->name, runtime->queue[idx]->name) == 0) {
-                    if (--indegree[j] == 0) {
-                        queue[back++] = j;
-                    }
-                    break;
-                }
+        for (size_t j = first[idx]; j < first[idx + 1]; ++j) {
+            if (--indegree[dependents[j]] == 0) {
+                queue[back++] = dependents[j];
             }
         }
     }
@@ -135,23 +286,31 @@ static void kritic_sort_queue(kritic_runtime_t* runtime) {
                         t->name, t->suite, t->file, t->line);
                 for (size_t d = 0; t->dependencies[d] != NULL; ++d) {
                     kritic_test_index_t* dep = t->dependencies[d];
-                    size_t dep_index = find_dep_index(map, count, dep, &invalid);
-                    if (dep_index == (size_t)-1) {
-                        fprintf(stderr, "[      ]   - (missing) %s.%s\n", dep->suite, dep->name);
-                    } else {
-                        fprintf(stderr, "[      ]   - %s.%s (possibly part of a cycle)\n", dep->suite, dep->name);
-                    }
+                    fprintf(stderr, "[      ]   - %s.%s (possibly part of a cycle)\n", dep->suite, dep->name);
                 }
             }
         }
 
         free(indegree);
         free(queue);
-        free(map);
+        free(positions);
+        free(first);
+        free(dependents);
+        free(dep_indices);
         free(sorted);
         exit(1);
     }
 
+    /* The dependents lists are done with, first now maps a test to its position in the sorted queue */
+    for (size_t k = 0; k < count; ++k) {
+        first[queue[k]] = k;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t d = 0; runtime->queue[i]->dependencies[d] != NULL; ++d) {
+            runtime->queue[i]->dependencies[d]->index = first[dep_indices[i * KRITIC_MAX_DEPENDENCIES + d]];
+        }
+    }
+
     /* Cleanup */
     sorted[count] = NULL;
     free(runtime->queue);
@@ -159,24 +318,92 @@ static void kritic_sort_queue(kritic_runtime_t* runtime) {
 
     free(indegree);
     free(queue);
-    free(map);
+    free(positions);
+    free(first);
+    free(dependents);
+    free(dep_indices);
 }
 
+/* With a history, likely failures and slow chains start first instead of following the registration order */
+static void kritic_order_queue(kritic_runtime_t* runtime) {
+    size_t count = runtime->test_count;
+
+    size_t* order          = malloc((count + 1) * sizeof(size_t));
+    size_t* first          = calloc(count + 2, sizeof(size_t));
+    size_t* dependents     = malloc((count * KRITIC_MAX_DEPENDENCIES + 1) * sizeof(size_t));
+    kritic_test_t** sorted = malloc((count + 1) * sizeof(kritic_test_t*));
+
+    if (!order || !first || !dependents || !sorted) {
+        fprintf(stderr, "[      ] Error: Memory allocation failed during queue sorting\n");
+        exit(1);
+    }
+
+    /* The queue is already in dependency order, dependency indices are positions in it */
+    for (size_t i = 0; i < count; ++i) {
+        order[i] = i;
+        for (size_t d = 0; runtime->queue[i]->dependencies[d] != NULL; ++d) {
+            ++first[runtime->queue[i]->dependencies[d]->index + 1];
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        first[i + 1] += first[i];
+    }
+    /* first[i] is the next free slot of the dependents of i while filling, shifted back to their starts afterwards */
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t d = 0; runtime->queue[i]->dependencies[d] != NULL; ++d) {
+            dependents[first[runtime->queue[i]->dependencies[d]->index]++] = i;
+        }
+    }
+    for (size_t i = count; i > 0; --i) {
+        first[i] = first[i - 1];
+    }
+    first[0] = 0;
+
+    kritic_order_by_critical_path(runtime, first, dependents, order);
+
+    /* first now maps a test to its new position */
+    for (size_t k = 0; k < count; ++k) {
+        sorted[k] = runtime->queue[order[k]];
+        first[order[k]] = k;
+    }
+    for (size_t k = 0; k < count; ++k) {
+        for (size_t d = 0; sorted[k]->dependencies[d] != NULL; ++d) {
+            sorted[k]->dependencies[d]->index = first[sorted[k]->dependencies[d]->index];
+        }
+    }
+    sorted[count] = NULL;
+    free(runtime->queue);
+    runtime->queue = sorted;
+
+    free(order);
+    free(first);
+    free(dependents);
+}
 
 size_t kritic_construct_queue(kritic_runtime_t* runtime) {
     size_t count = runtime->test_count;
+    bool filtered = kritic_filter_active(runtime);
+    if (filtered) kritic_filter_select(runtime);
+
     runtime->queue = malloc((count + 1) * sizeof(kritic_test_t*));
-    if (runtime->queue == NULL) {
+    /* Filtered out tests, the index points at them until it is cleared */
+    kritic_test_t** dropped = malloc((count + 1) * sizeof(kritic_test_t*));
+    if (runtime->queue == NULL || dropped == NULL) {
         fprintf(stderr, "[      ] Error: malloc() for queue returned NULL\n");
         exit(1);
     }
 
     kritic_node_t* current = runtime->first_node;
     kritic_node_t* next;
-    size_t i = 0;
+    size_t i = 0, dropped_count = 0;
     while (current != NULL) {
-        runtime->queue[i++] = (kritic_test_t*) current->data;
-        ((kritic_test_t*) current->data)->status = KRITIC_QUEUED;
+        kritic_test_t* test = (kritic_test_t*) current->data;
+        if (!filtered || test->status == KRITIC_QUEUED) {
+            runtime->queue[i++] = test;
+            test->status = KRITIC_QUEUED;
+        } else {
+            dropped[dropped_count++] = test;
+        }
         next = current->node;
         free(current);
         current = next;
@@ -185,9 +412,21 @@ size_t kritic_construct_queue(kritic_runtime_t* runtime) {
     runtime->first_node = NULL;
     runtime->last_node = NULL;
     runtime->queue[i] = NULL;
+    runtime->test_count = (uint32_t) i;
     kritic_sort_queue(runtime);
+    kritic_index_clear(&runtime->index);
+
+    for (size_t d = 0; d < dropped_count; ++d) {
+        kritic_free_attributes(dropped[d]);
+        free(dropped[d]);
+    }
+    free(dropped);
+
+    /* Shards partition the history independent order, so every shard agrees on it whatever its own history */
+    kritic_shard_select(runtime);
+    if (runtime->history != NULL) kritic_order_queue(runtime);
 
-    return count;
+    return runtime->test_count;
 }
 
 void kritic_free_queue(kritic_runtime_t *runtime) {
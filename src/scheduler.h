@@ -5,6 +5,9 @@
 
 #define KRITIC_MAX_DEPENDENCIES  4
 #define KRITIC_MAX_PARAMETERIZED 8
+#define KRITIC_MAX_LATENCY_BUDGETS 4
+#define KRITIC_MAX_VARIANTS      4
+#define KRITIC_MAX_RESOURCES     4
 
 #ifdef __cplusplus
 extern "C" {
@@ -26,11 +29,14 @@ typedef enum {
 struct kritic_runtime_t;
 struct kritic_attribute_t;
 struct kritic_test_t;
+struct kritic_fixture_t;
+struct kritic_resource_t;
 typedef void (*kritic_test_fn)(void);
 
 typedef struct kritic_test_index_t {
     const char* suite;
     const char* name;
+    /* Position of the dependency in the sorted queue */
     size_t index;
     struct kritic_test_t* test_ptr;
 } kritic_test_index_t;
@@ -44,6 +50,17 @@ typedef struct kritic_test_t {
     kritic_test_fn fn;
     kritic_test_index_t* dependencies[KRITIC_MAX_DEPENDENCIES];
     kritic_attr_parameterized_t* parameterized[KRITIC_MAX_PARAMETERIZED];
+    kritic_attr_benchmark_t* benchmark;
+    kritic_attr_latency_budget_t* latency_budgets[KRITIC_MAX_LATENCY_BUDGETS];
+    kritic_attr_cold_cache_t* cold_cache;
+    kritic_attr_variant_t* variants[KRITIC_MAX_VARIANTS];
+    /* Never answered from the result cache */
+    bool no_cache;
+    /* Setup and teardown of the test's suite, NULL if it has none */
+    struct kritic_fixture_t* fixture;
+    /* Names from KRITIC_USES(), resolved to the registered resources once the queue is built */
+    const char* uses[KRITIC_MAX_RESOURCES];
+    struct kritic_resource_t* resources[KRITIC_MAX_RESOURCES];
     kritic_test_status_t status;
 } kritic_test_t;
 
@@ -0,0 +1,296 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../kritic.h"
+
+/* Tests connected through dependencies, always run by the same shard */
+typedef struct {
+    uint64_t weight;
+    /* Queue position of the first test, the component's root */
+    size_t first;
+} kritic_shard_component_t;
+
+/* Recorded duration of "suite.name", the name points into the loaded timing file */
+typedef struct {
+    const char* name;
+    uint64_t duration_ns;
+} kritic_shard_timing_t;
+
+void kritic_shard_set(uint32_t index, uint32_t count) {
+    kritic_shard_config_t* config = &kritic_get_runtime_state()->shard_config;
+    config->index = index;
+    config->count = count;
+}
+
+void kritic_shard_set_timing_file(const char* path) {
+    kritic_get_runtime_state()->shard_config.timing_path = path;
+}
+
+/* Value of an unsigned environment variable, false if it is not set */
+static bool kritic_shard_env(const char* name, uint32_t* value) {
+    const char* env = getenv(name);
+    if (env == NULL || env[0] == '\0') return false;
+
+    char* end;
+    unsigned long parsed = strtoul(env, &end, 10);
+    if (env[0] == '-' || *end != '\0' || parsed > UINT32_MAX) {
+        fprintf(stderr, "[      ] Error: %s=\"%s\" is not a valid shard number\n", name, env);
+        exit(1);
+    }
+    *value = (uint32_t) parsed;
+    return true;
+}
+
+static bool kritic_shard_env_pair(const char* index_name, const char* count_name, uint32_t* index, uint32_t* count) {
+    if (!kritic_shard_env(count_name, count)) return false;
+
+    if (!kritic_shard_env(index_name, index)) {
+        fprintf(stderr, "[      ] Error: %s is set without %s\n", count_name, index_name);
+        exit(1);
+    }
+    return true;
+}
+
+/* The API and command line win over Bazel's variables, which win over GoogleTest's */
+static bool kritic_shard_resolve(const kritic_shard_config_t* config, uint32_t* index, uint32_t* count) {
+    *index = config->index;
+    *count = config->count;
+
+    if (*count == 0 && kritic_shard_env_pair("TEST_SHARD_INDEX", "TEST_TOTAL_SHARDS", index, count)) {
+        /* Bazel expects the runner to touch this file to acknowledge that it shards */
+        const char* status_path = getenv("TEST_SHARD_STATUS_FILE");
+        FILE* status = status_path != NULL && status_path[0] != '\0' ? fopen(status_path, "w") : NULL;
+        if (status != NULL) fclose(status);
+    }
+    if (*count == 0) kritic_shard_env_pair("GTEST_SHARD_INDEX", "GTEST_TOTAL_SHARDS", index, count);
+
+    if (*count == 0) return false;
+    if (*index >= *count) {
+        fprintf(stderr, "[      ] Error: Shard index %u is out of range for %u shards\n", *index, *count);
+        exit(1);
+    }
+    return true;
+}
+
+static int kritic_shard_compare_timings(const void* a, const void* b) {
+    return strcmp(((const kritic_shard_timing_t*) a)->name, ((const kritic_shard_timing_t*) b)->name);
+}
+
+/* strcmp() of a "suite.name" key against a test, without building the test's full name */
+static int kritic_shard_compare_name(const char* key, const kritic_test_t* test) {
+    const char* parts[3] = { test->suite, ".", test->name };
+
+    for (size_t p = 0; p < 3; ++p) {
+        for (const char* c = parts[p]; *c != '\0'; ++c, ++key) {
+            if (*key != *c) return (unsigned char) *key - (unsigned char) *c;
+        }
+    }
+    return *key != '\0';
+}
+
+static char* kritic_shard_read_file(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "[      ] Error: Could not open shard timing file \"%s\"\n", path);
+        exit(1);
+    }
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char* data = length >= 0 ? malloc((size_t) length + 1) : NULL;
+    if (data == NULL || fread(data, 1, (size_t) length, file) != (size_t) length) {
+        fprintf(stderr, "[      ] Error: Could not read shard timing file \"%s\"\n", path);
+        exit(1);
+    }
+    data[length] = '\0';
+    fclose(file);
+    return data;
+}
+
+/* Parse "suite.name seconds" lines in place, blank lines and lines starting with # are skipped */
+static size_t kritic_shard_parse_timings(const char* path, char* data, kritic_shard_timing_t** timings) {
+    size_t count = 0, capacity = 0, line = 0;
+
+    for (char* c = data; *c != '\0';) {
+        char* end_of_line = c + strcspn(c, "\n");
+        bool last = *end_of_line == '\0';
+        *end_of_line = '\0';
+        ++line;
+
+        char* name = c + strspn(c, " \t\r");
+        c = last ? end_of_line : end_of_line + 1;
+        if (name[0] == '\0' || name[0] == '#' || name[0] == '\r') continue;
+
+        char* name_end = name + strcspn(name, " \t");
+        char* seconds_end = NULL;
+        double seconds = *name_end != '\0' ? strtod(name_end + 1, &seconds_end) : -1.0;
+        if (seconds_end == NULL || seconds_end == name_end + 1 || !(seconds >= 0.0)
+            || seconds_end[strspn(seconds_end, " \t\r")] != '\0') {
+            fprintf(stderr, "[      ] Error: Expected \"suite.name seconds\" on line %zu of \"%s\"\n", line, path);
+            exit(1);
+        }
+        *name_end = '\0';
+
+        if (count == capacity) {
+            capacity = capacity == 0 ? 64 : capacity * 2;
+            kritic_shard_timing_t* grown = realloc(*timings, capacity * sizeof(kritic_shard_timing_t));
+            if (grown == NULL) {
+                fprintf(stderr, "[      ] Error: realloc() failed in kritic_shard_parse_timings()\n");
+                exit(1);
+            }
+            *timings = grown;
+        }
+        (*timings)[count++] = (kritic_shard_timing_t) { .name = name, .duration_ns = (uint64_t) (seconds * 1e9) };
+    }
+
+    qsort(*timings, count, sizeof(kritic_shard_timing_t), kritic_shard_compare_timings);
+    return count;
+}
+
+/* Tests without a recorded duration, weight 0 so far, weigh the mean of the known ones */
+static void kritic_shard_fill_unknown(uint64_t* weights, size_t count, uint64_t known_total, size_t known_count) {
+    uint64_t mean = known_count > 0 ? known_total / known_count : 1;
+    for (size_t i = 0; i < count; ++i) {
+        if (weights[i] == 0) weights[i] = mean > 0 ? mean : 1;
+    }
+}
+
+/* Weight of every queued test, its duration from the timing file or 1 without one */
+static void kritic_shard_weights(const kritic_runtime_t* runtime, uint64_t* weights) {
+    const char* path = runtime->shard_config.timing_path;
+    size_t count = runtime->test_count;
+    uint64_t known_total = 0;
+    size_t known_count = 0;
+
+    /* The local history differs between shards, only the shared timing file may weigh the partition */
+    for (size_t i = 0; i < count; ++i) weights[i] = 1;
+    if (path == NULL) return;
+
+    char* data = kritic_shard_read_file(path);
+    kritic_shard_timing_t* timings = NULL;
+    size_t timing_count = kritic_shard_parse_timings(path, data, &timings);
+
+    for (size_t i = 0; i < count; ++i) {
+        size_t low = 0, high = timing_count;
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            if (kritic_shard_compare_name(timings[middle].name, runtime->queue[i]) < 0) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+
+        if (low < timing_count && kritic_shard_compare_name(timings[low].name, runtime->queue[i]) == 0) {
+            weights[i] = timings[low].duration_ns > 0 ? timings[low].duration_ns : 1;
+            known_total += weights[i];
+            ++known_count;
+        } else {
+            weights[i] = 0;
+        }
+    }
+
+    kritic_shard_fill_unknown(weights, count, known_total, known_count);
+
+    free(timings);
+    free(data);
+}
+
+static size_t kritic_shard_find(size_t* parent, size_t i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+/* Heaviest first, ties keep the queue order */
+static int kritic_shard_compare_components(const void* a, const void* b) {
+    const kritic_shard_component_t* left = a;
+    const kritic_shard_component_t* right = b;
+
+    if (left->weight != right->weight) return left->weight > right->weight ? -1 : 1;
+    return (left->first > right->first) - (left->first < right->first);
+}
+
+/* Keep the tests of this shard, whole dependency components are handed out heaviest first to the lightest shard */
+void kritic_shard_select(kritic_runtime_t* runtime) {
+    uint32_t shard, shard_count;
+    if (!kritic_shard_resolve(&runtime->shard_config, &shard, &shard_count)) return;
+
+    size_t count = runtime->test_count;
+    size_t* parent                        = malloc((count + 1) * sizeof(size_t));
+    /* Component of every root, later the shard it went to */
+    size_t* slot                          = malloc((count + 1) * sizeof(size_t));
+    size_t* position                      = malloc((count + 1) * sizeof(size_t));
+    uint64_t* weights                     = malloc((count + 1) * sizeof(uint64_t));
+    kritic_shard_component_t* components  = malloc((count + 1) * sizeof(kritic_shard_component_t));
+    uint64_t* loads                       = calloc(shard_count, sizeof(uint64_t));
+
+    if (!parent || !slot || !position || !weights || !components || !loads) {
+        fprintf(stderr, "[      ] Error: Memory allocation failed during sharding\n");
+        exit(1);
+    }
+
+    /* Union the dependency graph, the root of a component is its first test in the queue */
+    for (size_t i = 0; i < count; ++i) {
+        parent[i] = i;
+        for (size_t d = 0; runtime->queue[i]->dependencies[d] != NULL; ++d) {
+            size_t root = kritic_shard_find(parent, runtime->queue[i]->dependencies[d]->index);
+            size_t own = kritic_shard_find(parent, i);
+            if (root < own) parent[own] = root;
+            else parent[root] = own;
+        }
+    }
+
+    kritic_shard_weights(runtime, weights);
+    size_t component_count = 0;
+    for (size_t i = 0; i < count; ++i) {
+        size_t root = kritic_shard_find(parent, i);
+        if (root == i) {
+            slot[i] = component_count;
+            components[component_count++] = (kritic_shard_component_t) { .weight = 0, .first = i };
+        }
+        components[slot[root]].weight += weights[i];
+    }
+
+    /* Longest processing time first, deterministic for the same queue and timings */
+    qsort(components, component_count, sizeof(kritic_shard_component_t), kritic_shard_compare_components);
+    for (size_t c = 0; c < component_count; ++c) {
+        uint32_t lightest = 0;
+        for (uint32_t s = 1; s < shard_count; ++s) {
+            if (loads[s] < loads[lightest]) lightest = s;
+        }
+        loads[lightest] += components[c].weight;
+        slot[components[c].first] = lightest;
+    }
+
+    /* Compact the queue, dependencies of kept tests are kept too and move to their new positions */
+    size_t kept = 0;
+    for (size_t i = 0; i < count; ++i) {
+        kritic_test_t* test = runtime->queue[i];
+        if (slot[kritic_shard_find(parent, i)] != shard) {
+            kritic_free_attributes(test);
+            free(test);
+            continue;
+        }
+
+        for (size_t d = 0; test->dependencies[d] != NULL; ++d) {
+            test->dependencies[d]->index = position[test->dependencies[d]->index];
+        }
+        position[i] = kept;
+        runtime->queue[kept++] = test;
+    }
+    runtime->queue[kept] = NULL;
+    runtime->test_count = (uint32_t) kept;
+
+    free(parent);
+    free(slot);
+    free(position);
+    free(weights);
+    free(components);
+    free(loads);
+}
@@ -0,0 +1,28 @@
+#ifndef KRITIC_SHARD_H
+#define KRITIC_SHARD_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct kritic_runtime_t;
+
+/* Run only one of count slices of the queue, count 0 falls back to the environment */
+typedef struct {
+    uint32_t index;
+    uint32_t count;
+    /* File of "suite.name seconds" lines to balance by, NULL uses the duration history or the test count */
+    const char* timing_path;
+} kritic_shard_config_t;
+
+void kritic_shard_set(uint32_t index, uint32_t count);
+void kritic_shard_set_timing_file(const char* path);
+void kritic_shard_select(struct kritic_runtime_t* runtime);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // KRITIC_SHARD_H
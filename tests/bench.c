@@ -0,0 +1,79 @@
+#include <stdint.h>
+
+#include "../kritic.h"
+
+static volatile uint64_t sink;
+
+KRITIC_TEST(bench, sum_loop, KRITIC_BENCHMARK(64)) {
+    uint64_t total = 0;
+    for (uint64_t i = 0; i < 256; ++i) {
+        total += i;
+    }
+    sink = total;
+}
+
+static uint32_t sizes[] = {16, 64, 256};
+KRITIC_TEST(bench, parameterized_loop, KRITIC_BENCHMARK(32), KRITIC_PARAMETERIZED(n, uint32_t, sizes, 3)) {
+    uint32_t n = KRITIC_GET_PARAMETER(uint32_t, n);
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        total += i;
+    }
+    sink = total;
+}
+
+KRITIC_TEST(bench, skipped, KRITIC_BENCHMARK(16)) {
+    KRITIC_SKIP("benchmark skipped before sampling");
+}
+
+KRITIC_TEST(bench, latency_budget_met, KRITIC_BENCHMARK(32), KRITIC_LATENCY_BUDGET(99.9, 1000000000)) {
+    uint64_t total = 0;
+    for (uint64_t i = 0; i < 64; ++i) {
+        total += i;
+    }
+    sink = total;
+}
+
+KRITIC_TEST(bench, latency_budget_exceeded, KRITIC_BENCHMARK(16), KRITIC_LATENCY_BUDGET(50.0, 0)) {
+    uint64_t total = 0;
+    for (uint64_t i = 0; i < 4096; ++i) {
+        total += i;
+        sink = total;
+    }
+}
+
+static uint64_t table[4096];
+KRITIC_TEST(bench, cold_cache_flush, KRITIC_BENCHMARK(16), KRITIC_COLD_CACHE(KRITIC_EVICT_AUTO)) {
+    KRITIC_WORKING_SET(table, sizeof(table));
+    uint64_t total = 0;
+    for (size_t i = 0; i < 4096; i += 8) {
+        total += table[i];
+    }
+    sink = total;
+}
+
+KRITIC_TEST(bench, cold_cache_sweep, KRITIC_BENCHMARK(4), KRITIC_COLD_CACHE(KRITIC_EVICT_SWEEP)) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < 4096; i += 8) {
+        total += table[i];
+    }
+    sink = total;
+}
+
+static void short_loop(void) {
+    for (uint64_t i = 0; i < 16; ++i) {
+        sink = i;
+    }
+}
+
+static void long_loop(void) {
+    for (uint64_t i = 0; i < 16384; ++i) {
+        sink = i;
+    }
+}
+
+KRITIC_TEST(bench, variants, KRITIC_BENCHMARK(32), KRITIC_VARIANT(shorter, short_loop), KRITIC_VARIANT(longer, long_loop)) {
+    for (uint64_t i = 0; i < 1024; ++i) {
+        sink = i;
+    }
+}
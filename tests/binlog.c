@@ -0,0 +1,98 @@
+/* mkdtemp(), popen() and readlink() are POSIX, not ISO C */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../kritic.h"
+#include "rerun.h"
+
+/* Targets of the logs below, they only fail, skip or print in a rerun */
+KRITIC_TEST(binlog_target, pass) {}
+
+KRITIC_TEST(binlog_target, fail) {
+    if (!selftest_rerunning()) return;
+    printf("logged line\n");
+    KRITIC_ASSERT_EQ(1, 2);
+}
+
+KRITIC_TEST(binlog_target, skip) {
+    if (!selftest_rerunning()) return;
+    KRITIC_SKIP("on purpose");
+}
+
+#ifdef __linux__
+/* make selftest builds kritic-render next to the self-test binary */
+static bool binlog_renderer(char* path, size_t size) {
+    ssize_t length = readlink("/proc/self/exe", path, size - 1);
+    if (length <= 0) return false;
+    path[length] = '\0';
+
+    char* slash = strrchr(path, '/');
+    if (slash == NULL || (size_t) (slash - path) + sizeof("/kritic-render") > size) return false;
+    strcpy(slash, "/kritic-render");
+    return access(path, X_OK) == 0;
+}
+
+static int binlog_render(const char* renderer, const char* args, char* output, size_t size) {
+    char command[512];
+    snprintf(command, sizeof(command), "env -i KRITIC_COLOR=never '%s' %s 2>&1", renderer, args);
+    return selftest_run(command, output, size);
+}
+
+/* The run only records, the renderer turns the log into any of the formats afterwards */
+KRITIC_TEST(binlog, render) {
+    char renderer[4096];
+    if (!binlog_renderer(renderer, sizeof(renderer))) KRITIC_SKIP("kritic-render is not built");
+
+    char directory[] = "/tmp/kritic-binlog-XXXXXX";
+    KRITIC_ASSERT(mkdtemp(directory) != NULL);
+
+    char env[128], args[128], output[8192];
+    snprintf(env, sizeof(env), "KRITIC_BINLOG_OUTPUT=%s/run.bin", directory);
+    KRITIC_ASSERT_EQ(selftest_rerun(env, "--filter 'binlog_target.*'", output, sizeof(output)), 1);
+    KRITIC_ASSERT(strstr(output, "[ EXEC ]") == NULL);
+    KRITIC_ASSERT(strstr(output, "Finished running 3 tests!") != NULL);
+
+    snprintf(args, sizeof(args), "%s/run.bin", directory);
+    KRITIC_ASSERT_EQ(binlog_render(renderer, args, output, sizeof(output)), 0);
+    KRITIC_ASSERT(selftest_before(output, "[ EXEC ] binlog_target.fail", "[ INFO ] logged line\n"));
+    KRITIC_ASSERT(selftest_before(output, "[ EXEC ] binlog_target.fail", "binlog_target.fail: 1 == 2 failed"));
+    KRITIC_ASSERT(selftest_before(output, "[ INFO ] logged line\n", "[ FAIL ] binlog_target.fail (0/1)"));
+    KRITIC_ASSERT(selftest_before(output, "[ EXEC ] binlog_target.skip", "Reason: on purpose"));
+    KRITIC_ASSERT(strstr(output, "Total  : 3") != NULL);
+    KRITIC_ASSERT(strchr(output, '\033') == NULL);
+
+    snprintf(args, sizeof(args), "--format json %s/run.bin", directory);
+    KRITIC_ASSERT_EQ(binlog_render(renderer, args, output, sizeof(output)), 0);
+    KRITIC_ASSERT(selftest_before(output, "\"name\":\"fail\"", "\"text\":\"logged line\\n\""));
+    KRITIC_ASSERT(selftest_before(output, "\"name\":\"fail\"", "\"status\":\"failed\""));
+    KRITIC_ASSERT(selftest_before(output, "\"name\":\"skip\"", "\"reason\":\"on purpose\""));
+    KRITIC_ASSERT(strstr(output, "\"summary\":{\"tests\":3,\"failed\":1,\"skipped\":1,") != NULL);
+
+    snprintf(args, sizeof(args), "--format junit %s/run.bin", directory);
+    KRITIC_ASSERT_EQ(binlog_render(renderer, args, output, sizeof(output)), 0);
+    KRITIC_ASSERT(strstr(output, "tests=\"3\" failures=\"1\" errors=\"0\" skipped=\"1\"") != NULL);
+    KRITIC_ASSERT(selftest_before(output, "name=\"fail\"", "<system-out>logged line\n</system-out>"));
+
+    snprintf(args, sizeof(args), "--format yaml %s/run.bin", directory);
+    KRITIC_ASSERT_EQ(binlog_render(renderer, args, output, sizeof(output)), 2);
+    KRITIC_ASSERT(strstr(output, "Usage: kritic-render") != NULL);
+
+    snprintf(args, sizeof(args), "%s/run.bin", directory);
+    remove(args);
+    remove(directory);
+}
+
+KRITIC_TEST(binlog, render_rejects_other_files) {
+    char renderer[4096];
+    if (!binlog_renderer(renderer, sizeof(renderer))) KRITIC_SKIP("kritic-render is not built");
+
+    char output[8192];
+    KRITIC_ASSERT_EQ(binlog_render(renderer, "/proc/self/exe", output, sizeof(output)), 1);
+    KRITIC_ASSERT(strstr(output, "Error: \"/proc/self/exe\" is not a KritiC result log") != NULL);
+    KRITIC_ASSERT_EQ(binlog_render(renderer, "", output, sizeof(output)), 2);
+    KRITIC_ASSERT(strstr(output, "Usage: kritic-render") != NULL);
+}
+#endif // __linux__
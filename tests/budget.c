@@ -0,0 +1,87 @@
+/* nanosleep(), popen() and readlink() are POSIX, not ISO C */
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <time.h>
+
+#include "../kritic.h"
+#include "rerun.h"
+
+/* Targets of the limits below, they only fail or take long in a rerun */
+KRITIC_TEST(budget_target, fail_a) {
+    if (selftest_rerunning()) KRITIC_FAIL();
+}
+
+KRITIC_TEST(budget_target, fail_b) {
+    if (selftest_rerunning()) KRITIC_FAIL();
+}
+
+KRITIC_TEST(budget_target, fail_c) {
+    if (selftest_rerunning()) KRITIC_FAIL();
+}
+
+KRITIC_TEST(budget_target, slow) {
+    if (selftest_rerunning()) nanosleep(&(struct timespec) { .tv_sec = 0, .tv_nsec = 150000000 }, NULL);
+}
+
+KRITIC_TEST(budget_target, after_a) {}
+KRITIC_TEST(budget_target, after_b) {}
+
+#ifdef __linux__
+KRITIC_TEST(budget, fail_fast) {
+    char output[8192];
+    KRITIC_ASSERT_EQ(selftest_rerun("", "--fail-fast --filter 'budget_target.fail_*'", output, sizeof(output)), 1);
+    KRITIC_ASSERT(selftest_before(output, "[ FAIL ] budget_target.fail_a (",
+        "[      ] Stopping after 1 failed tests, 2 tests not run\n"));
+    KRITIC_ASSERT(strstr(output, "[ EXEC ] budget_target.fail_b") == NULL);
+    KRITIC_ASSERT(strstr(output, "Not run: 2\n") != NULL);
+
+    KRITIC_ASSERT_EQ(selftest_rerun("", "--fail-fast=2 --filter 'budget_target.fail_*'", output, sizeof(output)), 1);
+    KRITIC_ASSERT(strstr(output, "Stopping after 2 failed tests, 1 tests not run\n") != NULL);
+    KRITIC_ASSERT(strstr(output, "Not run: 1\n") != NULL);
+
+    KRITIC_ASSERT_EQ(selftest_rerun("KRITIC_FAIL_FAST=2", "--filter 'budget_target.fail_*'", output, sizeof(output)),
+        1);
+    KRITIC_ASSERT(strstr(output, "Stopping after 2 failed tests, 1 tests not run\n") != NULL);
+}
+
+/* 0 lifts the limit, also over the environment */
+KRITIC_TEST(budget, fail_fast_unlimited) {
+    char output[8192];
+    KRITIC_ASSERT_EQ(selftest_rerun("KRITIC_FAIL_FAST=1", "--fail-fast=0 --filter 'budget_target.fail_*'", output,
+        sizeof(output)), 1);
+    KRITIC_ASSERT(strstr(output, "[ FAIL ] budget_target.fail_c (") != NULL);
+    KRITIC_ASSERT(strstr(output, "Stopping after") == NULL);
+    KRITIC_ASSERT(strstr(output, "Not run") == NULL);
+}
+
+/* The test that spends the budget still runs to its end */
+KRITIC_TEST(budget, time_budget) {
+    char output[8192];
+    KRITIC_ASSERT_EQ(selftest_rerun("", "--time-budget 0.1 --filter budget_target.slow "
+        "--filter 'budget_target.after_*'", output, sizeof(output)), 0);
+    KRITIC_ASSERT(selftest_before(output, "[ PASS ] budget_target.slow (",
+        "[      ] Time budget of 100ms spent, 2 tests not run\n"));
+    KRITIC_ASSERT(strstr(output, "[ EXEC ] budget_target.after_") == NULL);
+    KRITIC_ASSERT(strstr(output, "Not run: 2\n") != NULL);
+
+    KRITIC_ASSERT_EQ(selftest_rerun("KRITIC_TIME_BUDGET=0.1", "--filter budget_target.slow "
+        "--filter 'budget_target.after_*'", output, sizeof(output)), 0);
+    KRITIC_ASSERT(strstr(output, "Time budget of 100ms spent, 2 tests not run\n") != NULL);
+}
+
+KRITIC_TEST(budget, rejects_bad_limits) {
+    char output[8192];
+    KRITIC_ASSERT_EQ(selftest_rerun("KRITIC_FAIL_FAST=many", "--filter budget_target.after_a", output,
+        sizeof(output)), 1);
+    KRITIC_ASSERT(strstr(output, "Error: KRITIC_FAIL_FAST=\"many\" is not a positive number") != NULL);
+
+    KRITIC_ASSERT_EQ(selftest_rerun("KRITIC_TIME_BUDGET=-1", "--filter budget_target.after_a", output,
+        sizeof(output)), 1);
+    KRITIC_ASSERT(strstr(output, "Error: KRITIC_TIME_BUDGET=\"-1\" is not a positive number of seconds") != NULL);
+
+    KRITIC_ASSERT_EQ(selftest_rerun("", "--time-budget 0 --filter budget_target.after_a", output, sizeof(output)), 2);
+    KRITIC_ASSERT(strstr(output, "Error: Option \"--time-budget\" expects a positive number of seconds, got \"0\"")
+        != NULL);
+}
+#endif // __linux__
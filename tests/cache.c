@@ -0,0 +1,39 @@
+/* mkdtemp(), popen() and readlink() are POSIX, not ISO C */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../kritic.h"
+#include "rerun.h"
+
+KRITIC_TEST(cache, replayable) {
+    KRITIC_ASSERT_EQ(strlen("kritic"), 6);
+}
+
+#ifdef __linux__
+/* The second run replays the pass of the first one, the history takes the replay without a duration */
+KRITIC_TEST(cache, replays_pass) {
+    char directory[] = "/tmp/kritic-cache-XXXXXX";
+    KRITIC_ASSERT(mkdtemp(directory) != NULL);
+
+    char args[256], output[8192];
+    snprintf(args, sizeof(args), "--cache %s/cache --history %s/history --filter cache.replayable", directory,
+        directory);
+    KRITIC_ASSERT_EQ(selftest_rerun("", args, output, sizeof(output)), 0);
+    KRITIC_ASSERT(strstr(output, "cache.replayable (1/1)") != NULL);
+    KRITIC_ASSERT(strstr(output, " cached\n") == NULL);
+
+    KRITIC_ASSERT_EQ(selftest_rerun("", args, output, sizeof(output)), 0);
+    KRITIC_ASSERT(strstr(output, "cache.replayable (1/1) cached\n") != NULL);
+    KRITIC_ASSERT(strstr(output, "Cached : 1") != NULL);
+
+    char path[64];
+    snprintf(path, sizeof(path), "%s/cache", directory);
+    remove(path);
+    snprintf(path, sizeof(path), "%s/history", directory);
+    remove(path);
+    remove(directory);
+}
+#endif // __linux__
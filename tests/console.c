@@ -0,0 +1,84 @@
+/* popen() and readlink() are POSIX, not ISO C */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../kritic.h"
+#include "rerun.h"
+
+/* Targets of the consoles below, they only fail, skip or print in a rerun */
+KRITIC_TEST(console_target, pass) {
+    if (!selftest_rerunning()) return;
+    printf("hidden on pass\n");
+}
+
+KRITIC_TEST(console_target, fail) {
+    if (!selftest_rerunning()) return;
+    printf("shown on failure\n");
+    KRITIC_FAIL();
+}
+
+KRITIC_TEST(console_target, skip) {
+    if (!selftest_rerunning()) return;
+    KRITIC_SKIP("on purpose");
+}
+
+KRITIC_TEST(console_target, dependent, KRITIC_DEPENDS_ON(console_target, fail)) {}
+
+#ifdef __linux__
+/* Passing tests leave nothing behind, everything else is shown in full */
+static void console_check_short(const char* output) {
+    KRITIC_ASSERT(strstr(output, "[ EXEC ] console_target.pass") == NULL);
+    KRITIC_ASSERT(strstr(output, "[ PASS ]") == NULL);
+    KRITIC_ASSERT(strstr(output, "hidden on pass") == NULL);
+    KRITIC_ASSERT(selftest_before(output, "[ EXEC ] console_target.fail", "[ INFO ] shown on failure\n"));
+    KRITIC_ASSERT(selftest_before(output, "[ INFO ] shown on failure\n", "[ FAIL ] console_target.fail ("));
+    KRITIC_ASSERT(selftest_before(output, "[ EXEC ] console_target.skip", "Reason: on purpose"));
+    KRITIC_ASSERT(strstr(output, "underlying dependency \"console_target.fail\" failed") != NULL);
+    KRITIC_ASSERT(strstr(output, "Total  : 4") != NULL);
+}
+
+KRITIC_TEST(console, quiet) {
+    char output[8192];
+    KRITIC_ASSERT_EQ(selftest_rerun("", "--quiet --filter 'console_target.*'", output, sizeof(output)), 1);
+    console_check_short(output);
+
+    KRITIC_ASSERT_EQ(selftest_rerun("KRITIC_CONSOLE=quiet", "--filter 'console_target.*'", output, sizeof(output)), 1);
+    console_check_short(output);
+    KRITIC_ASSERT(strstr(output, "[ 4/4 ]") == NULL);
+}
+
+/* Without a terminal the status line is printed as a plain line instead of redrawn */
+KRITIC_TEST(console, progress) {
+    char output[8192];
+    KRITIC_ASSERT_EQ(selftest_rerun("KRITIC_CONSOLE=progress", "--filter 'console_target.*'", output,
+        sizeof(output)), 1);
+    console_check_short(output);
+    KRITIC_ASSERT(selftest_before(output, "[ 4/4 ] 1 failed, 2 skipped, ", "Finished running 4 tests!"));
+    KRITIC_ASSERT(strchr(output, '\r') == NULL);
+}
+
+/* Short consoles drop colors outside a terminal unless asked for them */
+KRITIC_TEST(console, colors) {
+    char output[8192];
+    KRITIC_ASSERT_EQ(selftest_rerun("KRITIC_COLOR=auto", "--quiet --filter 'console_target.*'", output,
+        sizeof(output)), 1);
+    KRITIC_ASSERT(strchr(output, '\033') == NULL);
+
+    KRITIC_ASSERT_EQ(selftest_rerun("KRITIC_COLOR=always", "--quiet --filter 'console_target.*'", output,
+        sizeof(output)), 1);
+    KRITIC_ASSERT(strchr(output, '\033') != NULL);
+}
+
+KRITIC_TEST(console, unknown_modes) {
+    char output[8192];
+    KRITIC_ASSERT_EQ(selftest_rerun("KRITIC_CONSOLE=loud", "--filter console_target.pass", output, sizeof(output)),
+        1);
+    KRITIC_ASSERT(strstr(output, "Error: Unknown console mode \"loud\"") != NULL);
+
+    KRITIC_ASSERT_EQ(selftest_rerun("KRITIC_COLOR=sometimes", "--filter console_target.pass", output,
+        sizeof(output)), 1);
+    KRITIC_ASSERT(strstr(output, "Error: Unknown color mode \"sometimes\"") != NULL);
+}
+#endif // __linux__
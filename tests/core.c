@@ -4,10 +4,33 @@
 
 KRITIC_TEST(core, registration) {}
 
-int main(void) {
+static uint32_t core_reported_tests = 0;
+
+static void core_count_post_test(kritic_runtime_t* state) {
+    (void) state;
+    ++core_reported_tests;
+}
+
+static void core_report_summary(kritic_runtime_t* state) {
+    kritic_result_stats_t stats;
+    kritic_result_stats(&stats);
+
+    kritic_printerf("[      ] Second reporter saw %u finished tests\n", core_reported_tests);
+    kritic_printerf("[      ] Result table: %u of %u tests, %u passed, %u failed, %u skipped, %u dependency failures\n",
+        stats.total, state->test_count, stats.passed, stats.failed, stats.skipped, stats.dep_failed);
+}
+
+/* Runs next to the default printers and skips every other event */
+static const kritic_printers_t core_reporter = {
+    .post_test_printer = &core_count_post_test,
+    .summary_printer   = &core_report_summary
+};
+
+int main(int argc, char** argv) {
     kritic_enable_ansi();
     kritic_set_default_printers();
+    kritic_add_reporter(&core_reporter);
     printf("Running from custom main()...\n");
 
-    return kritic_run_all();
+    return kritic_run_with_args(argc, argv);
 }
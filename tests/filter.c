@@ -0,0 +1,78 @@
+/* popen() and readlink() are POSIX, not ISO C */
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+
+#include "../kritic.h"
+#include "rerun.h"
+
+/* Targets of the filters below, they only have to exist */
+KRITIC_TEST(filter_dep, base) {}
+KRITIC_TEST(filter_target, alpha) {}
+KRITIC_TEST(filter_target, beta) {}
+KRITIC_TEST(filter_target, gamma, KRITIC_DEPENDS_ON(filter_dep, base)) {}
+KRITIC_TEST(filter_other, alpha) {}
+
+#ifdef __linux__
+static char filter_output[8192];
+
+/* Status of listing the tests the arguments select, the listing is left in filter_output */
+static int filter_list(const char* args) {
+    char command[256];
+    strcpy(command, "--list ");
+    strncat(command, args, sizeof(command) - strlen(command) - 1);
+    return selftest_rerun("", command, filter_output, sizeof(filter_output));
+}
+
+static bool filter_listed(const char* name) {
+    return selftest_listed(filter_output, name);
+}
+
+KRITIC_TEST(filter, glob) {
+    KRITIC_ASSERT_EQ(filter_list("--filter 'filter_target.?eta'"), 0);
+    KRITIC_ASSERT(filter_listed("filter_target.beta"));
+    KRITIC_ASSERT_NOT(filter_listed("filter_target.alpha"));
+    KRITIC_ASSERT_NOT(filter_listed("filter_target.gamma"));
+}
+
+KRITIC_TEST(filter, bare_suite) {
+    KRITIC_ASSERT_EQ(filter_list("--filter filter_target"), 0);
+    KRITIC_ASSERT(filter_listed("filter_target.alpha"));
+    KRITIC_ASSERT(filter_listed("filter_target.beta"));
+    KRITIC_ASSERT(filter_listed("filter_target.gamma"));
+    KRITIC_ASSERT_NOT(filter_listed("filter_other.alpha"));
+}
+
+KRITIC_TEST(filter, regex) {
+    KRITIC_ASSERT_EQ(filter_list("--regex '^filter_(target|other)\\.alpha$'"), 0);
+    KRITIC_ASSERT(filter_listed("filter_target.alpha"));
+    KRITIC_ASSERT(filter_listed("filter_other.alpha"));
+    KRITIC_ASSERT_NOT(filter_listed("filter_target.beta"));
+}
+
+KRITIC_TEST(filter, exclude) {
+    KRITIC_ASSERT_EQ(filter_list("--filter 'filter_*' --exclude '*.alpha' --exclude 'filter_target.gamma'"), 0);
+    KRITIC_ASSERT(filter_listed("filter_target.beta"));
+    KRITIC_ASSERT(filter_listed("filter_dep.base"));
+    KRITIC_ASSERT_NOT(filter_listed("filter_target.alpha"));
+    KRITIC_ASSERT_NOT(filter_listed("filter_other.alpha"));
+    KRITIC_ASSERT_NOT(filter_listed("filter_target.gamma"));
+}
+
+/* Dependencies of a selected test come along even when they are excluded */
+KRITIC_TEST(filter, dependency_included) {
+    KRITIC_ASSERT_EQ(filter_list("--filter filter_target.gamma --exclude 'filter_dep.*'"), 0);
+    KRITIC_ASSERT(filter_listed("filter_target.gamma"));
+    KRITIC_ASSERT(filter_listed("filter_dep.base"));
+    KRITIC_ASSERT_NOT(filter_listed("filter_target.alpha"));
+}
+
+KRITIC_TEST(filter, unmatched) {
+    KRITIC_ASSERT_EQ(filter_list("--filter filter_target.alpha --filter 'filter_target.nope*'"), 1);
+    KRITIC_ASSERT(strstr(filter_output, "Warning: Filter \"filter_target.nope*\" matches no test") != NULL);
+    KRITIC_ASSERT(filter_listed("filter_target.alpha"));
+
+    KRITIC_ASSERT_EQ(filter_list("--regex 'filter_nope'"), 1);
+    KRITIC_ASSERT(strstr(filter_output, "Warning: Regular expression \"filter_nope\" matches no test") != NULL);
+}
+#endif // __linux__
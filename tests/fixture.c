@@ -0,0 +1,176 @@
+/* popen() and readlink() are POSIX, not ISO C */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../kritic.h"
+#include "rerun.h"
+
+static int fixture_setups = 0;
+static int fixture_teardowns = 0;
+static int fixture_state = 0;
+
+KRITIC_SUITE_SETUP(fixture) {
+    ++fixture_setups;
+    fixture_state = 42;
+    return &fixture_state;
+}
+
+KRITIC_SUITE_TEARDOWN(fixture) {
+    ++fixture_teardowns;
+}
+
+KRITIC_TEST(fixture, setup_before_first) {
+    KRITIC_ASSERT_EQ(fixture_setups, 1);
+    KRITIC_ASSERT_EQ(fixture_teardowns, 0);
+    KRITIC_ASSERT_EQ(*KRITIC_SUITE_STATE(int), 42);
+}
+
+/* Another suite in between does not tear the fixture down */
+KRITIC_TEST(fixture_interleaved, between) {
+    KRITIC_ASSERT_EQ(fixture_setups, 1);
+    KRITIC_ASSERT_EQ(fixture_teardowns, 0);
+}
+
+KRITIC_TEST(fixture, setup_once) {
+    KRITIC_ASSERT_EQ(fixture_setups, 1);
+    KRITIC_ASSERT_EQ(fixture_teardowns, 0);
+    KRITIC_ASSERT_EQ(*KRITIC_SUITE_STATE(int), 42);
+}
+
+/* Queued right after the last test of the fixture suite */
+KRITIC_TEST(fixture_interleaved, after_last) {
+    KRITIC_ASSERT_EQ(fixture_setups, 1);
+    KRITIC_ASSERT_EQ(fixture_teardowns, 1);
+}
+
+/* Suite with hooks but no queued test, neither hook ever runs */
+static int fixture_unused_calls = 0;
+
+KRITIC_SUITE_SETUP(fixture_unused) {
+    ++fixture_unused_calls;
+    return NULL;
+}
+
+KRITIC_SUITE_TEARDOWN(fixture_unused) {
+    ++fixture_unused_calls;
+}
+
+KRITIC_TEST(fixture_interleaved, unused_never_set_up) {
+    KRITIC_ASSERT_EQ(fixture_unused_calls, 0);
+}
+
+static int resource_inits = 0;
+static int resource_finis = 0;
+
+static void* resource_init(void) {
+    static int value;
+    ++resource_inits;
+    value = 7;
+    return &value;
+}
+
+static void resource_fini(void* state) {
+    ++resource_finis;
+    *(int*) state = 0;
+}
+
+KRITIC_RESOURCE(counter, resource_init, resource_fini)
+
+KRITIC_TEST(resource, before_first_user) {
+    KRITIC_ASSERT_EQ(resource_inits, 0);
+}
+
+KRITIC_TEST(resource, first_user, KRITIC_USES(counter)) {
+    KRITIC_ASSERT_EQ(resource_inits, 1);
+    KRITIC_ASSERT_EQ(*KRITIC_RESOURCE_GET(int, counter), 7);
+}
+
+/* Users in other suites share the same resource, it stays alive in between */
+KRITIC_TEST(resource_other, between_users) {
+    KRITIC_ASSERT_EQ(resource_inits, 1);
+    KRITIC_ASSERT_EQ(resource_finis, 0);
+}
+
+KRITIC_TEST(resource_other, last_user, KRITIC_USES(counter)) {
+    KRITIC_ASSERT_EQ(resource_inits, 1);
+    KRITIC_ASSERT_EQ(resource_finis, 0);
+    KRITIC_ASSERT_EQ(*KRITIC_RESOURCE_GET(int, counter), 7);
+}
+
+KRITIC_TEST(resource, after_last_user) {
+    KRITIC_ASSERT_EQ(resource_inits, 1);
+    KRITIC_ASSERT_EQ(resource_finis, 1);
+}
+
+#ifdef __linux__
+static void* resource_optional_init(void) {
+    static int value = 3;
+    return &value;
+}
+
+/* Declared unless the environment drops it, so a whole run can reach the unknown resource error */
+__attribute__((constructor)) static void resource_register_optional(void) {
+    static const kritic_context_t ctx = { __FILE__, "", "optional", __LINE__ };
+    if (getenv("KRITIC_SELFTEST_DROP_RESOURCE") == NULL) kritic_register_resource(&ctx, resource_optional_init, NULL);
+}
+
+KRITIC_TEST(resource, optional_user, KRITIC_USES(optional)) {
+    KRITIC_ASSERT_EQ(*KRITIC_RESOURCE_GET(int, optional), 3);
+}
+
+/* Running this binary again without the resource stops before the first test with status 2 */
+KRITIC_TEST(resource, unknown_resource) {
+    char output[8192];
+    int status = selftest_rerun("KRITIC_SELFTEST_DROP_RESOURCE=1", "", output, sizeof(output));
+
+    KRITIC_ASSERT_EQ(status, 2);
+    KRITIC_ASSERT(strstr(output, "Unknown resource \"optional\" used by test \"resource.optional_user\"") != NULL);
+}
+#endif // __linux__
+
+#ifndef _WIN32
+static int snapshot_value = 0;
+
+KRITIC_SUITE_SETUP(snapshot) {
+    snapshot_value = 1;
+    return &snapshot_value;
+}
+
+KRITIC_SUITE_SNAPSHOT(snapshot)
+
+/* Changes a test makes stay in its own process */
+KRITIC_TEST(snapshot, mutates_state) {
+    int* value = KRITIC_SUITE_STATE(int);
+    *value += 10;
+    KRITIC_ASSERT_EQ(*value, 11);
+}
+
+KRITIC_TEST(snapshot, sees_setup_state) {
+    KRITIC_ASSERT_EQ(*KRITIC_SUITE_STATE(int), 1);
+    KRITIC_ASSERT_EQ(snapshot_value, 1);
+}
+
+KRITIC_TEST(snapshot, replays_skip) {
+    KRITIC_SKIP("skipped in the snapshot process");
+}
+
+KRITIC_TEST(snapshot, replays_fail) {
+    KRITIC_ASSERT_EQ_STR("snapshot", "runner");
+}
+
+/* Only the crashing test fails, the run goes on */
+KRITIC_TEST(snapshot, crash_fail) {
+    abort();
+}
+
+KRITIC_TEST(snapshot, after_crash) {
+    KRITIC_ASSERT_EQ(*KRITIC_SUITE_STATE(int), 1);
+}
+
+/* The runner's copy of the state was never touched */
+KRITIC_TEST(snapshot_runner, state_unchanged) {
+    KRITIC_ASSERT_EQ(snapshot_value, 1);
+}
+#endif // _WIN32
@@ -0,0 +1,173 @@
+/* mkdtemp(), popen() and readlink() are POSIX, not ISO C */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../kritic.h"
+#include "rerun.h"
+
+/* Code under test of the recording below, the volatile keeps the compiler from folding it away */
+static volatile int impact_state;
+
+static void impact_widget_draw(void) {
+    impact_state += 1;
+}
+
+static void impact_gadget_spin(void) {
+    impact_state += 2;
+}
+
+/* Targets of the recording and selections below */
+KRITIC_TEST(impact_target, widget) {
+    impact_widget_draw();
+}
+
+KRITIC_TEST(impact_target, gadget) {
+    impact_gadget_spin();
+}
+
+KRITIC_TEST(impact_target, other, KRITIC_DEPENDS_ON(impact_target, gadget)) {}
+KRITIC_TEST(impact_target, fresh) {}
+
+#ifdef __linux__
+static char impact_directory[] = "/tmp/kritic-impact-XXXXXX";
+static char impact_output[8192];
+
+static void impact_write(const char* name, const char* content) {
+    char path[64];
+    snprintf(path, sizeof(path), "%s/%s", impact_directory, name);
+    FILE* file = fopen(path, "w");
+    KRITIC_ASSERT(file != NULL);
+    if (file == NULL) return;
+    fputs(content, file);
+    fclose(file);
+}
+
+/* Status of listing the targets the changed files select, the listing is left in impact_output */
+static int impact_list(const char* changed) {
+    char args[256];
+    impact_write("changed", changed);
+    snprintf(args, sizeof(args), "--list --filter 'impact_target.*' --impact-index %s/index --changed %s/changed",
+        impact_directory, impact_directory);
+    return selftest_rerun("", args, impact_output, sizeof(impact_output));
+}
+
+static void impact_cleanup(void) {
+    const char* names[] = { "index", "changed", "recorded" };
+    char path[64];
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+        snprintf(path, sizeof(path), "%s/%s", impact_directory, names[i]);
+        remove(path);
+    }
+    remove(impact_directory);
+}
+
+/* The Makefile builds this file with -g -fsanitize-coverage=trace-pc in release mode on Linux, a build without it
+ * must refuse to write an index instead of writing an empty one */
+KRITIC_TEST(impact, record) {
+    strcpy(impact_directory, "/tmp/kritic-impact-XXXXXX");
+    KRITIC_ASSERT(mkdtemp(impact_directory) != NULL);
+
+    char args[256], path[64];
+    snprintf(args, sizeof(args), "--impact-record %s/recorded --filter 'impact_target.*'", impact_directory);
+    snprintf(path, sizeof(path), "%s/recorded", impact_directory);
+    int status = selftest_rerun("", args, impact_output, sizeof(impact_output));
+    FILE* file = fopen(path, "r");
+
+    if (strstr(impact_output, "Error: No coverage was recorded for the impact index") != NULL) {
+        KRITIC_ASSERT_EQ(status, 1);
+        KRITIC_ASSERT(file == NULL);
+        if (file != NULL) fclose(file);
+        impact_cleanup();
+        return;
+    }
+
+    KRITIC_ASSERT_EQ(status, 0);
+    KRITIC_ASSERT(file != NULL);
+    if (file != NULL) {
+        char index[8192];
+        index[fread(index, 1, sizeof(index) - 1, file)] = '\0';
+        fclose(file);
+        KRITIC_ASSERT(strncmp(index, "# KritiC impact index", strlen("# KritiC impact index")) == 0);
+        /* The compiler may give the file with leading directories, selection matches it by its end */
+        KRITIC_ASSERT(selftest_before(index, "\nimpact_target.widget\n\t", "tests/impact.c\timpact_widget_draw "));
+        KRITIC_ASSERT(selftest_before(index, "tests/impact.c\timpact_widget_draw ", "\nimpact_target.gadget\n\t"));
+        KRITIC_ASSERT(selftest_before(index, "\nimpact_target.gadget\n\t", "tests/impact.c\timpact_gadget_spin "));
+    }
+
+    /* The recorded index selects by function right away */
+    impact_write("changed", "tests/impact.c:impact_gadget_spin\n");
+    snprintf(args, sizeof(args), "--list --filter 'impact_target.*' --impact-index %s --changed %s/changed", path,
+        impact_directory);
+    KRITIC_ASSERT_EQ(selftest_rerun("", args, impact_output, sizeof(impact_output)), 0);
+    KRITIC_ASSERT(selftest_listed(impact_output, "impact_target.gadget"));
+    KRITIC_ASSERT_NOT(selftest_listed(impact_output, "impact_target.widget"));
+
+    impact_cleanup();
+}
+
+KRITIC_TEST(impact, select) {
+    strcpy(impact_directory, "/tmp/kritic-impact-XXXXXX");
+    KRITIC_ASSERT(mkdtemp(impact_directory) != NULL);
+    impact_write("index",
+        "# Written by hand, fresh is not in it\n"
+        "impact_target.widget\n\tsrc/widget.c\twidget_draw widget_size\n"
+        "impact_target.gadget\n\tsrc/gadget.c\tgadget_spin\n"
+        "impact_target.other\n\t./src/other.c\tother_run\n");
+
+    /* Tests the index does not know always run */
+    KRITIC_ASSERT_EQ(impact_list("src/widget.c\n"), 0);
+    KRITIC_ASSERT(selftest_listed(impact_output, "impact_target.widget"));
+    KRITIC_ASSERT(selftest_listed(impact_output, "impact_target.fresh"));
+    KRITIC_ASSERT_NOT(selftest_listed(impact_output, "impact_target.gadget"));
+
+    KRITIC_ASSERT_EQ(impact_list("src/widget.c:widget_size\n"), 0);
+    KRITIC_ASSERT(selftest_listed(impact_output, "impact_target.widget"));
+    KRITIC_ASSERT_EQ(impact_list("src/widget.c:widget_free\n"), 0);
+    KRITIC_ASSERT_NOT(selftest_listed(impact_output, "impact_target.widget"));
+
+    /* A selected test brings its dependencies along */
+    KRITIC_ASSERT_EQ(impact_list("src/other.c\n"), 0);
+    KRITIC_ASSERT(selftest_listed(impact_output, "impact_target.other"));
+    KRITIC_ASSERT(selftest_listed(impact_output, "impact_target.gadget"));
+    KRITIC_ASSERT_NOT(selftest_listed(impact_output, "impact_target.widget"));
+
+    KRITIC_ASSERT_EQ(impact_list("diff --git a/src/gadget.c b/src/gadget.c\n--- a/src/gadget.c\n+++ b/src/gadget.c\n"
+        "@@ -1 +1 @@\n-old\n+new\n"), 0);
+    KRITIC_ASSERT(selftest_listed(impact_output, "impact_target.gadget"));
+    KRITIC_ASSERT_NOT(selftest_listed(impact_output, "impact_target.other"));
+
+    /* A change to the file of the tests themselves selects all of them */
+    KRITIC_ASSERT_EQ(impact_list("tests/impact.c\n"), 0);
+    KRITIC_ASSERT(selftest_listed(impact_output, "impact_target.widget"));
+    KRITIC_ASSERT(selftest_listed(impact_output, "impact_target.gadget"));
+    KRITIC_ASSERT(selftest_listed(impact_output, "impact_target.other"));
+
+    char args[256];
+    snprintf(args, sizeof(args), "--list --filter 'impact_target.*' --impact-index %s/index --changed - < %s/changed",
+        impact_directory, impact_directory);
+    impact_write("changed", "src/widget.c\n");
+    KRITIC_ASSERT_EQ(selftest_rerun("", args, impact_output, sizeof(impact_output)), 0);
+    KRITIC_ASSERT(selftest_listed(impact_output, "impact_target.widget"));
+    KRITIC_ASSERT_NOT(selftest_listed(impact_output, "impact_target.gadget"));
+
+    impact_cleanup();
+}
+
+KRITIC_TEST(impact, rejects_bad_settings) {
+    KRITIC_ASSERT_EQ(selftest_rerun("", "--impact-record /tmp/recorded --impact-index /tmp/index --changed /tmp/changed",
+        impact_output, sizeof(impact_output)), 1);
+    KRITIC_ASSERT(strstr(impact_output, "Error: An impact index cannot be recorded and used in the same run") != NULL);
+
+    KRITIC_ASSERT_EQ(selftest_rerun("KRITIC_IMPACT_INDEX=/tmp/index", "--filter impact_target.fresh", impact_output,
+        sizeof(impact_output)), 1);
+    KRITIC_ASSERT(strstr(impact_output, "Error: Selecting tests by impact needs both an impact index and the changed "
+        "files") != NULL);
+
+    KRITIC_ASSERT_EQ(selftest_rerun("", "--impact-index /nonexistent/index --changed /nonexistent/changed",
+        impact_output, sizeof(impact_output)), 1);
+    KRITIC_ASSERT(strstr(impact_output, "Error: Could not open") != NULL);
+}
+#endif // __linux__
@@ -1,6 +1,10 @@
+/* popen() and readlink() are POSIX, not ISO C */
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 
 #include "../kritic.h"
+#include "rerun.h"
 
 KRITIC_TEST(io, stdout_redirect) {
     printf("Redirection of stdout works!\n");
@@ -67,3 +71,93 @@ KRITIC_TEST(io, stdout_char_by_char) {
         putchar(*p);
     }
 }
+
+KRITIC_TEST(io, stderr_redirect) {
+    fprintf(stderr, "Redirection of stderr works!\n");
+}
+
+KRITIC_TEST(io, stderr_newline) {
+    fprintf(stderr, "This stderr line should end with a newline");
+}
+
+/* Several times what a pipe holds on both streams, the reader drains them while the test is still writing */
+KRITIC_TEST(io_target, flood) {
+    if (!selftest_rerunning()) return;
+    for (int i = 0; i < 4096; ++i) {
+        printf("out %04d ................................................................\n", i);
+        fprintf(stderr, "err %04d ................................................................\n", i);
+    }
+}
+
+/* The pipes stay open across tests, an unfinished line must not run into the next test */
+KRITIC_TEST(io_target, partial_first) {
+    if (!selftest_rerunning()) return;
+    printf("first partial");
+}
+
+KRITIC_TEST(io_target, partial_second) {
+    if (!selftest_rerunning()) return;
+    fprintf(stderr, "second partial");
+}
+
+KRITIC_TEST(io_target, partial_third) {
+    if (!selftest_rerunning()) return;
+    printf("third\n");
+}
+
+/* Longer than a single read of the pipe, then more short lines than fit in one batch of writes */
+KRITIC_TEST(io_target, forward) {
+    if (!selftest_rerunning()) return;
+    for (int i = 0; i < 200000; ++i) putchar('x');
+    putchar('\n');
+    for (int i = 0; i < 10000; ++i) printf("short %05d\n", i);
+}
+
+#ifdef __linux__
+static size_t io_count(const char* output, const char* needle) {
+    size_t count = 0;
+    for (const char* found = strstr(output, needle); found != NULL; found = strstr(found + 1, needle)) ++count;
+    return count;
+}
+
+KRITIC_TEST(io, pipes_drained) {
+    static char output[1 << 20];
+    KRITIC_ASSERT_EQ(selftest_rerun("", "--filter io_target.flood", output, sizeof(output)), 0);
+    KRITIC_ASSERT_EQ(io_count(output, "[ INFO ] out "), 4096);
+    KRITIC_ASSERT_EQ(io_count(output, "[ INFO ] err "), 4096);
+    KRITIC_ASSERT(selftest_before(output, "[ INFO ] out 4095 ", "[ PASS ] io_target.flood"));
+    KRITIC_ASSERT(selftest_before(output, "[ INFO ] err 4095 ", "[ PASS ] io_target.flood"));
+}
+
+KRITIC_TEST(io, pipes_split_tests) {
+    char output[8192];
+    KRITIC_ASSERT_EQ(selftest_rerun("", "--filter 'io_target.partial_*'", output, sizeof(output)), 0);
+    KRITIC_ASSERT(selftest_before(output, "[ EXEC ] io_target.partial_first", "[ INFO ] first partial\n"));
+    KRITIC_ASSERT(selftest_before(output, "[ INFO ] first partial\n", "[ PASS ] io_target.partial_first"));
+    KRITIC_ASSERT(selftest_before(output, "[ EXEC ] io_target.partial_second", "[ INFO ] second partial\n"));
+    KRITIC_ASSERT(selftest_before(output, "[ INFO ] second partial\n", "[ PASS ] io_target.partial_second"));
+    KRITIC_ASSERT(selftest_before(output, "[ EXEC ] io_target.partial_third", "[ INFO ] third\n"));
+    KRITIC_ASSERT(selftest_before(output, "[ INFO ] third\n", "[ PASS ] io_target.partial_third"));
+}
+/* Every line gets exactly one label however it was split into reads, and none is torn apart */
+KRITIC_TEST(io, forward_lines) {
+    static char output[1 << 20];
+    KRITIC_ASSERT_EQ(selftest_rerun("", "--filter io_target.forward", output, sizeof(output)), 0);
+    KRITIC_ASSERT_EQ(io_count(output, "[ INFO ] "), 10000 + 1);
+
+    const char* line = strstr(output, "[ INFO ] x");
+    KRITIC_ASSERT(line != NULL);
+    if (line == NULL) return;
+    line += strlen("[ INFO ] ");
+    KRITIC_ASSERT_EQ(strspn(line, "x"), 200000);
+    KRITIC_ASSERT_EQ(line[200000], '\n');
+
+    size_t intact = 0;
+    for (line = strstr(output, "[ INFO ] short "); line != NULL; line = strstr(line + 1, "[ INFO ] short ")) {
+        line += strlen("[ INFO ] short ");
+        intact += strspn(line, "0123456789") == 5 && line[5] == '\n';
+    }
+    KRITIC_ASSERT_EQ(intact, 10000);
+    KRITIC_ASSERT(selftest_before(output, "[ INFO ] short 09999\n", "[ PASS ] io_target.forward"));
+}
+#endif // __linux__
@@ -0,0 +1,82 @@
+/* mkdtemp(), popen() and readlink() are POSIX, not ISO C */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../kritic.h"
+#include "rerun.h"
+
+/* Targets of the reports below, they only fail, skip or print in a rerun */
+KRITIC_TEST(junit_target, pass) {}
+
+KRITIC_TEST(junit_target, fail) {
+    if (!selftest_rerunning()) return;
+    printf("a < b & \"c\"\n");
+    fprintf(stderr, "\033[31mred\033[0m\n");
+    KRITIC_ASSERT(1 < 0);
+}
+
+KRITIC_TEST(junit_target, skip) {
+    if (!selftest_rerunning()) return;
+    KRITIC_SKIP("needs <gpu>");
+}
+
+KRITIC_TEST(junit_target, dependent, KRITIC_DEPENDS_ON(junit_target, fail)) {}
+
+#ifdef __linux__
+/* Run the targets with a report written to path */
+static int junit_run(const char* path, char* output, size_t size) {
+    char env[256];
+    snprintf(env, sizeof(env), "KRITIC_JUNIT_OUTPUT=%s", path);
+    return selftest_rerun(env, "--filter 'junit_target.*'", output, size);
+}
+
+static void junit_check(const char* report) {
+    KRITIC_ASSERT(strstr(report, "<testsuite name=\"KritiC\" tests=\"4\" failures=\"1\" errors=\"0\" skipped=\"2\"")
+        != NULL);
+    KRITIC_ASSERT(strstr(report, "<testcase classname=\"junit_target\" name=\"pass\" file=\"tests/junit.c\"") != NULL);
+    KRITIC_ASSERT(selftest_before(report, "name=\"fail\"", "<failure type=\"assertion\" "
+        "message=\"assertion failed: 1 &lt; 0\">assertion failed: 1 &lt; 0 at tests/junit.c:"));
+    KRITIC_ASSERT(selftest_before(report, "name=\"fail\"", "<system-out>a &lt; b &amp; \"c\"\n</system-out>"));
+    KRITIC_ASSERT(selftest_before(report, "name=\"fail\"", "<system-err>red\n</system-err>"));
+    KRITIC_ASSERT(selftest_before(report, "name=\"skip\"", "<skipped message=\"needs &lt;gpu&gt;\"/>"));
+    KRITIC_ASSERT(selftest_before(report, "name=\"dependent\"",
+        "<skipped message=\"dependency junit_target.fail failed\"/>"));
+    KRITIC_ASSERT(selftest_before(report, "<testsuite ", "</testsuite>\n"));
+}
+
+KRITIC_TEST(junit, report) {
+    char directory[] = "/tmp/kritic-junit-XXXXXX";
+    KRITIC_ASSERT(mkdtemp(directory) != NULL);
+
+    char path[64], output[8192];
+    snprintf(path, sizeof(path), "%s/report.xml", directory);
+    KRITIC_ASSERT_EQ(junit_run(path, output, sizeof(output)), 1);
+
+    static char report[16384];
+    FILE* file = fopen(path, "r");
+    KRITIC_ASSERT(file != NULL);
+    if (file == NULL) return;
+    report[fread(report, 1, sizeof(report) - 1, file)] = '\0';
+    fclose(file);
+    junit_check(report);
+
+    remove(path);
+    remove(directory);
+}
+
+/* A pipe cannot seek back to the totals, the report is put together in a temporary file first */
+KRITIC_TEST(junit, report_to_pipe) {
+    static char output[16384];
+    KRITIC_ASSERT_EQ(junit_run("/dev/stdout", output, sizeof(output)), 1);
+    junit_check(output);
+}
+
+KRITIC_TEST(junit, unwritable) {
+    char output[8192];
+    KRITIC_ASSERT_EQ(junit_run("/nonexistent/report.xml", output, sizeof(output)), 1);
+    KRITIC_ASSERT(strstr(output, "Error: Could not open JUnit report \"/nonexistent/report.xml\"") != NULL);
+}
+#endif // __linux__
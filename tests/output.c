@@ -0,0 +1,117 @@
+/* popen() and readlink() are POSIX, not ISO C */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../kritic.h"
+#include "rerun.h"
+
+KRITIC_TEST(output_target, prints) {
+    if (!selftest_rerunning()) return;
+    printf("to stdout\n");
+    fprintf(stderr, "to stderr\n");
+    printf("tail without newline");
+}
+
+KRITIC_TEST(output_target, exits) {
+    if (!selftest_rerunning()) return;
+    printf("before exit\n");
+    fflush(stdout);
+    printf("still in stdio");
+    exit(3);
+}
+
+KRITIC_TEST(output_target, quiet_pass) {
+    if (!selftest_rerunning()) return;
+    printf("hidden on pass\n");
+}
+
+KRITIC_TEST(output_target, loud_fail) {
+    if (!selftest_rerunning()) return;
+    printf("shown on failure\n");
+    fprintf(stderr, "shown on stderr\n");
+    KRITIC_FAIL();
+}
+
+KRITIC_TEST(output_target, loud_skip) {
+    if (!selftest_rerunning()) return;
+    printf("shown on skip\n");
+    KRITIC_SKIP("on purpose");
+}
+
+/* Twice what the capture buffer holds, the start of it has to come back from the spill file */
+KRITIC_TEST(output_target, spill_fail) {
+    if (!selftest_rerunning()) return;
+    for (int i = 0; i < 2048; ++i) {
+        printf("spill %04d ......................................................\n", i);
+    }
+    printf("spill tail");
+    KRITIC_FAIL();
+}
+
+#ifdef __linux__
+/* Printer lines and captured lines come out in the order they happened, batched or not; only lines of the same
+ * stream keep their order among each other, so stderr may even land before the newline closing the stdout tail */
+static void output_check_order(const char* output) {
+    KRITIC_ASSERT(selftest_before(output, "[ EXEC ] output_target.prints", "[ INFO ] to stdout\n"));
+    KRITIC_ASSERT(selftest_before(output, "[ INFO ] to stdout\n", "[ INFO ] tail without newline"));
+    KRITIC_ASSERT(selftest_before(output, "[ INFO ] tail without newline", "[ PASS ] output_target.prints (0/0)"));
+    KRITIC_ASSERT(selftest_before(output, "[ EXEC ] output_target.prints", "[ INFO ] to stderr\n"));
+    KRITIC_ASSERT(selftest_before(output, "[ INFO ] to stderr\n", "[ PASS ] output_target.prints (0/0)"));
+    KRITIC_ASSERT(selftest_before(output, "[ PASS ] output_target.prints", "Finished running 1 tests!"));
+}
+
+KRITIC_TEST(output, buffered_order) {
+    char output[8192];
+    KRITIC_ASSERT_EQ(selftest_rerun("", "--filter output_target.prints", output, sizeof(output)), 0);
+    output_check_order(output);
+}
+
+KRITIC_TEST(output, unbuffered_order) {
+    char output[8192];
+    KRITIC_ASSERT_EQ(selftest_rerun("KRITIC_OUTPUT_UNBUFFERED=1", "--filter output_target.prints", output,
+        sizeof(output)), 0);
+    output_check_order(output);
+}
+
+/* exit() in the middle of a test still writes out what the buffer held */
+KRITIC_TEST(output, flushed_on_exit) {
+    char output[8192];
+    KRITIC_ASSERT_EQ(selftest_rerun("", "--filter output_target.exits", output, sizeof(output)), 3);
+    KRITIC_ASSERT(selftest_before(output, "Running 1 tests:", "[ EXEC ] output_target.exits"));
+    KRITIC_ASSERT(selftest_before(output, "[ EXEC ] output_target.exits", "[ INFO ] before exit\n"));
+    KRITIC_ASSERT(selftest_before(output, "[ INFO ] before exit\n", "[ INFO ] still in stdio\n"));
+}
+
+/* A skip reports itself where it happens, its held back lines follow right after */
+KRITIC_TEST(output, failure_only) {
+    char output[8192];
+    KRITIC_ASSERT_EQ(selftest_rerun("KRITIC_OUTPUT_ON_FAILURE=1", "--filter 'output_target.loud_*' "
+        "--filter output_target.quiet_pass", output, sizeof(output)), 1);
+    KRITIC_ASSERT(strstr(output, "hidden on pass") == NULL);
+    KRITIC_ASSERT(selftest_before(output, "[ EXEC ] output_target.loud_fail", "[ INFO ] shown on failure\n"));
+    KRITIC_ASSERT(selftest_before(output, "[ INFO ] shown on failure\n", "[ FAIL ] output_target.loud_fail ("));
+    KRITIC_ASSERT(selftest_before(output, "[ INFO ] shown on stderr\n", "[ FAIL ] output_target.loud_fail ("));
+    KRITIC_ASSERT(selftest_before(output, "[ EXEC ] output_target.loud_skip", "[ INFO ] shown on skip\n"));
+    KRITIC_ASSERT(selftest_before(output, "[ INFO ] shown on skip\n", "Finished running 3 tests!"));
+}
+
+KRITIC_TEST(output, failure_only_spilled) {
+    static char output[1 << 20];
+    KRITIC_ASSERT_EQ(selftest_rerun("KRITIC_OUTPUT_ON_FAILURE=1", "--filter output_target.spill_fail", output,
+        sizeof(output)), 1);
+
+    size_t count = 0;
+    const char* found = output;
+    while ((found = strstr(found, "[ INFO ] spill ")) != NULL) {
+        ++count;
+        ++found;
+    }
+    KRITIC_ASSERT_EQ(count, 2048 + 1);
+    KRITIC_ASSERT(selftest_before(output, "[ INFO ] spill 0000 ", "[ INFO ] spill 2047 "));
+    KRITIC_ASSERT(selftest_before(output, "[ INFO ] spill 2047 ", "[ INFO ] spill tail\n"));
+    KRITIC_ASSERT(selftest_before(output, "[ INFO ] spill tail\n", "[ FAIL ] output_target.spill_fail ("));
+}
+#endif // __linux__
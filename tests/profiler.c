@@ -0,0 +1,67 @@
+/* mkdtemp(), popen() and readlink() are POSIX, not ISO C */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../kritic.h"
+#include "rerun.h"
+
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+static volatile uint64_t profiler_sink;
+
+/* Only spins when a profiled run of this binary picked it */
+KRITIC_TEST(profiler, busy) {
+    if (getenv("KRITIC_PROFILE_DIR") == NULL) return;
+
+    uint64_t total = 0;
+    for (uint64_t i = 0; i < 50000000; ++i) {
+        total += i ^ (total >> 3);
+        profiler_sink = total;
+    }
+}
+
+KRITIC_TEST(profiler, writes_folded) {
+    char directory[] = "/tmp/kritic-profile-XXXXXX";
+    KRITIC_ASSERT(mkdtemp(directory) != NULL);
+
+    char env[128], output[8192];
+    snprintf(env, sizeof(env), "KRITIC_PROFILE_DIR=%s KRITIC_PROFILE_HZ=1000", directory);
+    KRITIC_ASSERT_EQ(selftest_rerun(env, "--filter profiler.busy", output, sizeof(output)), 0);
+    KRITIC_ASSERT(strstr(output, "] profiler.busy: ") != NULL);
+
+    /* Every line is a stack rooted at the test followed by its sample count */
+    char path[192], line[8192];
+    snprintf(path, sizeof(path), "%s/profiler.busy.folded", directory);
+    FILE* folded = fopen(path, "r");
+    KRITIC_ASSERT(folded != NULL);
+    if (folded != NULL) {
+        KRITIC_ASSERT(fgets(line, sizeof(line), folded) != NULL);
+        KRITIC_ASSERT_EQ(strncmp(line, "profiler.busy", strlen("profiler.busy")), 0);
+        KRITIC_ASSERT(strrchr(line, ' ') != NULL && atoi(strrchr(line, ' ') + 1) > 0);
+        fclose(folded);
+        remove(path);
+    }
+    remove(directory);
+}
+
+KRITIC_TEST(profiler, rejects_bad_frequency) {
+    char output[8192];
+    int status = selftest_rerun("KRITIC_PROFILE_DIR=/tmp KRITIC_PROFILE_HZ=fast", "--filter profiler.busy", output,
+        sizeof(output));
+
+    KRITIC_ASSERT_EQ(status, 1);
+    KRITIC_ASSERT(strstr(output, "KRITIC_PROFILE_HZ=\"fast\" is not a frequency") != NULL);
+}
+
+KRITIC_TEST(profiler, rejects_missing_parent) {
+    char output[8192];
+    int status = selftest_rerun("KRITIC_PROFILE_DIR=/nonexistent/kritic", "--filter profiler.busy", output,
+        sizeof(output));
+
+    KRITIC_ASSERT_EQ(status, 1);
+    KRITIC_ASSERT(strstr(output, "Could not create the profile directory \"/nonexistent/kritic\"") != NULL);
+}
+#endif // Linux x86-64 and AArch64
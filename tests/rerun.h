@@ -0,0 +1,75 @@
+#ifndef KRITIC_TESTS_RERUN_H
+#define KRITIC_TESTS_RERUN_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Set in every rerun, targets that print, fail or take long only do so there to keep the main run readable */
+static inline bool selftest_rerunning(void) {
+    return getenv("KRITIC_SELFTEST_RERUN") != NULL;
+}
+
+/* Include after defining _POSIX_C_SOURCE, popen() and readlink() are not ISO C */
+#ifdef __linux__
+#include <stdio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* Run a shell command, -1 unless it exited */
+static inline int selftest_run(const char* command, char* output, size_t size) {
+    char discard[4096];
+    FILE* run = popen(command, "r");
+    if (run == NULL) return -1;
+
+    /* Whatever does not fit is drained so the run never blocks on a full pipe */
+    size_t used = 0, got;
+    do {
+        if (used + 1 < size) {
+            got = fread(output + used, 1, size - 1 - used, run);
+            used += got;
+        } else {
+            got = fread(discard, 1, sizeof(discard), run);
+        }
+    } while (got > 0);
+    output[used] = '\0';
+
+    int status = pclose(run);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+/* Run this self-test binary again in a clean environment without colors, -1 unless it exited */
+static inline int selftest_rerun(const char* env, const char* args, char* output, size_t size) {
+    char exe[4096], command[8192];
+    ssize_t length = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+    if (length <= 0) return -1;
+    exe[length] = '\0';
+
+    snprintf(command, sizeof(command),
+        "env -i ASAN_OPTIONS=detect_leaks=0 KRITIC_COLOR=never KRITIC_SELFTEST_RERUN=1 %s '%s' %s 2>&1",
+        env, exe, args);
+    return selftest_run(command, output, size);
+}
+
+/* Whether a "--list" output of a rerun shows the test "suite.name" */
+static inline bool selftest_listed(const char* output, const char* name) {
+    char line[128];
+    size_t length = strlen(name);
+    if (length + 3 > sizeof(line)) return false;
+
+    /* Each listed test starts a line and is followed by a tab */
+    line[0] = '\n';
+    memcpy(line + 1, name, length);
+    line[length + 1] = '\t';
+    line[length + 2] = '\0';
+    return strstr(output, line) != NULL;
+}
+
+/* Whether both texts are in the output, the first one before the second */
+static inline bool selftest_before(const char* output, const char* first, const char* second) {
+    const char* found = strstr(output, first);
+    return found != NULL && strstr(found + strlen(first), second) != NULL;
+}
+#endif // __linux__
+
+#endif // KRITIC_TESTS_RERUN_H
@@ -0,0 +1,111 @@
+/* mkdtemp(), popen() and readlink() are POSIX, not ISO C */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../kritic.h"
+#include "rerun.h"
+
+/* Targets of the partitions below, they only have to exist */
+KRITIC_TEST(shard_chain, head) {}
+KRITIC_TEST(shard_chain, middle, KRITIC_DEPENDS_ON(shard_chain, head)) {}
+KRITIC_TEST(shard_chain, tail, KRITIC_DEPENDS_ON(shard_chain, middle)) {}
+KRITIC_TEST(shard_single, a) {}
+KRITIC_TEST(shard_single, b) {}
+KRITIC_TEST(shard_single, c) {}
+KRITIC_TEST(shard_single, d) {}
+
+KRITIC_TEST(shard_weighted, a) {}
+KRITIC_TEST(shard_weighted, b) {}
+KRITIC_TEST(shard_weighted, c) {}
+KRITIC_TEST(shard_weighted, d) {}
+KRITIC_TEST(shard_weighted, e) {}
+
+#ifdef __linux__
+static const char* shard_targets[] = {
+    "shard_chain.head", "shard_chain.middle", "shard_chain.tail",
+    "shard_single.a", "shard_single.b", "shard_single.c", "shard_single.d"
+};
+
+/* Every test lands on exactly one shard, and a dependency chain never gets split */
+KRITIC_TEST(shard, component_together) {
+    static char outputs[3][8192];
+    for (int s = 0; s < 3; ++s) {
+        char args[128];
+        snprintf(args, sizeof(args), "--list --filter 'shard_chain.*' --filter 'shard_single.*' "
+            "--shard-index %d --shard-count 3", s);
+        KRITIC_ASSERT_EQ(selftest_rerun("", args, outputs[s], sizeof(outputs[s])), 0);
+    }
+
+    for (size_t t = 0; t < sizeof(shard_targets) / sizeof(shard_targets[0]); ++t) {
+        int shards = 0;
+        for (int s = 0; s < 3; ++s) shards += selftest_listed(outputs[s], shard_targets[t]);
+        KRITIC_ASSERT_EQ(shards, 1);
+    }
+    for (int s = 0; s < 3; ++s) {
+        bool head = selftest_listed(outputs[s], "shard_chain.head");
+        KRITIC_ASSERT_EQ(selftest_listed(outputs[s], "shard_chain.middle"), head);
+        KRITIC_ASSERT_EQ(selftest_listed(outputs[s], "shard_chain.tail"), head);
+    }
+}
+
+/* Heaviest first onto the lightest shard: 8 | 4 4 | 2 2 splits into 8+2 and 4+4+2 */
+KRITIC_TEST(shard, timings_balance) {
+    char directory[] = "/tmp/kritic-shard-XXXXXX";
+    KRITIC_ASSERT(mkdtemp(directory) != NULL);
+
+    char path[64];
+    snprintf(path, sizeof(path), "%s/timings", directory);
+    FILE* timings = fopen(path, "w");
+    KRITIC_ASSERT(timings != NULL);
+    if (timings == NULL) return;
+    fputs("shard_weighted.a 8\nshard_weighted.b 4\nshard_weighted.c 4\nshard_weighted.d 2\nshard_weighted.e 2\n",
+        timings);
+    fclose(timings);
+
+    static char outputs[2][8192];
+    for (int s = 0; s < 2; ++s) {
+        char args[192];
+        snprintf(args, sizeof(args), "--list --filter 'shard_weighted.*' --shard-timing %s "
+            "--shard-index %d --shard-count 2", path, s);
+        KRITIC_ASSERT_EQ(selftest_rerun("", args, outputs[s], sizeof(outputs[s])), 0);
+    }
+
+    KRITIC_ASSERT(selftest_listed(outputs[0], "shard_weighted.a"));
+    KRITIC_ASSERT(selftest_listed(outputs[1], "shard_weighted.b"));
+    KRITIC_ASSERT(selftest_listed(outputs[1], "shard_weighted.c"));
+    KRITIC_ASSERT_EQ(selftest_listed(outputs[0], "shard_weighted.d") + selftest_listed(outputs[0], "shard_weighted.e"),
+        1);
+    KRITIC_ASSERT_EQ(selftest_listed(outputs[1], "shard_weighted.d") + selftest_listed(outputs[1], "shard_weighted.e"),
+        1);
+
+    remove(path);
+    remove(directory);
+}
+
+/* Bazel only trusts a runner that touches TEST_SHARD_STATUS_FILE */
+KRITIC_TEST(shard, bazel_status_file) {
+    char directory[] = "/tmp/kritic-shard-XXXXXX";
+    KRITIC_ASSERT(mkdtemp(directory) != NULL);
+
+    char env[192], output[8192];
+    snprintf(env, sizeof(env), "TEST_SHARD_INDEX=1 TEST_TOTAL_SHARDS=2 TEST_SHARD_STATUS_FILE=%s/status", directory);
+    KRITIC_ASSERT_EQ(selftest_rerun(env, "--list --filter 'shard_single.*'", output, sizeof(output)), 0);
+
+    char path[64];
+    snprintf(path, sizeof(path), "%s/status", directory);
+    FILE* status = fopen(path, "r");
+    KRITIC_ASSERT(status != NULL);
+    if (status != NULL) fclose(status);
+
+    /* Without timings every test weighs the same, so the second shard gets every other one */
+    KRITIC_ASSERT(selftest_listed(output, "shard_single.b"));
+    KRITIC_ASSERT(selftest_listed(output, "shard_single.d"));
+    KRITIC_ASSERT_NOT(selftest_listed(output, "shard_single.a"));
+
+    remove(path);
+    remove(directory);
+}
+#endif // __linux__
@@ -0,0 +1,489 @@
+/*
+ * kritic-render: turn a binary result log (KRITIC_BINLOG_OUTPUT) into text, JSON or JUnit XML
+ *
+ * The log is replayed through the regular printer hooks, so the text format is produced by the
+ * very same default printers a live run uses and JUnit XML by the regular JUnit reporter.
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../kritic.h"
+
+typedef struct {
+    char* data;
+    size_t size;
+    /* Indexed by string id */
+    const char** strings;
+    uint32_t string_count;
+} kritic_render_log_t;
+
+static void kritic_render_usage(void) {
+    fprintf(stderr, "Usage: kritic-render [--format text|json|junit] [--output path] <log>\n");
+}
+
+static const char* kritic_render_string(const kritic_render_log_t* log, uint32_t id) {
+    if (id == 0 || id >= log->string_count) return NULL;
+    return log->strings[id];
+}
+
+static bool kritic_render_load(kritic_render_log_t* log, const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "[      ] Error: Could not open \"%s\"\n", path);
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    rewind(file);
+    if (size < (long) sizeof(kritic_binlog_header_t)) {
+        fprintf(stderr, "[      ] Error: \"%s\" is not a KritiC result log\n", path);
+        fclose(file);
+        return false;
+    }
+
+    log->size = (size_t) size;
+    log->data = malloc(log->size);
+    if (log->data == NULL || fread(log->data, 1, log->size, file) != log->size) {
+        fprintf(stderr, "[      ] Error: Could not read \"%s\"\n", path);
+        fclose(file);
+        return false;
+    }
+    fclose(file);
+
+    const kritic_binlog_header_t* header = (const kritic_binlog_header_t*) log->data;
+    if (memcmp(header->magic, KRITIC_BINLOG_MAGIC, sizeof(header->magic)) != 0) {
+        fprintf(stderr, "[      ] Error: \"%s\" is not a KritiC result log\n", path);
+        return false;
+    }
+    if (header->version != KRITIC_BINLOG_VERSION) {
+        fprintf(stderr, "[      ] Error: Unsupported result log version %u\n", header->version);
+        return false;
+    }
+    if (header->header_size + header->length > log->size) {
+        fprintf(stderr, "[      ] Error: Result log \"%s\" is truncated\n", path);
+        return false;
+    }
+    return true;
+}
+
+/* Call fn for every record, strings are collected along the way */
+static bool kritic_render_replay(kritic_render_log_t* log, void (*fn)(const kritic_render_log_t*,
+                                 const kritic_binlog_record_t*)) {
+    const kritic_binlog_header_t* header = (const kritic_binlog_header_t*) log->data;
+    size_t offset = header->header_size;
+    size_t end = header->header_size + header->length;
+
+    while (offset < end) {
+        const kritic_binlog_record_t* record = (const kritic_binlog_record_t*) (log->data + offset);
+        if (end - offset < sizeof(kritic_binlog_record_t) || record->size < sizeof(kritic_binlog_record_t)
+            || record->size > end - offset) {
+            fprintf(stderr, "[      ] Error: Corrupt record at offset %zu\n", offset);
+            return false;
+        }
+
+        if (record->type == KRITIC_BINLOG_STRING) {
+            const kritic_binlog_string_t* string = (const kritic_binlog_string_t*) record;
+            if (string->id >= log->string_count) {
+                uint32_t count = log->string_count == 0 ? 256 : log->string_count;
+                while (count <= string->id) count *= 2;
+
+                const char** strings = realloc(log->strings, count * sizeof(const char*));
+                if (strings == NULL) {
+                    fprintf(stderr, "[      ] Error: malloc() failed in kritic_render_replay()\n");
+                    exit(1);
+                }
+                memset(strings + log->string_count, 0, (count - log->string_count) * sizeof(const char*));
+                log->strings = strings;
+                log->string_count = count;
+            }
+            log->strings[string->id] = (const char*) (string + 1);
+        } else {
+            fn(log, record);
+        }
+        offset += record->size;
+    }
+    return true;
+}
+
+/* State of the replayed run, as the printers expect to find it */
+static kritic_test_t kritic_render_test;
+static kritic_test_state_t kritic_render_test_state;
+
+static void kritic_render_to_printers(const kritic_render_log_t* log, const kritic_binlog_record_t* record) {
+    kritic_runtime_t* runtime = kritic_get_runtime_state();
+    kritic_printers_t* printers = &runtime->printers;
+    kritic_test_state_t* test_state = &kritic_render_test_state;
+    kritic_test_t* test = &kritic_render_test;
+
+    switch ((kritic_binlog_type_t) record->type) {
+        case KRITIC_BINLOG_RUN_START: {
+            const kritic_binlog_run_start_t* run = (const kritic_binlog_run_start_t*) record;
+            runtime->test_count = run->test_count;
+            printers->init_printer(runtime);
+            break;
+        }
+
+        case KRITIC_BINLOG_TEST_START: {
+            const kritic_binlog_test_start_t* start = (const kritic_binlog_test_start_t*) record;
+            memset(test, 0, sizeof(kritic_test_t));
+            test->suite = kritic_render_string(log, start->suite);
+            test->name  = kritic_render_string(log, start->name);
+            test->file  = kritic_render_string(log, start->file);
+            test->line  = (int) start->line;
+            test->status = KRITIC_RUNNING;
+
+            *test_state = (kritic_test_state_t) { .test = test, .skip_reason = "" };
+            runtime->test_state = test_state;
+            printers->pre_test_printer(runtime);
+            break;
+        }
+
+        case KRITIC_BINLOG_ASSERT: {
+            const kritic_binlog_assert_t* assertion = (const kritic_binlog_assert_t*) record;
+            kritic_assert_type_t assert_type = (kritic_assert_type_t) assertion->assert_type;
+            long long actual = assertion->actual;
+            long long expected = assertion->expected;
+
+            if (assert_type == KRITIC_ASSERT_EQ_STR || assert_type == KRITIC_ASSERT_NE_STR) {
+                actual = (long long) (uintptr_t) kritic_render_string(log, (uint32_t) actual);
+                expected = (long long) (uintptr_t) kritic_render_string(log, (uint32_t) expected);
+            }
+
+            kritic_context_t ctx = {
+                kritic_render_string(log, assertion->file), test->suite, test->name, (int) assertion->line
+            };
+            printers->assert_printer(&ctx, false, actual, expected, kritic_render_string(log, assertion->actual_expr),
+                kritic_render_string(log, assertion->expected_expr), assert_type);
+            break;
+        }
+
+        case KRITIC_BINLOG_OUTPUT: {
+            const kritic_binlog_output_t* output = (const kritic_binlog_output_t*) record;
+            printers->stdout_printer(runtime, &(kritic_redirect_ctx_t) {
+                .stdout_copy      = -1,
+                .string           = (char*) (uintptr_t) (output + 1),
+                .length           = output->length,
+                .is_part_of_split = output->is_part_of_split,
+                .stream           = (kritic_stream_t) output->stream,
+                .timestamp_ns     = output->timestamp_ns
+            });
+            break;
+        }
+
+        case KRITIC_BINLOG_SKIP: {
+            const kritic_binlog_skip_t* skip = (const kritic_binlog_skip_t*) record;
+            kritic_context_t ctx = {
+                kritic_render_string(log, skip->file), test->suite, test->name, (int) skip->line
+            };
+            test_state->skipped = true;
+            test_state->skip_reason = kritic_render_string(log, skip->reason);
+            test_state->duration_ns = skip->duration_ns;
+            printers->skip_printer(runtime, &ctx);
+            break;
+        }
+
+        case KRITIC_BINLOG_TEST_END: {
+            const kritic_binlog_test_end_t* end = (const kritic_binlog_test_end_t*) record;
+            test->status = (kritic_test_status_t) end->status;
+            test_state->assert_count = end->assert_count;
+            test_state->asserts_failed = end->asserts_failed;
+            test_state->skipped = end->skipped;
+            test_state->duration_ns = end->duration_ns;
+            test_state->cached = end->cached;
+            printers->post_test_printer(runtime);
+            break;
+        }
+
+        case KRITIC_BINLOG_DEP_FAIL: {
+            const kritic_binlog_dep_fail_t* dep_fail = (const kritic_binlog_dep_fail_t*) record;
+            kritic_test_t dep_test = { 0 };
+            dep_test.suite = kritic_render_string(log, dep_fail->dep_suite);
+            dep_test.name  = kritic_render_string(log, dep_fail->dep_name);
+            dep_test.status = KRITIC_FAILED;
+
+            test->suite = kritic_render_string(log, dep_fail->suite);
+            test->name  = kritic_render_string(log, dep_fail->name);
+            test->file  = kritic_render_string(log, dep_fail->file);
+            test->line  = (int) dep_fail->line;
+            test->status = KRITIC_DEP_FAILED;
+            printers->dep_fail_printer(runtime, test, &dep_test);
+            break;
+        }
+
+        case KRITIC_BINLOG_RUN_END: {
+            const kritic_binlog_run_end_t* run = (const kritic_binlog_run_end_t*) record;
+            runtime->test_count = run->test_count;
+            runtime->fail_count = run->fail_count;
+            runtime->skip_count = run->skip_count;
+            runtime->not_run_count = run->not_run_count;
+            runtime->cached_count = run->cached_count;
+            runtime->duration_ns = run->duration_ns;
+            printers->summary_printer(runtime);
+            break;
+        }
+
+        case KRITIC_BINLOG_STRING:
+        default:
+            break;
+    }
+}
+
+/* JSON output, one object per test with its events in the order they happened */
+static FILE* kritic_render_json_file;
+static bool kritic_render_json_first_test = true;
+static bool kritic_render_json_first_event = true;
+
+static void kritic_render_json_string(const char* string) {
+    FILE* file = kritic_render_json_file;
+
+    if (string == NULL) {
+        fputs("null", file);
+        return;
+    }
+
+    fputc('"', file);
+    for (const unsigned char* c = (const unsigned char*) string; *c != '\0'; ++c) {
+        switch (*c) {
+            case '"':  fputs("\\\"", file); break;
+            case '\\': fputs("\\\\", file); break;
+            case '\n': fputs("\\n", file); break;
+            case '\r': fputs("\\r", file); break;
+            case '\t': fputs("\\t", file); break;
+            default:
+                if (*c < 0x20) fprintf(file, "\\u%04x", *c);
+                else fputc(*c, file);
+                break;
+        }
+    }
+    fputc('"', file);
+}
+
+static void kritic_render_json_event(const char* type) {
+    fprintf(kritic_render_json_file, "%s{\"type\":\"%s\"", kritic_render_json_first_event ? "" : ",", type);
+    kritic_render_json_first_event = false;
+}
+
+static void kritic_render_json_init_printer(kritic_runtime_t* state) {
+    fprintf(kritic_render_json_file, "{\"version\":\"%d.%d.%d\",\"test_count\":%u,\"tests\":[",
+        KRITIC_VERSION_MAJOR, KRITIC_VERSION_MINOR, KRITIC_VERSION_PATCH, state->test_count);
+}
+
+static void kritic_render_json_test_head(const kritic_test_t* test) {
+    FILE* file = kritic_render_json_file;
+
+    fputs(kritic_render_json_first_test ? "\n{\"suite\":" : ",\n{\"suite\":", file);
+    kritic_render_json_first_test = false;
+    kritic_render_json_string(test->suite);
+    fputs(",\"name\":", file);
+    kritic_render_json_string(test->name);
+    fputs(",\"file\":", file);
+    kritic_render_json_string(test->file);
+    fprintf(file, ",\"line\":%d,\"events\":[", test->line);
+    kritic_render_json_first_event = true;
+}
+
+static void kritic_render_json_pre_test_printer(kritic_runtime_t* state) {
+    kritic_render_json_test_head(state->test_state->test);
+}
+
+static void kritic_render_json_assert_printer(
+    const kritic_context_t* ctx,
+    bool passed,
+    long long actual,
+    long long expected,
+    const char* actual_expr,
+    const char* expected_expr,
+    kritic_assert_type_t assert_type
+) {
+    FILE* file = kritic_render_json_file;
+    (void) passed;
+
+    kritic_render_json_event("failure");
+    fprintf(file, ",\"assert_type\":%d,\"file\":", (int) assert_type);
+    kritic_render_json_string(ctx->file);
+    fprintf(file, ",\"line\":%d,\"actual_expr\":", ctx->line);
+    kritic_render_json_string(actual_expr);
+    fputs(",\"expected_expr\":", file);
+    kritic_render_json_string(expected_expr);
+
+    switch (assert_type) {
+        case KRITIC_ASSERT_EQ_STR:
+        case KRITIC_ASSERT_NE_STR:
+            fputs(",\"actual\":", file);
+            kritic_render_json_string((const char*) (uintptr_t) actual);
+            fputs(",\"expected\":", file);
+            kritic_render_json_string((const char*) (uintptr_t) expected);
+            break;
+        case KRITIC_ASSERT_EQ_FLOAT:
+        case KRITIC_ASSERT_NE_FLOAT: {
+            union { long long i; double f; } u_actual, u_expected;
+            u_actual.i = actual;
+            u_expected.i = expected;
+            fprintf(file, ",\"actual\":%.17g,\"expected\":%.17g", u_actual.f, u_expected.f);
+            break;
+        }
+        default:
+            fprintf(file, ",\"actual\":%lld,\"expected\":%lld", actual, expected);
+            break;
+    }
+    fputc('}', file);
+}
+
+static void kritic_render_json_stdout_printer(kritic_runtime_t* state, kritic_redirect_ctx_t* redir_ctx) {
+    FILE* file = kritic_render_json_file;
+    (void) state;
+
+    kritic_render_json_event("output");
+    fprintf(file, ",\"stream\":\"%s\",\"timestamp_ns\":%" PRIu64 ",\"continued\":%s,\"text\":",
+        redir_ctx->stream == KRITIC_STREAM_STDERR ? "stderr" : "stdout", redir_ctx->timestamp_ns,
+        redir_ctx->is_part_of_split ? "true" : "false");
+    kritic_render_json_string(redir_ctx->string);
+    fputc('}', file);
+}
+
+static void kritic_render_json_skip_printer(kritic_runtime_t* state, const kritic_context_t* ctx) {
+    FILE* file = kritic_render_json_file;
+
+    kritic_render_json_event("skip");
+    fputs(",\"reason\":", file);
+    kritic_render_json_string(state->test_state->skip_reason);
+    fputs(",\"file\":", file);
+    kritic_render_json_string(ctx->file);
+    fprintf(file, ",\"line\":%d}", ctx->line);
+}
+
+static const char* kritic_render_status(kritic_test_status_t status) {
+    switch (status) {
+        case KRITIC_PASSED:     return "passed";
+        case KRITIC_FAILED:     return "failed";
+        case KRITIC_SKIPPED:    return "skipped";
+        case KRITIC_DEP_FAILED: return "dependency_failed";
+        default:                return "unknown";
+    }
+}
+
+static void kritic_render_json_post_test_printer(kritic_runtime_t* state) {
+    const kritic_test_state_t* test_state = state->test_state;
+
+    fprintf(kritic_render_json_file,
+        "],\"status\":\"%s\",\"assert_count\":%d,\"asserts_failed\":%d,\"duration_ns\":%" PRIu64
+        ",\"cached\":%s}",
+        kritic_render_status(test_state->test->status), test_state->assert_count, test_state->asserts_failed,
+        test_state->duration_ns, test_state->cached ? "true" : "false");
+}
+
+/* The test was already opened by its start record */
+static void kritic_render_json_dep_fail_printer(kritic_runtime_t* state, kritic_test_t* test, kritic_test_t* dep_test) {
+    FILE* file = kritic_render_json_file;
+    (void) state;
+
+    fputs("],\"status\":\"dependency_failed\",\"dependency\":{\"suite\":", file);
+    kritic_render_json_string(dep_test->suite);
+    fputs(",\"name\":", file);
+    kritic_render_json_string(dep_test->name);
+    fputs("}}", file);
+    (void) test;
+}
+
+static void kritic_render_json_summary_printer(kritic_runtime_t* state) {
+    fprintf(kritic_render_json_file,
+        "\n],\"summary\":{\"tests\":%u,\"failed\":%u,\"skipped\":%u,\"not_run\":%u,\"cached\":%u,"
+        "\"duration_ns\":%" PRIu64 "}}\n",
+        state->test_count, state->fail_count, state->skip_count, state->not_run_count, state->cached_count,
+        state->duration_ns);
+}
+
+static void kritic_render_json_bench_printer(kritic_runtime_t* state) {
+    (void) state;
+}
+
+int main(int argc, char** argv) {
+    const char* format = "text";
+    const char* output = NULL;
+    const char* path = NULL;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            format = argv[++i];
+        } else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            kritic_render_usage();
+            return 2;
+        } else {
+            path = argv[i];
+        }
+    }
+    if (path == NULL || (strcmp(format, "text") != 0 && strcmp(format, "json") != 0 && strcmp(format, "junit") != 0)) {
+        kritic_render_usage();
+        return 2;
+    }
+
+    kritic_render_log_t log = { 0 };
+    if (!kritic_render_load(&log, path)) {
+        free(log.data);
+        return 1;
+    }
+
+    kritic_runtime_t* runtime = kritic_get_runtime_state();
+
+    if (strcmp(format, "text") == 0) {
+        if (output != NULL && freopen(output, "w", stdout) == NULL) {
+            fprintf(stderr, "[      ] Error: Could not open \"%s\"\n", output);
+            return 1;
+        }
+        kritic_set_default_printers();
+        /* Keeps failures on stderr in order with everything else, like in a live run */
+        kritic_output_init(runtime);
+        /* Same console mode and colors as a live run, a log rendered into a file stays plain */
+        kritic_console_init(runtime);
+    } else if (strcmp(format, "json") == 0) {
+        kritic_render_json_file = output != NULL ? fopen(output, "w") : stdout;
+        if (kritic_render_json_file == NULL) {
+            fprintf(stderr, "[      ] Error: Could not open \"%s\"\n", output);
+            return 1;
+        }
+        runtime->printers = (kritic_printers_t) {
+            .assert_printer    = &kritic_render_json_assert_printer,
+            .pre_test_printer  = &kritic_render_json_pre_test_printer,
+            .post_test_printer = &kritic_render_json_post_test_printer,
+            .summary_printer   = &kritic_render_json_summary_printer,
+            .init_printer      = &kritic_render_json_init_printer,
+            .stdout_printer    = &kritic_render_json_stdout_printer,
+            .skip_printer      = &kritic_render_json_skip_printer,
+            .dep_fail_printer  = &kritic_render_json_dep_fail_printer,
+            .bench_printer     = &kritic_render_json_bench_printer
+        };
+    } else if (strcmp(format, "junit") == 0) {
+        /* Only the JUnit reporter writes anything */
+        runtime->printers = (kritic_printers_t) {
+            .assert_printer    = KRITIC_NOOP(kritic_assert_printer_fn),
+            .pre_test_printer  = KRITIC_NOOP(kritic_pre_test_printer_fn),
+            .post_test_printer = KRITIC_NOOP(kritic_post_test_printer_fn),
+            .summary_printer   = KRITIC_NOOP(kritic_summary_printer_fn),
+            .init_printer      = KRITIC_NOOP(kritic_init_printer_fn),
+            .stdout_printer    = KRITIC_NOOP(kritic_stdout_printer_fn),
+            .skip_printer      = KRITIC_NOOP(kritic_skip_printer_fn),
+            .dep_fail_printer  = KRITIC_NOOP(kritic_dep_fail_printer_fn),
+            .bench_printer     = KRITIC_NOOP(kritic_bench_printer_fn)
+        };
+        kritic_junit_enable(output != NULL ? output : "/dev/stdout");
+        kritic_junit_init(runtime);
+    }
+
+    kritic_reporters_init(runtime);
+    bool ok = kritic_render_replay(&log, kritic_render_to_printers);
+
+    kritic_reporters_teardown(runtime);
+    kritic_junit_teardown(runtime);
+    kritic_console_teardown(runtime);
+    kritic_output_teardown(runtime);
+    if (kritic_render_json_file != NULL && kritic_render_json_file != stdout) fclose(kritic_render_json_file);
+    fflush(stdout);
+    free(log.strings);
+    free(log.data);
+    return ok ? 0 : 1;
+}
@@ -11,6 +11,9 @@ sanitize() {
   sed -E '
     s/less than [0-9]+(\.[0-9]+)?ms/0.0ms/g;
     s/[0-9]+(\.[0-9]+)?ms/0.0ms/g;
+    s/[0-9]+ns/0ns/g;
+    s/[0-9]+\.[0-9]+x/0.00x/g;
+    s/[0-9]+ outliers rejected, [0-9]+ warmup runs/0 outliers rejected, 0 warmup runs/g;
     /KritiC v[0-9]+\.[0-9]+\.[0-9]+/d;
     /^make\[[0-9]+\]/d;
     s|build/selftest\.exe|build/selftest|g;